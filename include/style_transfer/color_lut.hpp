@@ -0,0 +1,99 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+namespace video_styler::style_transfer
+{
+
+    /**
+     * @brief 3D color lookup table for 8-bit BGR frames
+     *
+     * The table samples a color mapping on a size^3 lattice over the RGB cube
+     * and is applied with trilinear interpolation by the runtime-selected SIMD
+     * kernels (see pixel_kernels.hpp), split across OpenCV's threads. Entries
+     * are kept in the .cube order (red varying fastest) so tables can be
+     * exchanged with grading tools.
+     */
+    class ColorLut
+    {
+    public:
+        /**
+         * @brief Lattice points per axis used by fitToStyle()
+         */
+        static constexpr int kDefaultSize = 33;
+
+        ColorLut() = default;
+
+        /**
+         * @brief Create a table that maps every color to itself
+         * @param size Lattice points per axis (at least 2)
+         * @return Identity table
+         */
+        static ColorLut identity(int size = kDefaultSize);
+
+        /**
+         * @brief Fit a table that gives frames the palette and tone of a style image
+         *
+         * Each CIELAB channel of the RGB cube is histogram-matched to the same
+         * channel of the style image, so the mapping is monotonic in lightness
+         * and independent of the frames it is applied to.
+         *
+         * @param style_image BGR style image
+         * @param size Lattice points per axis (at least 2)
+         * @return Fitted table, or an empty table if the image is empty
+         */
+        static ColorLut fitToStyle(const cv::Mat &style_image, int size = kDefaultSize);
+
+        /**
+         * @brief Check whether the table holds no lattice
+         * @return true if empty
+         */
+        bool empty() const;
+
+        /**
+         * @brief Get the lattice points per axis
+         * @return Size, or 0 if empty
+         */
+        int getSize() const;
+
+        /**
+         * @brief Get the color stored at a lattice point
+         * @param r Red lattice index
+         * @param g Green lattice index
+         * @param b Blue lattice index
+         * @return BGR color in [0, 255]
+         */
+        cv::Vec3f at(int r, int g, int b) const;
+
+        /**
+         * @brief Map every pixel of a frame through the table
+         * @param src CV_8UC3 BGR frame
+         * @param dst Receives the mapped frame (may be src)
+         * @return false if the table is empty or the frame is not CV_8UC3
+         */
+        bool apply(const cv::Mat &src, cv::Mat &dst) const;
+
+        /**
+         * @brief Write the table as an Adobe/Resolve .cube file
+         * @param path Output path
+         * @param title Optional TITLE line
+         * @return true if successful, false otherwise
+         */
+        bool exportCube(const std::string &path, const std::string &title = "") const;
+
+        /**
+         * @brief Read a 3D .cube file with the default [0, 1] domain
+         * @param path Input path
+         * @param lut Receives the table
+         * @return false if the file is missing or malformed
+         */
+        static bool loadCube(const std::string &path, ColorLut &lut);
+
+    private:
+        int size_{0};
+        std::vector<float> table_; // size^3 BGR entries, red varying fastest
+    };
+
+} // namespace video_styler::style_transfer
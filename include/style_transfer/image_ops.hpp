@@ -0,0 +1,132 @@
+#pragma once
+
+#include <string>
+#include <opencv2/opencv.hpp>
+
+namespace video_styler::style_transfer
+{
+
+    /**
+     * @brief Storage format of intermediate float tensors
+     *
+     * Arithmetic always runs in float32; FP16 and BF16 only change how
+     * tensors are stored between stages, halving their memory and bandwidth.
+     * FP16 keeps 11 significant bits over a narrow range (about 6e-5 to
+     * 65504), BF16 keeps 8 bits over the full float range.
+     */
+    enum class TensorPrecision
+    {
+        FP32, // CV_32F
+        FP16, // CV_16F (IEEE binary16)
+        BF16  // CV_16U holding the upper 16 bits of each float
+    };
+
+    /**
+     * @brief Get the command-line name of a precision
+     * @param precision Precision
+     * @return "fp32", "fp16" or "bf16"
+     */
+    std::string tensorPrecisionToString(TensorPrecision precision);
+
+    /**
+     * @brief Parse a precision name as printed by tensorPrecisionToString()
+     * @param name Precision name
+     * @param precision Receives the precision
+     * @return false if the name is unknown
+     */
+    bool parseTensorPrecision(const std::string &name, TensorPrecision &precision);
+
+    /**
+     * @brief Get the OpenCV depth tensors of a precision are stored with
+     * @param precision Precision
+     * @return CV_32F, CV_16F or CV_16U
+     */
+    int tensorDepth(TensorPrecision precision);
+
+    /**
+     * @brief Store a float tensor in a given precision
+     * @param src CV_32F tensor with any channel count
+     * @param dst Receives the tensor with depth tensorDepth(precision) (shares src for FP32)
+     * @param precision Storage precision
+     */
+    void packTensor(const cv::Mat &src, cv::Mat &dst, TensorPrecision precision);
+
+    /**
+     * @brief Expand a stored tensor back to float
+     * @param src Tensor written by packTensor() with the same precision
+     * @param dst Receives the CV_32F tensor (shares src for FP32)
+     * @param precision Storage precision
+     */
+    void unpackTensor(const cv::Mat &src, cv::Mat &dst, TensorPrecision precision);
+
+    /**
+     * @brief Convert an 8-bit image to float, scaling every value
+     *
+     * These wrappers run the runtime-selected SIMD kernels (see
+     * pixel_kernels.hpp) and fall back to OpenCV for other depths. Source
+     * and destination may be the same Mat.
+     *
+     * @param src CV_8U image with any channel count
+     * @param dst Receives a CV_32F image with the same channels
+     * @param scale Multiplier applied to each value
+     */
+    void convertToFloat(const cv::Mat &src, cv::Mat &dst, float scale);
+
+    /**
+     * @brief Convert a float image to 8-bit with rounding and saturation
+     * @param src CV_32F image with any channel count
+     * @param dst Receives a CV_8U image with the same channels
+     * @param scale Multiplier applied before rounding
+     */
+    void convertToByte(const cv::Mat &src, cv::Mat &dst, float scale);
+
+    /**
+     * @brief dst = a * weight_a + b * weight_b for float images of equal size
+     * @param a First image
+     * @param weight_a Weight of the first image
+     * @param b Second image
+     * @param weight_b Weight of the second image
+     * @param dst Receives the blend
+     */
+    void blendImages(const cv::Mat &a, float weight_a, const cv::Mat &b, float weight_b, cv::Mat &dst);
+
+    /**
+     * @brief dst = base + (plus - minus) for float images of equal size
+     * @param base Base image
+     * @param plus Image to add
+     * @param minus Image to subtract
+     * @param dst Receives the result
+     */
+    void addDifference(const cv::Mat &base, const cv::Mat &plus, const cv::Mat &minus, cv::Mat &dst);
+
+    /**
+     * @brief Bilinear resize of a float image (same sampling as cv::INTER_LINEAR)
+     * @param src CV_32F image with any channel count
+     * @param dst Receives the resized image
+     * @param size Output size
+     * @param output_precision Storage of dst; rows are interpolated in float and packed as they are written
+     */
+    void resizeBilinear(const cv::Mat &src, cv::Mat &dst, cv::Size size,
+                        TensorPrecision output_precision = TensorPrecision::FP32);
+
+    /**
+     * @brief Add a stored float residual to an 8-bit image: dst = saturate(round((src / 255 + residual) * 255))
+     *
+     * Works row by row so neither the float frame nor the unpacked residual
+     * is ever materialized at full size.
+     *
+     * @param src CV_8U image
+     * @param residual Residual with src's size and channels, stored in precision
+     * @param precision Storage precision of the residual
+     * @param dst Receives the CV_8U result
+     */
+    void applyResidual(const cv::Mat &src, const cv::Mat &residual, TensorPrecision precision, cv::Mat &dst);
+
+    /**
+     * @brief Compute F^T F for a row-major float feature matrix
+     * @param features CV_32F matrix, one sample per row, at most kMaxGramFeatures columns
+     * @return cols x cols CV_32F Gram matrix (not normalized)
+     */
+    cv::Mat gramMatrix(const cv::Mat &features);
+
+} // namespace video_styler::style_transfer
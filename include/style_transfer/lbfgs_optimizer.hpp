@@ -0,0 +1,83 @@
+#pragma once
+
+#include <functional>
+#include <Eigen/Core>
+
+namespace video_styler::style_transfer
+{
+
+    /**
+     * @brief Tuning knobs for the L-BFGS optimizer
+     */
+    struct LbfgsSettings
+    {
+        int max_iterations{500};         // Hard cap on iterations
+        int history_size{6};             // Number of curvature pairs kept
+        double gradient_tolerance{1e-6}; // Stop when ||g|| / max(1, ||x||) falls below this
+        double plateau_tolerance{1e-4};  // Relative loss improvement considered "no progress"
+        int plateau_patience{5};         // Consecutive no-progress iterations before stopping
+        int max_line_search_steps{20};   // Backtracking steps before giving up
+    };
+
+    /**
+     * @brief Why an optimization run stopped
+     */
+    enum class LbfgsStopReason
+    {
+        MAX_ITERATIONS,
+        GRADIENT_CONVERGED,
+        LOSS_PLATEAU,
+        LINE_SEARCH_FAILED
+    };
+
+    /**
+     * @brief Outcome of an optimization run
+     */
+    struct LbfgsResult
+    {
+        int iterations{0};
+        double initial_loss{0.0};
+        double final_loss{0.0};
+        LbfgsStopReason stop_reason{LbfgsStopReason::MAX_ITERATIONS};
+    };
+
+    /**
+     * @brief Limited-memory BFGS minimizer over dense float vectors
+     *
+     * Uses the standard two-loop recursion with a backtracking Armijo line
+     * search, and stops early once the loss plateaus so warm-started problems
+     * finish in a handful of iterations.
+     */
+    class LbfgsOptimizer
+    {
+    public:
+        /**
+         * @brief Evaluates the loss at x and writes its gradient
+         */
+        using Objective = std::function<double(const Eigen::VectorXf &x, Eigen::VectorXf &gradient)>;
+
+        /**
+         * @brief Create an optimizer
+         * @param settings Iteration limits and stopping criteria
+         */
+        explicit LbfgsOptimizer(LbfgsSettings settings = {});
+
+        /**
+         * @brief Minimize an objective starting from x
+         * @param objective Loss and gradient evaluator
+         * @param x Starting point; receives the best point found
+         * @return Iteration count, losses and stop reason
+         */
+        LbfgsResult minimize(const Objective &objective, Eigen::VectorXf &x) const;
+
+        /**
+         * @brief Get the optimizer settings
+         * @return Settings
+         */
+        const LbfgsSettings &getSettings() const;
+
+    private:
+        LbfgsSettings settings_;
+    };
+
+} // namespace video_styler::style_transfer
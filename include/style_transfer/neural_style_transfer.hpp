@@ -1,17 +1,51 @@
 #pragma once
 
+#include <future>
 #include <string>
 #include <opencv2/opencv.hpp>
 
+#include "style_transfer/color_lut.hpp"
+#include "style_transfer/image_ops.hpp"
+#include "utils/thread_pool.hpp"
+
 namespace video_styler::style_transfer
 {
 
+    /**
+     * @brief Style transfer algorithm used by applyStyleTransfer
+     */
+    enum class TransferMode
+    {
+        FAST,        // 3D color LUT fitted to the style's palette and tone
+        OPTIMIZATION // Iterative L-BFGS optimization against the style's Gram matrix
+    };
+
+    /**
+     * @brief A decoded style image and the features its transfer mode needs
+     *
+     * Built off the calling thread by NeuralStyleTransfer::prepareStyle() and
+     * installed with setPreparedStyle(); read-only once built, so one
+     * instance can be shared by many transfers.
+     */
+    struct PreparedStyle
+    {
+        cv::Mat image;       // BGR style image (empty if it could not be decoded)
+        ColorLut color_lut;  // Fitted for FAST mode
+        cv::Mat gram;        // Gram target for OPTIMIZATION mode
+        int gram_side{0};    // Working resolution the Gram target was computed at
+    };
+
     /**
      * @brief NeuralStyleTransfer class for applying style transfer to images/frames
      */
     class NeuralStyleTransfer
     {
     public:
+        /**
+         * @brief Default longest side of the image optimization runs at
+         */
+        static constexpr int kDefaultWorkingResolution = 256;
+
         NeuralStyleTransfer() = default;
         ~NeuralStyleTransfer() = default;
 
@@ -28,6 +62,55 @@ namespace video_styler::style_transfer
          */
         bool loadStyleImage(const std::string &filepath);
 
+        /**
+         * @brief Use an already decoded style image (shared, not copied)
+         * @param style_image BGR style image
+         * @return true if successful, false if the image is empty
+         */
+        bool setStyleImage(const cv::Mat &style_image);
+
+        /**
+         * @brief Decode and prepare a style image on a pool, without blocking the caller
+         *
+         * Decoding, conversion and the feature extraction of the current mode
+         * (LUT fit or Gram target at the current working resolution) run as a
+         * pool task, so the caller can open the video meanwhile. The style is
+         * installed by awaitStyle(), which the first applyStyleTransfer() call
+         * does implicitly; set the mode and working resolution first.
+         *
+         * @param filepath Path to the style image
+         * @param pool Pool to run on (must outlive the task)
+         * @return Future of the prepared style (its image is empty if decoding failed)
+         */
+        std::shared_future<PreparedStyle> loadStyleImageAsync(const std::string &filepath, utils::ThreadPool &pool);
+
+        /**
+         * @brief Wait for a pending loadStyleImageAsync() and install its result
+         * @return true if a style is loaded
+         */
+        bool awaitStyle();
+
+        /**
+         * @brief Decode nothing, just extract the features a mode needs from a style image
+         *
+         * Thread-safe; used by loadStyleImageAsync() and by batch runs that
+         * share one prepared style between many transfers.
+         *
+         * @param style_image BGR style image
+         * @param mode Mode whose features to extract
+         * @param working_max_side Working resolution of the Gram target (OPTIMIZATION)
+         * @return Prepared style (empty if the image is empty)
+         */
+        static PreparedStyle prepareStyle(const cv::Mat &style_image, TransferMode mode,
+                                          int working_max_side = kDefaultWorkingResolution);
+
+        /**
+         * @brief Install a prepared style (image and features are shared, not copied)
+         * @param style Prepared style
+         * @return true if successful, false if its image is empty
+         */
+        bool setPreparedStyle(const PreparedStyle &style);
+
         /**
          * @brief Apply style transfer to a frame
          * @param input_frame The input frame to stylize
@@ -36,6 +119,34 @@ namespace video_styler::style_transfer
          */
         bool applyStyleTransfer(const cv::Mat &input_frame, cv::Mat &output_frame);
 
+        /**
+         * @brief Apply style transfer only where a mask is set
+         *
+         * Only the tile-aligned bounding box of the active mask pixels is
+         * stylized, and the result is blended into a copy of the input with the
+         * mask as alpha, so the cost scales with the masked area.
+         *
+         * @param input_frame The input frame to stylize
+         * @param mask CV_8UC1 mask of the frame's size (0 keeps the input, 255 is fully stylized)
+         * @param output_frame The output frame
+         * @return true if successful, false otherwise
+         */
+        bool applyStyleTransfer(const cv::Mat &input_frame, const cv::Mat &mask, cv::Mat &output_frame);
+
+        /**
+         * @brief Get the region stylized by the last masked call
+         * @return Region in frame coordinates (empty if the mask had no active pixels)
+         */
+        cv::Rect getLastRegion() const;
+
+        /**
+         * @brief Get the tile-aligned bounding box of a mask's active pixels
+         * @param mask CV_8UC1 mask
+         * @param tile_size Tile edge the box is snapped outward to
+         * @return Region clipped to the mask (empty if nothing is active)
+         */
+        static cv::Rect activeRegion(const cv::Mat &mask, int tile_size = 32);
+
         /**
          * @brief Check if a style image is loaded
          * @return true if style image is loaded
@@ -50,6 +161,86 @@ namespace video_styler::style_transfer
          */
         void setParameters(int iterations = 500, double style_weight = 1e6, double content_weight = 1.0);
 
+        /**
+         * @brief Change only the iteration count, keeping the loss weights
+         * @param iterations Number of optimization iterations
+         */
+        void setIterations(int iterations);
+
+        /**
+         * @brief Select the style transfer algorithm
+         * @param mode Transfer mode
+         */
+        void setMode(TransferMode mode);
+
+        /**
+         * @brief Get the selected style transfer algorithm
+         * @return Transfer mode
+         */
+        TransferMode getMode() const;
+
+        /**
+         * @brief Limit the resolution optimization runs at
+         * @param max_side Longest side of the working image in pixels
+         */
+        void setWorkingResolution(int max_side);
+
+        /**
+         * @brief Get the color LUT FAST mode applies, fitting it to the style on first use
+         * @return Fitted LUT (empty if no style is loaded)
+         */
+        const ColorLut &getColorLut();
+
+        /**
+         * @brief Write the style's color LUT as a .cube file for grading tools
+         * @param path Output path
+         * @return false if no style is loaded or the file cannot be written
+         */
+        bool exportColorLut(const std::string &path);
+
+        /**
+         * @brief Select how intermediate tensors are stored in optimize mode
+         *
+         * FP16/BF16 store the full-resolution residual and the warm-start state
+         * at half the size; the optimizer, Gram matrices and all arithmetic stay
+         * float32, and the full-resolution float frame is never kept.
+         *
+         * @param precision Storage precision (resets the temporal state)
+         */
+        void setTensorPrecision(TensorPrecision precision);
+
+        /**
+         * @brief Get the storage precision of intermediate tensors
+         * @return Precision
+         */
+        TensorPrecision getTensorPrecision() const;
+
+        /**
+         * @brief Forget the previous frame so the next one is optimized from scratch
+         *        (call on scene cuts or when switching clips)
+         */
+        void resetTemporalState();
+
+        /**
+         * @brief Write the warm-start state as a map node, so a resumed run continues exactly
+         * @param fs Storage opened for writing
+         * @param name Key of the node
+         */
+        void saveTemporalState(cv::FileStorage &fs, const std::string &name) const;
+
+        /**
+         * @brief Restore warm-start state written by saveTemporalState()
+         * @param node The map node
+         * @return false if the node is missing or malformed (the state is then reset)
+         */
+        bool loadTemporalState(const cv::FileNode &node);
+
+        /**
+         * @brief Get the iterations the optimizer used for the last frame
+         * @return Iteration count (0 in FAST mode)
+         */
+        int getLastIterationCount() const;
+
     private:
         cv::Mat style_image_;
         bool style_loaded_{false};
@@ -59,6 +250,51 @@ namespace video_styler::style_transfer
         double style_weight_{1e6};
         double content_weight_{1.0};
 
+        TransferMode mode_{TransferMode::FAST};
+        TensorPrecision tensor_precision_{TensorPrecision::FP32};
+        int working_max_side_{kDefaultWorkingResolution};
+        int last_iterations_{0};
+
+        // Color LUT of the style, fitted on first use
+        ColorLut color_lut_;
+
+        // Style being prepared by loadStyleImageAsync(), installed by awaitStyle()
+        std::shared_future<PreparedStyle> pending_style_;
+
+        // Style Gram target, cached per working resolution
+        cv::Mat style_gram_;
+        int style_gram_side_{0};
+
+        // Previous frame at working resolution, used to warm-start the optimizer
+        // (stored in tensor_precision_)
+        cv::Mat previous_content_;
+        cv::Mat previous_result_;
+
+        // Region of the last masked call; the warm start is only valid while it stays put
+        cv::Rect last_region_;
+
+        /**
+         * @brief Map a frame through the style's color LUT
+         * @param input_frame The input frame
+         * @param output_frame The output frame
+         * @return true if successful, false otherwise
+         */
+        bool applyColorLut(const cv::Mat &input_frame, cv::Mat &output_frame);
+
+        /**
+         * @brief Optimization-based style transfer with warm start
+         * @param input_frame The input frame
+         * @param output_frame The output frame
+         * @return true if successful, false otherwise
+         */
+        bool applyOptimization(const cv::Mat &input_frame, cv::Mat &output_frame);
+
+        /**
+         * @brief Get the style Gram target for the current working resolution
+         * @return Cached Gram matrix
+         */
+        const cv::Mat &styleGram();
+
         /**
          * @brief Initialize the neural network for style transfer
          */
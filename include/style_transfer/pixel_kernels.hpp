@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "utils/cpu_features.hpp"
+
+namespace video_styler::style_transfer
+{
+
+    /**
+     * @brief Largest feature count gram() accepts
+     */
+    constexpr std::size_t kMaxGramFeatures = 16;
+
+    /**
+     * @brief Table of hot pixel kernels compiled for one instruction set
+     *
+     * The same kernel source is compiled once per ISA (generic, SSE4.2, AVX2,
+     * AVX-512) and the best table the CPU supports is selected at runtime, so
+     * a binary built for the baseline ISA still runs vectorized everywhere.
+     * Prefer the cv::Mat wrappers in image_ops.hpp over calling these directly.
+     */
+    struct PixelKernels
+    {
+        utils::CpuIsa isa;
+
+        // dst[i] = src[i] * scale
+        void (*bytes_to_floats)(const std::uint8_t *src, float *dst, std::size_t count, float scale);
+
+        // dst[i] = saturate(round(src[i] * scale)); NaN maps to 0
+        void (*floats_to_bytes)(const float *src, std::uint8_t *dst, std::size_t count, float scale);
+
+        // dst[i] = a[i] * weight_a + b[i] * weight_b
+        void (*blend)(const float *a, const float *b, float *dst, std::size_t count, float weight_a, float weight_b);
+
+        // dst[i] = base[i] + plus[i] - minus[i]
+        void (*add_difference)(const float *base, const float *plus, const float *minus, float *dst, std::size_t count);
+
+        // Horizontal bilinear pass: output pixel x mixes the pixels starting at
+        // offsets[2x] and offsets[2x + 1] (in floats) with weights[2x] and weights[2x + 1]
+        void (*interpolate_columns)(const float *row, const int *offsets, const float *weights, float *dst,
+                                    std::size_t width, int channels);
+
+        // gram[i * cols + j] = sum over rows of features[r * cols + i] * features[r * cols + j]
+        // for a row-major rows x cols matrix with cols <= kMaxGramFeatures
+        void (*gram)(const float *features, std::size_t rows, std::size_t cols, float *gram);
+
+        // IEEE binary16 storage: round to nearest even, overflow to infinity, NaN stays NaN
+        void (*floats_to_half)(const float *src, std::uint16_t *dst, std::size_t count);
+        void (*half_to_floats)(const std::uint16_t *src, float *dst, std::size_t count);
+
+        // bfloat16 storage (upper half of a float): round to nearest even, NaN stays NaN
+        void (*floats_to_bfloat16)(const float *src, std::uint16_t *dst, std::size_t count);
+        void (*bfloat16_to_floats)(const std::uint16_t *src, float *dst, std::size_t count);
+
+        // Trilinear 3D LUT lookup for BGR pixels. table holds size^3 BGR entries in [0, 255]
+        // with red varying fastest, then green, then blue (size >= 2)
+        void (*apply_lut)(const std::uint8_t *src, std::uint8_t *dst, std::size_t pixels, const float *table, int size);
+    };
+
+    /**
+     * @brief Get the kernels in use, selecting the best supported ones on first use
+     * @return Active kernel table
+     */
+    const PixelKernels &activeKernels();
+
+    /**
+     * @brief Select the best kernels the CPU supports, capped at a given ISA
+     * @param max_isa Highest ISA to consider (e.g. to reproduce results of older machines)
+     * @return The newly active kernel table
+     */
+    const PixelKernels &selectKernels(utils::CpuIsa max_isa);
+
+    /**
+     * @brief Get the kernels for one ISA
+     * @param isa ISA level
+     * @return Kernel table, or nullptr if not compiled in or not supported by this CPU
+     */
+    const PixelKernels *kernelsForIsa(utils::CpuIsa isa);
+
+} // namespace video_styler::style_transfer
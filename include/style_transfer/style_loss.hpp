@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Eigen/Core>
+#include <opencv2/opencv.hpp>
+
+namespace video_styler::style_transfer
+{
+
+    /**
+     * @brief Content + Gram-matrix style loss over a float BGR image
+     *
+     * Style is described by the Gram matrix of a small fixed feature bank:
+     * the three color channels and their horizontal and vertical Sobel
+     * responses. Every feature is linear in the pixels, so the gradient is
+     * exact and cheap to back-propagate. The image is optimized directly as
+     * an interleaved CV_32FC3 buffer mapped to an Eigen vector.
+     */
+    class StyleLoss
+    {
+    public:
+        /**
+         * @brief Number of feature maps in the Gram matrix
+         */
+        static constexpr int kFeatureCount = 9;
+
+        /**
+         * @brief Create a loss for one content frame
+         * @param content Content image (CV_32FC3, continuous, values in [0, 1])
+         * @param style_gram Target Gram matrix from computeGram()
+         * @param content_weight Weight for the content term
+         * @param style_weight Weight for the style term
+         */
+        StyleLoss(const cv::Mat &content, const cv::Mat &style_gram, double content_weight, double style_weight);
+
+        /**
+         * @brief Evaluate the loss and its gradient
+         * @param x Image as an interleaved vector of rows * cols * 3 floats
+         * @param gradient Receives d(loss)/dx
+         * @return Loss value
+         */
+        double evaluate(const Eigen::VectorXf &x, Eigen::VectorXf &gradient) const;
+
+        /**
+         * @brief Compute the normalized Gram matrix of an image's features
+         * @param image Image (CV_32FC3, continuous, values in [0, 1])
+         * @return kFeatureCount x kFeatureCount CV_32F matrix
+         */
+        static cv::Mat computeGram(const cv::Mat &image);
+
+    private:
+        using RowMatrixXf = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+        cv::Mat content_;
+        Eigen::MatrixXf style_gram_;
+        double content_weight_;
+        double style_weight_;
+
+        /**
+         * @brief Build the per-pixel feature matrix
+         * @param image Image (CV_32FC3, continuous)
+         * @return (rows * cols) x kFeatureCount CV_32F matrix
+         */
+        static cv::Mat extractFeatures(const cv::Mat &image);
+    };
+
+} // namespace video_styler::style_transfer
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+
+namespace video_styler::utils
+{
+
+    /**
+     * @brief SIMD instruction-set levels kernels are built for, in ascending order
+     */
+    enum class CpuIsa
+    {
+        GENERIC, // Compiler baseline (SSE2 on x86-64), always available
+        SSE42,
+        AVX2,    // AVX2 + FMA
+        AVX512   // AVX-512 F/BW/VL/DQ
+    };
+
+    /**
+     * @brief Detect the highest ISA level the running CPU and OS support
+     * @return Detected level (cached after the first call)
+     */
+    CpuIsa detectCpuIsa();
+
+    /**
+     * @brief Convert an ISA level to its display name
+     * @param isa ISA level
+     * @return Name such as "avx2"
+     */
+    std::string cpuIsaToString(CpuIsa isa);
+
+    /**
+     * @brief Parse an ISA name as printed by cpuIsaToString()
+     * @param name ISA name
+     * @param isa Receives the level
+     * @return true if the name is known
+     */
+    bool parseCpuIsa(const std::string &name, CpuIsa &isa);
+
+} // namespace video_styler::utils
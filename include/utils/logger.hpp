@@ -7,6 +7,7 @@
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <mutex>
 
 namespace video_styler::utils
 {
@@ -23,7 +24,7 @@ namespace video_styler::utils
     };
 
     /**
-     * @brief Simple logger class with singleton pattern
+     * @brief Simple thread-safe logger class with singleton pattern
      */
     class Logger
     {
@@ -90,6 +91,7 @@ namespace video_styler::utils
         LogLevel min_level_{LogLevel::INFO};
         std::string log_file_;
         std::ofstream file_stream_;
+        std::mutex mutex_; // Serializes output from pipeline worker threads
 
         /**
          * @brief Internal logging method
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace video_styler::utils
+{
+
+    /**
+     * @brief Byte budget for frame buffers shared by decoders and workers
+     *
+     * Producers acquire bytes before decoding and release them once the
+     * frames are written, so a full budget holds the decoder back instead of
+     * letting queues grow until the process is OOM-killed. A request larger
+     * than the whole budget is granted when nothing else is held, so one
+     * oversized frame or segment slows the pipeline down rather than
+     * deadlocking it. Thread-safe.
+     */
+    class MemoryBudget
+    {
+    public:
+        /**
+         * @brief Create a budget
+         * @param capacity Bytes that may be held at once (0: unlimited, usage is only tracked)
+         */
+        explicit MemoryBudget(std::size_t capacity = 0);
+
+        // Non-copyable, non-movable
+        MemoryBudget(const MemoryBudget &) = delete;
+        MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+        /**
+         * @brief Acquire bytes if they fit, without blocking
+         *
+         * Pool tasks must not block on the budget (the tasks that would free
+         * it could be queued behind them); they pass a callback instead and
+         * are re-scheduled once memory is released.
+         *
+         * @param bytes Bytes to acquire
+         * @param on_available Called once, after the next release, if the bytes did not fit
+         * @return true if acquired
+         */
+        bool tryAcquire(std::size_t bytes, std::function<void()> on_available = {});
+
+        /**
+         * @brief Block until bytes fit and acquire them
+         * @param bytes Bytes to acquire
+         * @param cancelled Gives up when set (wake waiters with cancelWaits())
+         * @return false if cancelled
+         */
+        bool acquire(std::size_t bytes, const std::atomic<bool> &cancelled);
+
+        /**
+         * @brief Return bytes and wake blocked or deferred acquirers
+         * @param bytes Bytes previously acquired
+         */
+        void release(std::size_t bytes);
+
+        /**
+         * @brief Wake every blocked acquire() so it can check its cancel flag
+         */
+        void cancelWaits();
+
+        /**
+         * @brief Check whether the budget limits anything
+         * @return true if a capacity was given
+         */
+        bool isLimited() const;
+
+        /**
+         * @brief Get the capacity
+         * @return Bytes (0: unlimited)
+         */
+        std::size_t getCapacity() const;
+
+        /**
+         * @brief Get the bytes held right now
+         * @return Bytes in use
+         */
+        std::size_t getInUse() const;
+
+        /**
+         * @brief Get the most bytes held at once
+         * @return Peak bytes in use
+         */
+        std::size_t getPeak() const;
+
+        /**
+         * @brief Describe peak usage against the capacity for logging
+         * @return Single-line summary
+         */
+        std::string describe() const;
+
+        /**
+         * @brief Parse a size such as "4G", "512M", "800k" or "1073741824" (binary units)
+         * @param text Size string
+         * @param bytes Receives the size in bytes
+         * @return true if the string is a valid size
+         */
+        static bool parseSize(const std::string &text, std::size_t &bytes);
+
+        /**
+         * @brief Get the size of one 8-bit frame buffer
+         * @param width Frame width
+         * @param height Frame height
+         * @param channels Channels per pixel
+         * @return Bytes
+         */
+        static std::size_t frameBytes(int width, int height, int channels = 3);
+
+        /**
+         * @brief Get the peak resident set size of the process (maxrss)
+         * @return Bytes (0 if unavailable)
+         */
+        static std::size_t peakResidentBytes();
+
+    private:
+        std::size_t capacity_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable available_cv_;
+        std::size_t in_use_{0};
+        std::size_t peak_{0};
+        std::vector<std::function<void()>> deferred_;
+
+        /**
+         * @brief Check whether a request fits. Requires the mutex to be held.
+         * @param bytes Requested bytes
+         * @return true if it fits (or nothing is held)
+         */
+        bool fits(std::size_t bytes) const;
+
+        /**
+         * @brief Record an acquisition. Requires the mutex to be held.
+         * @param bytes Acquired bytes
+         */
+        void take(std::size_t bytes);
+    };
+
+    /**
+     * @brief Owns acquired bytes of a MemoryBudget and releases them on destruction
+     */
+    class MemoryLease
+    {
+    public:
+        MemoryLease() = default;
+
+        /**
+         * @brief Take ownership of bytes already acquired from a budget
+         * @param budget Budget the bytes came from (may be null for an empty lease)
+         * @param bytes Acquired bytes
+         */
+        MemoryLease(MemoryBudget *budget, std::size_t bytes);
+
+        ~MemoryLease();
+
+        MemoryLease(const MemoryLease &) = delete;
+        MemoryLease &operator=(const MemoryLease &) = delete;
+        MemoryLease(MemoryLease &&other) noexcept;
+        MemoryLease &operator=(MemoryLease &&other) noexcept;
+
+        /**
+         * @brief Release the bytes now
+         */
+        void reset();
+
+        /**
+         * @brief Get the bytes held
+         * @return Bytes
+         */
+        std::size_t getBytes() const;
+
+    private:
+        MemoryBudget *budget_{nullptr};
+        std::size_t bytes_{0};
+    };
+
+} // namespace video_styler::utils
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace video_styler::utils
+{
+
+    /**
+     * @brief Process-wide CPU budget shared by the pipeline, OpenCV and Eigen
+     *
+     * The budget is split between pipeline workers (our own pools) and
+     * intra-op threads (OpenCV's parallel_for and Eigen) so that
+     * workers x intra-op never exceeds the cores the process may use. Apply it
+     * once at startup, before any pool is created.
+     */
+    class ThreadBudget
+    {
+    public:
+        /**
+         * @brief Partition a thread budget
+         * @param total_threads Threads the process may use (0: all CPUs in the affinity mask)
+         * @param intra_op_threads Threads per operation inside OpenCV/Eigen (0: 1 per pipeline worker)
+         * @param pipeline_workers Parallel pipeline workers wanted (0: as many as fit the budget)
+         */
+        explicit ThreadBudget(int total_threads = 0, int intra_op_threads = 0, int pipeline_workers = 0);
+
+        /**
+         * @brief Restrict the budget to the CPUs of one NUMA node
+         *
+         * apply() then confines the calling thread, and every thread it
+         * creates afterwards, to those CPUs, whether or not pinning is enabled.
+         *
+         * @param node NUMA node index
+         * @return true if the node exists and shares CPUs with the affinity mask
+         */
+        bool restrictToNumaNode(int node);
+
+        /**
+         * @brief Enable pinning of pipeline workers to individual CPUs
+         * @param enabled Whether pinCurrentThread() pins
+         */
+        void setPinning(bool enabled);
+
+        /**
+         * @brief Configure OpenCV and Eigen to use the intra-op share of the budget
+         *
+         * Call it from the main thread before any pool exists, so that a NUMA
+         * restriction is inherited by every thread started later.
+         *
+         * @return false if a NUMA restriction could not be applied to the affinity mask
+         */
+        bool apply() const;
+
+        /**
+         * @brief Pin the calling thread to the CPU assigned to a worker (no-op unless pinning is enabled)
+         * @param worker_index Index of the pipeline worker
+         * @return true if the thread was pinned
+         */
+        bool pinCurrentThread(std::size_t worker_index) const;
+
+        /**
+         * @brief Get the total number of threads in the budget
+         * @return Total threads
+         */
+        int getTotalThreads() const;
+
+        /**
+         * @brief Get the number of pipeline workers
+         * @return Worker count
+         */
+        int getPipelineWorkers() const;
+
+        /**
+         * @brief Get the number of intra-op threads per operation
+         * @return Intra-op thread count
+         */
+        int getIntraOpThreads() const;
+
+        /**
+         * @brief Get the CPUs the budget may use
+         * @return CPU indices
+         */
+        const std::vector<int> &getCpus() const;
+
+        /**
+         * @brief Describe the partition for logging
+         * @return Single-line summary
+         */
+        std::string describe() const;
+
+        /**
+         * @brief Get the CPUs in the calling process's affinity mask (honours taskset and cpusets)
+         * @return CPU indices
+         */
+        static std::vector<int> availableCpus();
+
+        /**
+         * @brief Parse a kernel CPU list such as "0-3,8,10-11"
+         * @param cpu_list CPU list string
+         * @return CPU indices in ascending order
+         */
+        static std::vector<int> parseCpuList(const std::string &cpu_list);
+
+    private:
+        std::vector<int> cpus_;
+        int total_threads_;
+        int requested_intra_op_;
+        int requested_workers_;
+        int intra_op_threads_{1};
+        int pipeline_workers_{1};
+        bool pinning_{false};
+        bool restricted_{false}; // The CPU set was narrowed to a NUMA node
+
+        /**
+         * @brief Recompute the partition after the CPU set or request changed
+         */
+        void partition();
+    };
+
+} // namespace video_styler::utils
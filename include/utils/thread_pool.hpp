@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace video_styler::utils
+{
+
+    /**
+     * @brief Work-stealing thread pool
+     *
+     * Every worker owns a task deque. Tasks submitted from a worker are pushed
+     * onto that worker's own deque and popped LIFO for cache locality; idle
+     * workers steal FIFO from the other deques, so work from one job spills
+     * over onto workers that ran out of work from another.
+     */
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void()>;
+
+        /**
+         * @brief Called on each worker thread before it runs tasks (e.g. to pin it)
+         */
+        using WorkerInitializer = std::function<void(std::size_t worker_index)>;
+
+        /**
+         * @brief Create a pool and start its workers
+         * @param num_threads Number of workers (0 selects hardware concurrency)
+         * @param on_worker_start Optional per-worker initialization
+         */
+        explicit ThreadPool(std::size_t num_threads = 0, WorkerInitializer on_worker_start = {});
+
+        /**
+         * @brief Drain outstanding tasks and join all workers
+         */
+        ~ThreadPool();
+
+        // Non-copyable, non-movable
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+        ThreadPool(ThreadPool &&) = delete;
+        ThreadPool &operator=(ThreadPool &&) = delete;
+
+        /**
+         * @brief Schedule a task for execution
+         * @param task Task to run; exceptions escaping it are swallowed
+         */
+        void submit(Task task);
+
+        /**
+         * @brief Block until every submitted task (including tasks those tasks
+         *        submitted) has finished. Must not be called from a worker.
+         */
+        void waitIdle();
+
+        /**
+         * @brief Get the number of worker threads
+         * @return Worker count
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief Get the number of tasks taken from another worker's deque
+         * @return Steal count since construction
+         */
+        std::size_t stealCount() const;
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues_;
+        std::vector<std::thread> workers_;
+        WorkerInitializer on_worker_start_;
+
+        std::mutex wake_mutex_;
+        std::condition_variable wake_cv_;
+        std::condition_variable idle_cv_;
+
+        std::atomic<std::size_t> queued_{0};
+        std::atomic<std::size_t> pending_{0};
+        std::atomic<std::size_t> steals_{0};
+        std::atomic<std::size_t> next_queue_{0};
+        bool stopping_{false};
+
+        /**
+         * @brief Main loop executed by each worker
+         * @param index Index of the worker's own queue
+         */
+        void workerLoop(std::size_t index);
+
+        /**
+         * @brief Pop from the own deque, or steal from another one
+         * @param index Index of the calling worker
+         * @param task Receives the task
+         * @return true if a task was obtained
+         */
+        bool acquireTask(std::size_t index, Task &task);
+
+        /**
+         * @brief Mark a task as finished and wake waiters if the pool is idle
+         */
+        void finishTask();
+    };
+
+} // namespace video_styler::utils
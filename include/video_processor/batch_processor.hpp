@@ -0,0 +1,225 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "video_processor/shard_protocol.hpp"
+#include "style_transfer/neural_style_transfer.hpp"
+#include "utils/memory_budget.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace video_styler::video_processor
+{
+
+    /**
+     * @brief One input/style/output triple from a batch manifest
+     */
+    struct BatchJob
+    {
+        std::string input_path;
+        std::string style_path;
+        std::string output_path;
+    };
+
+    /**
+     * @brief Completion state of a batch job
+     */
+    enum class JobStatus
+    {
+        PENDING,
+        RUNNING,
+        COMPLETED,
+        FAILED
+    };
+
+    /**
+     * @brief Per-job outcome of a batch run
+     */
+    struct JobReport
+    {
+        BatchJob job;
+        JobStatus status{JobStatus::PENDING};
+        int frames_processed{0};
+        int frames_reused{0}; // Frames served from the dedupe cache
+        double seconds{0.0};
+        std::string error;
+    };
+
+    /**
+     * @brief Aggregate outcome of a batch run
+     */
+    struct BatchReport
+    {
+        std::vector<JobReport> jobs;
+        int total_frames{0};
+        double wall_seconds{0.0};
+        std::size_t steals{0};
+
+        /**
+         * @brief Get the number of jobs that completed successfully
+         * @return Completed job count
+         */
+        std::size_t completedCount() const;
+
+        /**
+         * @brief Get the aggregate throughput over the whole run
+         * @return Frames per second across all jobs
+         */
+        double throughput() const;
+    };
+
+    /**
+     * @brief Runs many stylization jobs on one shared work-stealing pool
+     *
+     * Each job is decoded sequentially in segments; every decoded segment is
+     * stylized as an independent task, and finished segments are written to
+     * the job's output strictly in order. Because all jobs feed the same pool,
+     * workers that run out of work for one clip pick up segments of another.
+     * Every distinct style is decoded and prepared once, as its own task,
+     * while the jobs open their inputs; segments decoded before their style
+     * is ready wait for it without holding a worker. In optimize mode each
+     * job keeps one warm-started style transfer, so its segments are
+     * stylized in order, one at a time, while other jobs use the rest of
+     * the pool.
+     */
+    class BatchProcessor
+    {
+    public:
+        /**
+         * @brief Create a batch processor
+         * @param pool Pool to schedule tasks on (must outlive run())
+         * @param segment_frames Number of frames per stylization task
+         */
+        explicit BatchProcessor(utils::ThreadPool &pool, int segment_frames = 32);
+
+        /**
+         * @brief Parse a JSON manifest of the form {"jobs": [{"input", "style", "output"}, ...]}
+         * @param filepath Path to the manifest file
+         * @param jobs Receives the parsed jobs
+         * @return true if successful, false otherwise
+         */
+        static bool loadManifest(const std::string &filepath, std::vector<BatchJob> &jobs);
+
+        /**
+         * @brief Reuse stylized output for repeated frames within each segment
+         *
+         * Repeats are only matched within a segment, so the output does not
+         * depend on which segments happen to run concurrently.
+         *
+         * @param capacity Frames cached per segment (0 disables deduplication)
+         * @param tolerance Maximum differing perceptual-hash bits
+         */
+        void setDedupe(std::size_t capacity, int tolerance);
+
+        /**
+         * @brief Stylize with these settings instead of the FAST defaults
+         * @param settings Mode, optimizer parameters and tensor precision
+         * @return false if the mode or precision is unknown (the settings are unchanged)
+         */
+        bool setRenderSettings(const RenderSettings &settings);
+
+        /**
+         * @brief Hold decoded segments within a memory budget
+         *
+         * Each decoded segment is charged to the budget until it is written;
+         * a decode that does not fit waits, without blocking a worker, until
+         * finished segments free memory. With a limited budget, segments are
+         * also shortened so every worker can hold one in half of it.
+         *
+         * @param budget Budget to charge (null: untracked); must outlive run()
+         */
+        void setMemoryBudget(utils::MemoryBudget *budget);
+
+        /**
+         * @brief Process all jobs and block until every one has finished or failed
+         * @param jobs Jobs to run
+         * @return Per-job status and aggregate throughput
+         */
+        BatchReport run(const std::vector<BatchJob> &jobs);
+
+    private:
+        struct JobState;
+        struct ReadySegment;
+
+        utils::ThreadPool &pool_;
+        int segment_frames_;
+        std::size_t dedupe_capacity_{0};
+        int dedupe_tolerance_{0};
+        utils::MemoryBudget *memory_budget_{nullptr};
+        RenderSettings render_;
+        style_transfer::TransferMode mode_{style_transfer::TransferMode::FAST};
+        style_transfer::TensorPrecision precision_{style_transfer::TensorPrecision::FP32};
+
+        /**
+         * @brief Configure a style transfer with the render settings
+         * @param style_transfer Style transfer to configure
+         */
+        void configure(style_transfer::NeuralStyleTransfer &style_transfer) const;
+
+        /**
+         * @brief Decode and prepare a style, then release the segments of its jobs that wait for it
+         * @param style_path Path to the style image
+         * @param jobs Jobs using the style
+         */
+        void loadStyle(const std::string &style_path, const std::vector<JobState *> &jobs);
+
+        /**
+         * @brief Open a job's input and output, then start decoding
+         * @param state Job to start
+         */
+        void startJob(JobState &state);
+
+        /**
+         * @brief Decode the next segment of a job and schedule its stylization
+         * @param state Job to decode from
+         * @param segment_index Index of the segment to decode
+         */
+        void decodeSegment(JobState &state, int segment_index);
+
+        /**
+         * @brief Stylize one decoded segment and write any in-order segments
+         * @param state Owning job
+         * @param segment_index Index of the segment
+         * @param frames Decoded frames, stylized in place
+         * @param lease Budget held by the frames until they are written
+         */
+        void stylizeSegment(JobState &state, int segment_index, std::vector<cv::Mat> frames,
+                            std::shared_ptr<utils::MemoryLease> lease);
+
+        /**
+         * @brief Take the queued stylize tasks that may run now: all of them once
+         *        the style is ready, or in optimize mode the next one when none
+         *        is running. Requires the job mutex to be held.
+         * @param state Owning job
+         * @return Tasks to submit after releasing the mutex
+         */
+        std::vector<std::function<void()>> takeRunnableSegments(JobState &state);
+
+        /**
+         * @brief Write every ready segment that continues the output in order,
+         *        completing the job once the last one is written. Requires the
+         *        job mutex to be held.
+         * @param state Owning job
+         */
+        void writeReadySegments(JobState &state);
+
+        /**
+         * @brief Mark a job as failed and release its resources
+         * @param state Failed job
+         * @param error Reason for the failure
+         */
+        void failJob(JobState &state, const std::string &error);
+    };
+
+    /**
+     * @brief Get string representation of a job status
+     * @param status Job status
+     * @return String representation
+     */
+    std::string jobStatusToString(JobStatus status);
+
+} // namespace video_styler::video_processor
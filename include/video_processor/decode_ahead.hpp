@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <opencv2/opencv.hpp>
+
+#include "utils/memory_budget.hpp"
+
+namespace video_styler::video_processor
+{
+
+    /**
+     * @brief A decoded frame and the budget bytes it holds
+     */
+    struct DecodedFrame
+    {
+        cv::Mat image;
+        utils::MemoryLease lease; // Keep until the frame's output has been written
+    };
+
+    /**
+     * @brief Decodes a file input on its own thread, a bounded number of frames ahead
+     *
+     * Unlike LiveCapture nothing is dropped: the decoder stops when the queue
+     * is full or the memory budget has no room for another frame, and resumes
+     * as the consumer releases frames, so stylization overlaps decoding
+     * without the queue outgrowing the budget.
+     */
+    class DecodeAhead
+    {
+    public:
+        /**
+         * @brief Produces the next frame; returns false at end of stream
+         */
+        using FrameSource = std::function<bool(cv::Mat &)>;
+
+        /**
+         * @brief Decode from an arbitrary frame source
+         * @param source Blocking frame producer, called only from the decode thread
+         * @param frame_bytes Budget bytes charged per frame
+         * @param max_queued Frames decoded ahead of the consumer (at least 1)
+         * @param budget Budget to charge frames to (may be null)
+         */
+        DecodeAhead(FrameSource source, std::size_t frame_bytes, std::size_t max_queued,
+                    utils::MemoryBudget *budget = nullptr);
+
+        /**
+         * @brief Decode from an opened OpenCV capture
+         * @param capture Opened capture; must outlive this object
+         * @param frame_bytes Budget bytes charged per frame
+         * @param max_queued Frames decoded ahead of the consumer (at least 1)
+         * @param budget Budget to charge frames to (may be null)
+         */
+        DecodeAhead(cv::VideoCapture &capture, std::size_t frame_bytes, std::size_t max_queued,
+                    utils::MemoryBudget *budget = nullptr);
+
+        /**
+         * @brief Stop decoding and join the decode thread
+         */
+        ~DecodeAhead();
+
+        // Non-copyable, non-movable (owns a running thread)
+        DecodeAhead(const DecodeAhead &) = delete;
+        DecodeAhead &operator=(const DecodeAhead &) = delete;
+        DecodeAhead(DecodeAhead &&) = delete;
+        DecodeAhead &operator=(DecodeAhead &&) = delete;
+
+        /**
+         * @brief Wait for the next frame in decode order
+         * @param frame Receives the frame and its lease (whatever it held is released first)
+         * @return false once the source is exhausted and the queue is empty
+         */
+        bool read(DecodedFrame &frame);
+
+        /**
+         * @brief Stop the decode thread and drop the queued frames
+         */
+        void stop();
+
+        /**
+         * @brief Get the most frames that were queued at once
+         * @return Peak queue depth
+         */
+        std::size_t getPeakQueued() const;
+
+    private:
+        FrameSource source_;
+        std::size_t frame_bytes_;
+        std::size_t max_queued_;
+        utils::MemoryBudget *budget_;
+        std::thread thread_;
+        std::atomic<bool> stopping_{false};
+
+        mutable std::mutex mutex_;
+        std::condition_variable queue_cv_;
+        std::deque<DecodedFrame> queue_;
+        std::size_t peak_queued_{0};
+        bool finished_{false};
+
+        /**
+         * @brief Decode thread body
+         */
+        void decodeLoop();
+    };
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <opencv2/opencv.hpp>
+
+namespace video_styler::video_processor
+{
+
+    /**
+     * @brief Perceptual fingerprint of a frame
+     */
+    struct FrameSignature
+    {
+        std::uint64_t hash{0};    // 64-bit difference hash (dHash) of a 9x8 grayscale thumbnail
+        cv::Scalar mean;          // Per-channel thumbnail mean; dHash alone is blind to fades and tints
+        std::uint64_t content{0}; // Hash of every pixel of the full-resolution frame
+        cv::Mat detail{};         // 32x32 thumbnail that confirms near repeats
+    };
+
+    /**
+     * @brief Small LRU cache of stylized frames keyed by perceptual hash
+     *
+     * Screen recordings, slideshows and telecined footage repeat frames. A
+     * frame whose signature lies within the tolerance of a cached one reuses
+     * that entry's stylized output instead of running style transfer again.
+     * The coarse hash only nominates candidates: with tolerance 0 a hit needs
+     * identical pixels (equal content hashes), otherwise the 32x32 thumbnails
+     * must agree to within a few levels everywhere, so slow fades and small
+     * moving regions are stylized again. Not thread-safe; use one cache per
+     * sequential stream of frames.
+     */
+    class FrameDedupeCache
+    {
+    public:
+        /**
+         * @brief Create a cache
+         * @param capacity Number of stylized frames kept
+         * @param tolerance Maximum number of differing hash bits for a hit (0-64; 0 reuses exact repeats only)
+         */
+        explicit FrameDedupeCache(std::size_t capacity = 16, int tolerance = 0);
+
+        /**
+         * @brief Compute the perceptual signature of a frame
+         * @param frame Gray, BGR or BGRA frame
+         * @return Signature
+         */
+        static FrameSignature computeSignature(const cv::Mat &frame);
+
+        /**
+         * @brief Count the bits in which two hashes differ
+         * @param a First hash
+         * @param b Second hash
+         * @return Hamming distance
+         */
+        static int hammingDistance(std::uint64_t a, std::uint64_t b);
+
+        /**
+         * @brief Look up the stylized output of a near-identical frame
+         * @param signature Signature of the new frame
+         * @param output Receives a copy of the cached output on a hit
+         * @return true on a hit
+         */
+        bool lookup(const FrameSignature &signature, cv::Mat &output);
+
+        /**
+         * @brief Remember the stylized output of a frame, evicting the least recently used entry
+         * @param signature Signature of the source frame
+         * @param output Stylized frame (copied)
+         */
+        void insert(const FrameSignature &signature, const cv::Mat &output);
+
+        /**
+         * @brief Drop every entry (statistics are kept)
+         */
+        void clear();
+
+        /**
+         * @brief Get the number of cached frames
+         * @return Entry count
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief Get the number of lookups so far
+         * @return Lookup count
+         */
+        std::size_t getLookups() const;
+
+        /**
+         * @brief Get the number of lookups that hit
+         * @return Hit count
+         */
+        std::size_t getHits() const;
+
+        /**
+         * @brief Get the fraction of lookups that hit
+         * @return Hit rate in [0, 1]
+         */
+        double getHitRate() const;
+
+        /**
+         * @brief Describe the hit statistics for logging
+         * @return Single-line summary
+         */
+        std::string describe() const;
+
+    private:
+        struct Entry
+        {
+            FrameSignature signature;
+            cv::Mat output;
+        };
+
+        std::list<Entry> entries_; // Most recently used first
+        std::size_t capacity_;
+        int tolerance_;
+        std::size_t lookups_{0};
+        std::size_t hits_{0};
+    };
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+namespace video_styler::video_processor
+{
+
+    /**
+     * @brief Expected access pattern over a FrameStore, forwarded to madvise
+     */
+    enum class AccessPattern
+    {
+        NORMAL,
+        SEQUENTIAL,
+        RANDOM
+    };
+
+    /**
+     * @brief Spill-to-disk frame store backed by a memory-mapped file
+     *
+     * Frames are stored at a fixed, page-aligned stride so any frame can be
+     * addressed by index and paged in or out independently. The backing file
+     * is unlinked as soon as it is mapped, so it disappears when the store is
+     * closed or the process exits, even after a crash. This lets multi-pass
+     * algorithms revisit frames of long videos without holding them all in
+     * RAM or decoding the source again.
+     */
+    class FrameStore
+    {
+    public:
+        FrameStore() = default;
+        ~FrameStore();
+
+        // Non-copyable, movable
+        FrameStore(const FrameStore &) = delete;
+        FrameStore &operator=(const FrameStore &) = delete;
+        FrameStore(FrameStore &&other) noexcept;
+        FrameStore &operator=(FrameStore &&other) noexcept;
+
+        /**
+         * @brief Create the backing file and map it
+         * @param capacity Maximum number of frames
+         * @param frame_size Size of every frame
+         * @param type OpenCV element type of every frame (e.g. CV_8UC3)
+         * @param directory Directory for the backing file (empty for the system temp directory)
+         * @return true if successful, false otherwise
+         */
+        bool create(int capacity, cv::Size frame_size, int type, const std::string &directory = "");
+
+        /**
+         * @brief Copy a frame into the store
+         * @param index Frame index in [0, capacity)
+         * @param frame Frame matching the store's size and type
+         * @return true if successful, false otherwise
+         */
+        bool write(int index, const cv::Mat &frame);
+
+        /**
+         * @brief Copy a stored frame out of the store
+         * @param index Frame index
+         * @param frame Receives a copy of the frame
+         * @return true if the frame has been written, false otherwise
+         */
+        bool read(int index, cv::Mat &frame) const;
+
+        /**
+         * @brief Get a zero-copy view of a stored frame
+         * @param index Frame index
+         * @return Matrix header over the mapping (valid until close), or an empty Mat
+         */
+        cv::Mat view(int index) const;
+
+        /**
+         * @brief Check whether a frame has been written
+         * @param index Frame index
+         * @return true if the frame is present
+         */
+        bool contains(int index) const;
+
+        /**
+         * @brief Hint the kernel about the upcoming access pattern
+         * @param pattern Access pattern for the whole store
+         */
+        void adviseAccessPattern(AccessPattern pattern);
+
+        /**
+         * @brief Ask the kernel to start reading a range of frames ahead of use
+         * @param first First frame index
+         * @param count Number of frames
+         */
+        void prefetch(int first, int count);
+
+        /**
+         * @brief Drop a range of frames from resident memory (data stays on disk)
+         * @param first First frame index
+         * @param count Number of frames
+         */
+        void evict(int first, int count);
+
+        /**
+         * @brief Unmap and delete the backing file
+         */
+        void close();
+
+        /**
+         * @brief Check if the store is mapped
+         * @return true if the store is open
+         */
+        bool isOpen() const;
+
+        /**
+         * @brief Get the maximum number of frames
+         * @return Capacity in frames
+         */
+        int getCapacity() const;
+
+        /**
+         * @brief Get the distance between consecutive frames in the mapping
+         * @return Stride in bytes (multiple of the page size)
+         */
+        std::size_t getStride() const;
+
+    private:
+        unsigned char *mapping_{nullptr};
+        std::size_t mapping_bytes_{0};
+        std::size_t stride_{0};
+        int capacity_{0};
+        cv::Size frame_size_;
+        int type_{0};
+        std::vector<bool> written_;
+
+        /**
+         * @brief Apply madvise to a range of frames
+         * @param first First frame index
+         * @param count Number of frames
+         * @param advice madvise advice flag
+         */
+        void advise(int first, int count, int advice);
+    };
+
+} // namespace video_styler::video_processor
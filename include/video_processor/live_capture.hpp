@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <opencv2/opencv.hpp>
+
+namespace video_styler::video_processor
+{
+
+    /**
+     * @brief A frame grabbed from a live source
+     */
+    struct CapturedFrame
+    {
+        cv::Mat image;
+        std::chrono::steady_clock::time_point capture_time;
+        std::uint64_t sequence{0};
+    };
+
+    /**
+     * @brief Grabs frames from a live source on its own thread
+     *
+     * The capture thread keeps exactly one slot: every new frame replaces the
+     * previous one whether or not it was consumed ("latest frame wins"), so a
+     * slow consumer always works on the freshest frame instead of draining a
+     * growing backlog. Replaced frames are counted as dropped.
+     */
+    class LiveCapture
+    {
+    public:
+        /**
+         * @brief Produces the next frame; returns false at end of stream
+         */
+        using FrameSource = std::function<bool(cv::Mat &)>;
+
+        /**
+         * @brief Capture from an arbitrary frame source (e.g. a synthetic generator)
+         * @param source Blocking frame producer, called only from the capture thread
+         */
+        explicit LiveCapture(FrameSource source);
+
+        /**
+         * @brief Capture from an opened OpenCV capture (camera or V4L2 device)
+         * @param capture Opened capture; must outlive this object
+         */
+        explicit LiveCapture(cv::VideoCapture &capture);
+
+        /**
+         * @brief Stop capturing and join the capture thread
+         */
+        ~LiveCapture();
+
+        // Non-copyable, non-movable (owns a running thread)
+        LiveCapture(const LiveCapture &) = delete;
+        LiveCapture &operator=(const LiveCapture &) = delete;
+        LiveCapture(LiveCapture &&) = delete;
+        LiveCapture &operator=(LiveCapture &&) = delete;
+
+        /**
+         * @brief Start the capture thread
+         * @return true if started, false if already running
+         */
+        bool start();
+
+        /**
+         * @brief Stop the capture thread (returns once the current grab finishes)
+         */
+        void stop();
+
+        /**
+         * @brief Wait for a frame newer than the last one returned
+         * @param frame Receives the freshest frame
+         * @param timeout Maximum time to wait
+         * @return true if a frame was returned, false on timeout or end of stream
+         */
+        bool waitForFrame(CapturedFrame &frame, std::chrono::milliseconds timeout);
+
+        /**
+         * @brief Check whether the source has reported end of stream
+         * @return true once no more frames will arrive
+         */
+        bool isFinished() const;
+
+        /**
+         * @brief Get the number of frames grabbed from the source
+         * @return Captured frame count
+         */
+        std::uint64_t getCapturedFrames() const;
+
+        /**
+         * @brief Get the number of frames replaced before they were consumed
+         * @return Dropped frame count
+         */
+        std::uint64_t getDroppedFrames() const;
+
+    private:
+        FrameSource source_;
+        std::thread thread_;
+        std::atomic<bool> running_{false};
+
+        mutable std::mutex mutex_;
+        std::condition_variable frame_cv_;
+        CapturedFrame latest_;
+        bool has_unconsumed_{false};
+        bool finished_{false};
+        std::uint64_t captured_{0};
+        std::uint64_t dropped_{0};
+
+        /**
+         * @brief Capture thread body
+         */
+        void captureLoop();
+    };
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace video_styler::video_processor
+{
+
+    /**
+     * @brief One rung of the realtime quality ladder
+     */
+    struct QualityLevel
+    {
+        double scale{1.0};   // Working resolution relative to the source
+        int iterations{500}; // Optimization iterations per frame
+    };
+
+    /**
+     * @brief Feedback controller that trades quality for frame rate
+     *
+     * Per-frame latency is smoothed with an exponential moving average. When
+     * the average exceeds the latency budget the controller steps down to a
+     * cheaper quality level; when it stays comfortably below the budget for a
+     * while it steps back up. Frames whose deadline has already passed by more
+     * than the budget are dropped instead of letting the pipeline fall behind.
+     */
+    class RealtimeController
+    {
+    public:
+        /**
+         * @brief Create a controller
+         * @param target_fps Frame rate to sustain
+         * @param latency_budget_ms Per-frame latency budget (0 uses one frame interval)
+         */
+        explicit RealtimeController(double target_fps, double latency_budget_ms = 0.0);
+
+        /**
+         * @brief Replace the quality ladder, ordered from best to cheapest
+         * @param levels Quality levels (must not be empty)
+         */
+        void setLevels(std::vector<QualityLevel> levels);
+
+        /**
+         * @brief Build the default ladder for a configured iteration count
+         *
+         * Level 0 runs the configured count at full resolution; cheaper levels
+         * lower the resolution and run 2/5, 1/5, 1/10 and 1/25 of it (at least one).
+         *
+         * @param iterations Iterations per frame at the best level
+         * @return Quality levels, best first
+         */
+        static std::vector<QualityLevel> defaultLevels(int iterations);
+
+        /**
+         * @brief Decide whether a frame is too late to be worth processing
+         * @param lateness_ms How far past its deadline the frame already is
+         * @return true if the frame should be dropped
+         */
+        bool shouldDrop(double lateness_ms);
+
+        /**
+         * @brief Feed back the processing latency of a frame
+         * @param latency_ms Time spent processing the frame
+         * @return true if the quality level changed
+         */
+        bool recordLatency(double latency_ms);
+
+        /**
+         * @brief Get the quality level to use for the next frame
+         * @return Current quality level
+         */
+        const QualityLevel &getLevel() const;
+
+        /**
+         * @brief Get the index of the current level (0 is best quality)
+         * @return Level index
+         */
+        int getLevelIndex() const;
+
+        /**
+         * @brief Get the number of levels in the ladder
+         * @return Level count
+         */
+        int getLevelCount() const;
+
+        /**
+         * @brief Get the smoothed per-frame latency
+         * @return Average latency in milliseconds
+         */
+        double getAverageLatency() const;
+
+        /**
+         * @brief Get the per-frame latency budget
+         * @return Budget in milliseconds
+         */
+        double getLatencyBudget() const;
+
+        /**
+         * @brief Get the number of frames processed so far
+         * @return Processed frame count
+         */
+        int getProcessedFrames() const;
+
+        /**
+         * @brief Get the number of frames dropped so far
+         * @return Dropped frame count
+         */
+        int getDroppedFrames() const;
+
+        /**
+         * @brief Describe the current state for operators
+         * @return Single-line summary of level, scale, iterations and latency
+         */
+        std::string describe() const;
+
+        /**
+         * @brief Write the current state as JSON so it can be scraped
+         * @param filepath Destination file (replaced atomically)
+         * @return true if successful, false otherwise
+         */
+        bool writeStatus(const std::string &filepath) const;
+
+    private:
+        std::vector<QualityLevel> levels_;
+        int level_{0};
+        double budget_ms_;
+        double average_ms_{0.0};
+        int frames_since_change_{0};
+        int processed_{0};
+        int dropped_{0};
+
+        /**
+         * @brief Move to another level and reset the hysteresis counter
+         * @param level New level index
+         */
+        void changeLevel(int level);
+    };
+
+} // namespace video_styler::video_processor
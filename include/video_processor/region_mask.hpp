@@ -0,0 +1,95 @@
+#pragma once
+
+#include <string>
+#include <opencv2/opencv.hpp>
+
+#include "video_processor/video_loader.hpp"
+
+namespace video_styler::video_processor
+{
+
+    /**
+     * @brief Where a region mask comes from
+     */
+    enum class RegionSource
+    {
+        NONE,      // Whole frame
+        RECTANGLE, // Fixed rectangle
+        IMAGE,     // Static mask image
+        MATTE      // Per-frame matte video read in lockstep with the input
+    };
+
+    /**
+     * @brief Per-frame stylization mask from a rectangle, an image or a matte video
+     *
+     * Masks are CV_8UC1 at the frame size: 0 leaves a pixel untouched, 255
+     * stylizes it fully and values in between blend. Static sources are
+     * rasterized once per frame size; a matte video advances one frame per
+     * call to next().
+     */
+    class RegionMask
+    {
+    public:
+        RegionMask() = default;
+
+        /**
+         * @brief Restrict stylization to a rectangle
+         * @param rect Rectangle in frame coordinates
+         * @return true if the rectangle is non-empty
+         */
+        bool setRectangle(const cv::Rect &rect);
+
+        /**
+         * @brief Use a grayscale image as a static mask (scaled to the frame size)
+         * @param filepath Path to the mask image
+         * @return true if successful, false otherwise
+         */
+        bool loadImage(const std::string &filepath);
+
+        /**
+         * @brief Read a matte video frame by frame alongside the input
+         * @param filepath Path to the matte video
+         * @return true if successful, false otherwise
+         */
+        bool openMatte(const std::string &filepath);
+
+        /**
+         * @brief Get the mask for the next frame
+         * @param frame_size Size of the frame the mask applies to
+         * @param mask Receives the CV_8UC1 mask
+         * @return false if no mask is available (no source, or the matte has no frames)
+         */
+        bool next(const cv::Size &frame_size, cv::Mat &mask);
+
+        /**
+         * @brief Get the mask source
+         * @return Source kind
+         */
+        RegionSource getSource() const;
+
+        /**
+         * @brief Check whether a matte video ran out before the input and its last frame is being repeated
+         * @return true if the matte was exhausted
+         */
+        bool isMatteExhausted() const;
+
+        /**
+         * @brief Parse a rectangle given as "x,y,width,height"
+         * @param text Rectangle text
+         * @param rect Receives the rectangle
+         * @return true if the text is four comma-separated integers with positive size
+         */
+        static bool parseRectangle(const std::string &text, cv::Rect &rect);
+
+    private:
+        RegionSource source_{RegionSource::NONE};
+        cv::Rect rect_;
+        cv::Mat image_;
+        VideoLoader matte_;
+        bool matte_exhausted_{false};
+
+        // Static mask rasterized at the last frame size, or the last matte frame
+        cv::Mat current_;
+    };
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "style_transfer/neural_style_transfer.hpp"
+#include "video_processor/segment_file.hpp"
+
+namespace video_styler::video_processor
+{
+
+    /**
+     * @brief A committed segment of a checkpointed render
+     */
+    struct CheckpointSegment
+    {
+        std::string file; // File name inside the checkpoint directory
+        int first_frame{0};
+        int frame_count{0};
+    };
+
+    /**
+     * @brief Outcome of RenderCheckpoint::resume
+     */
+    enum class ResumeResult
+    {
+        RESUMED,       // Committed segments and temporal state were restored
+        STARTED_FRESH, // No usable checkpoint; started from frame 0
+        FAILED         // No usable checkpoint and the directory could not be recreated
+    };
+
+    /**
+     * @brief Periodic checkpoints that let an interrupted render resume
+     *
+     * Stylized frames go to lossless segment files in `<output>.checkpoint/`
+     * instead of straight to the encoder. Every `interval` frames the open
+     * segment is closed and `checkpoint.yml` is rewritten atomically with the
+     * committed segments, the number of frames they hold and the style
+     * transfer's temporal state after the last of them. A resumed run skips
+     * that many input frames, restores the state and keeps appending; the
+     * final output is stitched from the segments in order. Frames written
+     * after the last checkpoint are discarded on resume and rendered again.
+     * Segments are lossless, so the directory grows by a few MB per 1080p
+     * frame until the final stitch.
+     */
+    class RenderCheckpoint
+    {
+    public:
+        /**
+         * @brief Describe a checkpointed render
+         * @param output_path Final output video; the checkpoint lives next to it
+         * @param job_key Fingerprint of input and settings; a checkpoint of another job is never resumed
+         * @param interval Frames per segment, i.e. between checkpoints
+         */
+        RenderCheckpoint(const std::string &output_path, std::string job_key, int interval);
+
+        /**
+         * @brief Continue from the checkpoint on disk, restoring the temporal state
+         *
+         * Falls back to a fresh start if there is no checkpoint, it belongs to
+         * another job, or a segment is missing.
+         *
+         * @param style_transfer Receives the temporal state
+         * @return RESUMED, STARTED_FRESH, or FAILED if the fresh start failed
+         */
+        ResumeResult resume(style_transfer::NeuralStyleTransfer &style_transfer);
+
+        /**
+         * @brief Discard any previous checkpoint and start from frame 0
+         * @return false if the checkpoint directory cannot be created
+         */
+        bool start();
+
+        /**
+         * @brief Append a stylized frame, checkpointing when the segment is full
+         * @param frame Stylized frame
+         * @param style_transfer Source of the temporal state recorded at a checkpoint
+         * @return false if the segment or the checkpoint cannot be written
+         */
+        bool write(const cv::Mat &frame, const style_transfer::NeuralStyleTransfer &style_transfer);
+
+        /**
+         * @brief Close the open segment and checkpoint it (e.g. at the end or on a stop request)
+         * @param style_transfer Source of the temporal state
+         * @return false if the checkpoint cannot be written
+         */
+        bool flush(const style_transfer::NeuralStyleTransfer &style_transfer);
+
+        /**
+         * @brief Feed every committed segment to the final encoder in order
+         * @param writer Opened output writer
+         * @return false if a segment is missing or corrupt
+         */
+        bool stitch(cv::VideoWriter &writer) const;
+
+        /**
+         * @brief Delete the checkpoint directory (after a successful stitch)
+         */
+        void remove() const;
+
+        /**
+         * @brief Get the number of frames in committed segments
+         * @return Frame count
+         */
+        int getCommittedFrames() const;
+
+        /**
+         * @brief Get the committed segments in frame order
+         * @return Segments
+         */
+        const std::vector<CheckpointSegment> &getSegments() const;
+
+        /**
+         * @brief Get the checkpoint directory
+         * @return Directory path
+         */
+        const std::string &getDirectory() const;
+
+    private:
+        std::string directory_;
+        std::string job_key_;
+        int interval_;
+
+        std::vector<CheckpointSegment> segments_;
+        int committed_frames_{0};
+
+        // Segment being filled; committed by the next checkpoint
+        std::unique_ptr<std::ofstream> segment_stream_;
+        std::unique_ptr<SegmentWriter> segment_writer_;
+        std::string segment_file_;
+
+        /**
+         * @brief Open the next segment file
+         * @return false if it cannot be created
+         */
+        bool openSegment();
+
+        /**
+         * @brief Write checkpoint.yml through a temporary file and rename it into place
+         * @param style_transfer Source of the temporal state
+         * @return true if successful
+         */
+        bool writeCheckpoint(const style_transfer::NeuralStyleTransfer &style_transfer) const;
+
+        /**
+         * @brief Get the path of a file inside the checkpoint directory
+         * @param name File name
+         * @return Path
+         */
+        std::string pathOf(const std::string &name) const;
+    };
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <opencv2/opencv.hpp>
+
+namespace video_styler::video_processor
+{
+
+    /**
+     * @brief Writes a lossless frame segment to a stream
+     *
+     * A segment is a magic header followed by length-prefixed PNG frames. It
+     * carries stylized (or source) frames between processes and across
+     * restarts without a second lossy encode; SegmentStitcher later feeds
+     * segments to the final encoder in order.
+     */
+    class SegmentWriter
+    {
+    public:
+        /**
+         * @brief Start a segment on a stream (the header is written immediately)
+         * @param out Binary output stream, kept by reference
+         */
+        explicit SegmentWriter(std::ostream &out);
+
+        /**
+         * @brief Append a frame
+         * @param frame 8- or 16-bit frame with 1, 3 or 4 channels
+         * @return true if successful, false otherwise
+         */
+        bool write(const cv::Mat &frame);
+
+        /**
+         * @brief Get the number of frames written
+         * @return Frame count
+         */
+        int getFrameCount() const;
+
+    private:
+        std::ostream &out_;
+        int frame_count_{0};
+    };
+
+    /**
+     * @brief Reads the frames of a segment written by SegmentWriter
+     */
+    class SegmentReader
+    {
+    public:
+        /**
+         * @brief Start reading a segment (the header is checked immediately)
+         * @param in Binary input stream, kept by reference
+         */
+        explicit SegmentReader(std::istream &in);
+
+        /**
+         * @brief Check whether the stream starts with a valid segment header
+         * @return true if valid
+         */
+        bool isValid() const;
+
+        /**
+         * @brief Read the next frame
+         * @param frame Receives the frame
+         * @return false at the end of the segment or on a corrupt record
+         */
+        bool read(cv::Mat &frame);
+
+    private:
+        std::istream &in_;
+        bool valid_{false};
+    };
+
+    /**
+     * @brief Feeds segments to the final video writer in order
+     */
+    class SegmentStitcher
+    {
+    public:
+        /**
+         * @brief Create a stitcher
+         * @param writer Opened output writer (must outlive the stitcher)
+         */
+        explicit SegmentStitcher(cv::VideoWriter &writer);
+
+        /**
+         * @brief Append every frame of a segment file to the output
+         * @param segment_path Path to the segment file
+         * @return false if the file is missing or not a segment
+         */
+        bool append(const std::string &segment_path);
+
+        /**
+         * @brief Append every frame of an in-memory segment to the output
+         * @param segment Segment bytes
+         * @return false if the bytes are not a segment
+         */
+        bool appendBuffer(const std::string &segment);
+
+        /**
+         * @brief Get the number of frames written so far
+         * @return Frame count
+         */
+        int getFramesWritten() const;
+
+    private:
+        cv::VideoWriter &writer_;
+        int frames_written_{0};
+
+        /**
+         * @brief Copy all frames of a segment stream to the writer
+         * @param in Segment stream
+         * @return false if the stream is not a segment
+         */
+        bool appendStream(std::istream &in);
+    };
+
+} // namespace video_styler::video_processor
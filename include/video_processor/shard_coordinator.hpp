@@ -0,0 +1,186 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "video_processor/shard_protocol.hpp"
+#include "video_processor/video_loader.hpp"
+
+namespace video_styler::video_processor
+{
+
+    /**
+     * @brief Address of a `video_styler --worker` process
+     */
+    struct WorkerEndpoint
+    {
+        std::string host;
+        unsigned short port{0};
+
+        /**
+         * @brief Format as host:port
+         * @return Endpoint string
+         */
+        std::string toString() const;
+    };
+
+    /**
+     * @brief Chunking and fault-tolerance settings of a sharded run
+     */
+    struct ShardSettings
+    {
+        int initial_chunk_frames{24};     // Chunk size before a worker's throughput is known
+        double target_chunk_seconds{10.0}; // Work handed out per request once it is known
+        int min_chunk_frames{8};
+        int max_chunk_frames{512};
+        int max_attempts{3};               // Attempts per chunk before the run fails
+        int max_worker_failures{2};        // Consecutive failures before a worker is dropped
+        std::chrono::milliseconds timeout{std::chrono::minutes(5)}; // Per connect/send/receive
+        std::uint64_t max_message_bytes{kDefaultMaxMessageBytes};  // Chunks are sized to fit requests and replies
+    };
+
+    /**
+     * @brief Per-worker outcome of a sharded run
+     */
+    struct WorkerReport
+    {
+        WorkerEndpoint endpoint;
+        int chunks{0};
+        int frames{0};
+        int failures{0};
+        double frames_per_second{0.0}; // Last smoothed throughput estimate
+        bool dropped{false};
+    };
+
+    /**
+     * @brief Outcome of a sharded run
+     */
+    struct ShardReport
+    {
+        bool success{false};
+        std::string error;
+        int frames{0};
+        int chunks{0};
+        int retries{0};
+        double wall_seconds{0.0};
+        std::vector<WorkerReport> workers;
+    };
+
+    /**
+     * @brief Coordinator of sharded rendering
+     *
+     * Decodes the input once and cuts it into frame ranges that are sent,
+     * losslessly encoded, to worker processes over TCP. Each worker pulls its
+     * next chunk as soon as it returns one, and chunks are sized from the
+     * worker's measured throughput so fast nodes get more work. A chunk whose
+     * worker fails or times out is queued again for another worker. The
+     * stylized segments are stitched into the output in frame order.
+     */
+    class ShardCoordinator
+    {
+    public:
+        /**
+         * @brief Create a coordinator
+         * @param workers Worker endpoints (one connection each)
+         * @param settings Chunking and retry settings
+         */
+        explicit ShardCoordinator(std::vector<WorkerEndpoint> workers, ShardSettings settings = {});
+
+        /**
+         * @brief Stylize a video on the workers
+         * @param input_path Input video
+         * @param style_path Style image (sent to every worker)
+         * @param output_path Output video
+         * @param render Style transfer settings
+         * @return Report of the run
+         */
+        ShardReport run(const std::string &input_path, const std::string &style_path,
+                        const std::string &output_path, const RenderSettings &render);
+
+        /**
+         * @brief Parse a comma-separated list of host:port endpoints
+         * @param list Endpoint list, e.g. "node1:7800,127.0.0.1:7801"
+         * @param workers Receives the endpoints
+         * @return false if any entry is malformed or the list is empty
+         */
+        static bool parseWorkers(const std::string &list, std::vector<WorkerEndpoint> &workers);
+
+    private:
+        struct Chunk
+        {
+            int index{0};
+            int first_frame{0};
+            int frame_count{0};
+            int attempts{0};
+            std::string segment; // Losslessly encoded input frames
+        };
+
+        std::vector<WorkerEndpoint> workers_;
+        ShardSettings settings_;
+
+        // State of the current run, shared by the per-worker threads
+        std::mutex decode_mutex_;
+        VideoLoader loader_;
+        int next_frame_{0};
+        int next_chunk_{0};
+        bool input_exhausted_{false};
+        int max_message_frames_{0}; // Most frames a request can carry within max_message_bytes
+
+        std::mutex state_mutex_;
+        std::condition_variable state_cv_;
+        std::deque<Chunk> retry_queue_;
+        std::map<int, std::string> finished_; // Chunk index -> stylized segment file
+        int outstanding_{0};                  // Chunks handed out and not yet finished
+        int live_workers_{0};
+        int retries_{0};
+        std::string failure_;
+
+        /**
+         * @brief Serve one worker until the input is done or the worker is dropped
+         * @param report Per-worker report, updated as chunks complete
+         * @param render_request Settings and style parts of every request
+         * @param shard_dir Directory for stylized segments
+         */
+        void workerLoop(WorkerReport &report, const ShardMessage &render_request, const std::string &shard_dir);
+
+        /**
+         * @brief Get the next chunk for a worker: a retry, or freshly decoded frames
+         * @param frames_per_second Worker's throughput estimate (0: unknown)
+         * @param chunk Receives the chunk
+         * @return false once no work is left or the run failed
+         */
+        bool takeChunk(double frames_per_second, Chunk &chunk);
+
+        /**
+         * @brief Decode the next frame range
+         * @param frames_per_second Worker's throughput estimate (0: unknown)
+         * @param live_workers Workers still taking chunks
+         * @param chunk Receives the chunk
+         * @param error Set if a frame cannot be encoded; the range is never sent short
+         * @return false if the input is exhausted or a frame cannot be encoded
+         */
+        bool decodeChunk(double frames_per_second, int live_workers, Chunk &chunk, std::string &error);
+
+        /**
+         * @brief Get the chunk size for a worker
+         *
+         * Targets a fixed amount of work per request at the worker's measured
+         * rate, and near the end of the input never hands one worker more than
+         * its share of the remaining frames.
+         *
+         * @param frames_per_second Worker's throughput estimate (0: unknown)
+         * @param live_workers Workers still taking chunks
+         * @return Frames to put in the next chunk
+         */
+        int chunkFrames(double frames_per_second, int live_workers) const;
+    };
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+namespace video_styler::video_processor
+{
+
+    /**
+     * @brief Default cap on the payload of one received message (all parts together)
+     *
+     * A header announcing more is rejected before anything is allocated, so a
+     * stray or hostile peer cannot make a worker reserve gigabytes.
+     */
+    constexpr std::uint64_t kDefaultMaxMessageBytes = std::uint64_t{512} << 20;
+
+    /**
+     * @brief Kind of message exchanged between coordinator and workers
+     */
+    enum class ShardMessageType : std::uint32_t
+    {
+        RENDER = 1,  // Coordinator -> worker: [settings JSON, style image bytes, input segment]
+        SEGMENT = 2, // Worker -> coordinator: [stats JSON, stylized segment]
+        FAILURE = 3  // Worker -> coordinator: [error text]
+    };
+
+    /**
+     * @brief A typed message made of opaque byte parts
+     */
+    struct ShardMessage
+    {
+        ShardMessageType type{ShardMessageType::FAILURE};
+        std::vector<std::string> parts;
+    };
+
+    /**
+     * @brief Style transfer settings a worker renders a chunk with
+     */
+    struct RenderSettings
+    {
+        std::string mode{"fast"};
+        int iterations{500};
+        double style_weight{1e6};
+        double content_weight{1.0};
+        std::string precision{"fp32"}; // Intermediate tensor storage (see style_transfer::TensorPrecision)
+
+        /**
+         * @brief Serialize to JSON
+         * @return JSON text
+         */
+        std::string toJson() const;
+
+        /**
+         * @brief Parse settings written by toJson()
+         * @param json JSON text
+         * @param settings Receives the settings
+         * @return false on malformed input
+         */
+        static bool fromJson(const std::string &json, RenderSettings &settings);
+    };
+
+    /**
+     * @brief Blocking TCP connection carrying ShardMessages, with an optional per-operation timeout
+     *
+     * Wire format, all integers little endian: u32 type, u32 part count, then
+     * per part a u64 length and the bytes.
+     */
+    class ShardConnection
+    {
+    public:
+        /**
+         * @brief Create an unconnected connection
+         * @param timeout Limit for each connect/send/receive (0: wait forever)
+         * @param max_message_bytes Largest payload receive() accepts, summed over all parts
+         */
+        explicit ShardConnection(std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+                                 std::uint64_t max_message_bytes = kDefaultMaxMessageBytes);
+
+        // Non-copyable, non-movable (owns its io_context)
+        ShardConnection(const ShardConnection &) = delete;
+        ShardConnection &operator=(const ShardConnection &) = delete;
+
+        /**
+         * @brief Connect to a listening worker
+         * @param host Host name or address
+         * @param port TCP port
+         * @return true if connected
+         */
+        bool connect(const std::string &host, unsigned short port);
+
+        /**
+         * @brief Send a message
+         * @param message Message to send
+         * @return false on error or timeout (the connection is closed)
+         */
+        bool send(const ShardMessage &message);
+
+        /**
+         * @brief Receive the next message
+         * @param message Receives the message
+         * @return false on error, timeout, a closed peer or an oversized message (the connection is closed)
+         */
+        bool receive(ShardMessage &message);
+
+        /**
+         * @brief Close the socket
+         */
+        void close();
+
+        /**
+         * @brief Check whether the socket is open
+         * @return true if open
+         */
+        bool isOpen() const;
+
+        /**
+         * @brief Access the socket, e.g. to accept into it
+         * @return Socket bound to this connection's io_context
+         */
+        boost::asio::ip::tcp::socket &socket();
+
+    private:
+        boost::asio::io_context io_;
+        boost::asio::ip::tcp::socket socket_;
+        std::chrono::milliseconds timeout_;
+        std::uint64_t max_message_bytes_;
+
+        /**
+         * @brief Read exactly size bytes
+         * @param data Destination
+         * @param size Byte count
+         * @return true if successful
+         */
+        bool readExactly(void *data, std::size_t size);
+
+        /**
+         * @brief Run the pending operation to completion or until the timeout
+         * @param result Operation result, left at would_block while pending
+         * @return true if the operation succeeded in time
+         */
+        bool wait(boost::system::error_code &result);
+    };
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include "video_processor/shard_protocol.hpp"
+#include "style_transfer/neural_style_transfer.hpp"
+
+namespace video_styler::video_processor
+{
+
+    /**
+     * @brief Render node of sharded rendering (`video_styler --worker`)
+     *
+     * Accepts coordinator connections and stylizes every RENDER request's
+     * input segment, replying with the stylized segment. Frames travel inside
+     * the messages, so workers need no access to the coordinator's files.
+     * Connections are served one at a time; a coordinator keeps its
+     * connection open across chunks. TCP keepalive and an idle timeout drop
+     * a coordinator that vanished without closing its connection, so the
+     * worker is free for the coordinator that retries its chunks.
+     */
+    class ShardWorker
+    {
+    public:
+        ShardWorker();
+        ~ShardWorker();
+
+        // Non-copyable, non-movable (owns a listening socket)
+        ShardWorker(const ShardWorker &) = delete;
+        ShardWorker &operator=(const ShardWorker &) = delete;
+
+        /**
+         * @brief Start listening
+         *
+         * Requests are not authenticated, so binding anything but a loopback
+         * address is logged as a warning.
+         *
+         * @param address Local address to bind (e.g. 127.0.0.1, or 0.0.0.0 on a trusted network)
+         * @param port TCP port (0 picks a free one, see getPort())
+         * @return true if successful, false otherwise
+         */
+        bool listen(const std::string &address, unsigned short port);
+
+        /**
+         * @brief Limit the size of accepted requests
+         * @param bytes Largest request payload (style image plus input segment)
+         */
+        void setMaxMessageBytes(std::uint64_t bytes);
+
+        /**
+         * @brief Close a connection that sends nothing for this long
+         * @param timeout Limit for each receive and send (0: wait forever)
+         */
+        void setIdleTimeout(std::chrono::milliseconds timeout);
+
+        /**
+         * @brief Get the port the worker listens on
+         * @return Port, or 0 before listen()
+         */
+        unsigned short getPort() const;
+
+        /**
+         * @brief Serve coordinator connections
+         * @param max_connections Return after this many connections (0: serve forever)
+         * @return false if not listening or accepting failed
+         */
+        bool serve(std::size_t max_connections = 0);
+
+        /**
+         * @brief Render one request (exposed for testing)
+         * @param request RENDER message
+         * @param reply Receives a SEGMENT or FAILURE message
+         */
+        void handleRequest(const ShardMessage &request, ShardMessage &reply);
+
+        /**
+         * @brief Get the number of chunks rendered
+         * @return Chunk count
+         */
+        std::size_t getChunksRendered() const;
+
+    private:
+        boost::asio::io_context io_;
+        std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor_;
+
+        // The style is decoded once and reused while consecutive chunks share it
+        style_transfer::NeuralStyleTransfer style_transfer_;
+        std::size_t style_hash_{0};
+        std::size_t chunks_rendered_{0};
+        std::uint64_t max_message_bytes_{kDefaultMaxMessageBytes};
+        // Three times the coordinator's default per-operation timeout: longer than it idles between chunks
+        std::chrono::milliseconds idle_timeout_{std::chrono::minutes(15)};
+
+        /**
+         * @brief Handle requests on one connection until the peer closes it
+         * @param connection Accepted connection
+         */
+        void serveConnection(ShardConnection &connection);
+
+        /**
+         * @brief Render a request
+         * @param request RENDER message
+         * @param reply Receives the SEGMENT message
+         * @param error Receives the failure reason
+         * @return true if successful, false otherwise
+         */
+        bool render(const ShardMessage &request, ShardMessage &reply, std::string &error);
+    };
+
+} // namespace video_styler::video_processor
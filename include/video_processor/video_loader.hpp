@@ -28,6 +28,20 @@ namespace video_styler::video_processor
          */
         bool loadVideo(const std::string &filepath);
 
+        /**
+         * @brief Open a live camera by index
+         * @param index Camera index (0 is the default camera)
+         * @return true if successful, false otherwise
+         */
+        bool openCamera(int index);
+
+        /**
+         * @brief Open a live capture device such as a V4L2 (loopback) node
+         * @param device Device path, e.g. /dev/video0
+         * @return true if successful, false otherwise
+         */
+        bool openDevice(const std::string &device);
+
         /**
          * @brief Get the total number of frames in the video
          * @return Number of frames
@@ -58,6 +72,12 @@ namespace video_styler::video_processor
          */
         bool isLoaded() const;
 
+        /**
+         * @brief Check if the loaded source is a live camera or device
+         * @return true for live sources (which have no frame count)
+         */
+        bool isLive() const;
+
         /**
          * @brief Get the video capture object
          * @return Reference to the OpenCV VideoCapture object
@@ -67,10 +87,18 @@ namespace video_styler::video_processor
     private:
         cv::VideoCapture video_capture_;
         bool is_loaded_{false};
+        bool is_live_{false};
         int frame_count_{0};
         double fps_{0.0};
         int width_{0};
         int height_{0};
+
+        /**
+         * @brief Read the stream properties after a successful open
+         * @param live Whether the source is a live device
+         * @return true if the capture is open
+         */
+        bool readProperties(bool live);
     };
 
 } // namespace video_styler::video_processor
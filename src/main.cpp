@@ -1,23 +1,587 @@
 #include <iostream>
 #include <string>
 #include <filesystem>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <csignal>
+#include <optional>
+#include <algorithm>
+#include <vector>
 #include <boost/program_options.hpp>
 #include <opencv2/opencv.hpp>
 
 #include "video_processor/video_loader.hpp"
+#include "video_processor/batch_processor.hpp"
+#include "video_processor/realtime_controller.hpp"
+#include "video_processor/live_capture.hpp"
+#include "video_processor/frame_dedupe_cache.hpp"
+#include "video_processor/region_mask.hpp"
+#include "video_processor/shard_coordinator.hpp"
+#include "video_processor/shard_worker.hpp"
+#include "video_processor/render_checkpoint.hpp"
+#include "video_processor/decode_ahead.hpp"
 #include "style_transfer/neural_style_transfer.hpp"
+#include "style_transfer/pixel_kernels.hpp"
 #include "utils/logger.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/thread_budget.hpp"
+#include "utils/cpu_features.hpp"
+#include "utils/memory_budget.hpp"
 
 namespace po = boost::program_options;
 namespace fs = std::filesystem;
 
+namespace
+{
+
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    // Frames the single-node loop decodes ahead of stylization (the memory budget may allow fewer)
+    constexpr std::size_t kDecodeAheadFrames = 4;
+
+    // Set from the SIGINT (and, when checkpointing, SIGTERM) handler to end the run cleanly
+    std::atomic<bool> stop_requested{false};
+
+    void handleInterrupt(int)
+    {
+        stop_requested = true;
+    }
+
+    /**
+     * @brief Build the process thread budget from the command line and apply it
+     * @param vm Parsed options
+     * @param pipeline_workers Parallel pipeline workers the mode needs (0: as many as fit)
+     * @return Applied budget
+     */
+    video_styler::utils::ThreadBudget applyThreadBudget(const po::variables_map &vm, int pipeline_workers)
+    {
+        auto logger = video_styler::utils::Logger::getInstance();
+
+        video_styler::utils::ThreadBudget budget(vm["threads"].as<int>(), vm["intra-op-threads"].as<int>(),
+                                                 pipeline_workers);
+        if (vm.count("numa-node") && !budget.restrictToNumaNode(vm["numa-node"].as<int>()))
+        {
+            logger->warning("NUMA node " + std::to_string(vm["numa-node"].as<int>()) +
+                            " is not usable; using all allowed CPUs");
+        }
+        budget.setPinning(vm.count("pin-threads") > 0);
+        if (!budget.apply())
+        {
+            logger->warning("Failed to restrict the process to NUMA node " + std::to_string(vm["numa-node"].as<int>()));
+        }
+
+        logger->info("Thread budget: " + budget.describe());
+        return budget;
+    }
+
+    /**
+     * @brief Collect the style transfer options of a run that does not stylize in-process frame by frame
+     * @param vm Parsed options
+     * @param render Receives the settings
+     * @return false (after logging) if the mode or precision is unknown
+     */
+    bool parseRenderSettings(const po::variables_map &vm, video_styler::video_processor::RenderSettings &render)
+    {
+        auto logger = video_styler::utils::Logger::getInstance();
+
+        render.mode = vm["mode"].as<std::string>();
+        render.iterations = vm["iterations"].as<int>();
+        render.style_weight = vm["style-weight"].as<double>();
+        render.content_weight = vm["content-weight"].as<double>();
+        render.precision = vm["tensor-precision"].as<std::string>();
+        if (render.mode != "fast" && render.mode != "optimize")
+        {
+            logger->error("Unknown mode: " + render.mode + " (expected fast or optimize)");
+            return false;
+        }
+        video_styler::style_transfer::TensorPrecision precision = video_styler::style_transfer::TensorPrecision::FP32;
+        if (!video_styler::style_transfer::parseTensorPrecision(render.precision, precision))
+        {
+            logger->error("Unknown tensor precision: " + render.precision + " (expected fp32, fp16 or bf16)");
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Run every job of a batch manifest on one shared thread pool
+     * @param manifest_path Path to the JSON manifest
+     * @param segment_frames Frames per scheduled stylization task
+     * @param render Mode and optimizer settings every job is stylized with
+     * @param budget Thread budget sizing and pinning the pool
+     * @param dedupe_capacity Frames cached per segment for deduplication (0 disables)
+     * @param dedupe_tolerance Maximum differing perceptual-hash bits for a repeat
+     * @param memory_budget Budget decoded segments are held within
+     * @return Process exit code
+     */
+    int runManifest(const std::string &manifest_path, int segment_frames,
+                    const video_styler::video_processor::RenderSettings &render,
+                    const video_styler::utils::ThreadBudget &budget,
+                    std::size_t dedupe_capacity, int dedupe_tolerance,
+                    video_styler::utils::MemoryBudget &memory_budget)
+    {
+        auto logger = video_styler::utils::Logger::getInstance();
+
+        std::vector<video_styler::video_processor::BatchJob> jobs;
+        if (!video_styler::video_processor::BatchProcessor::loadManifest(manifest_path, jobs))
+        {
+            logger->error("Failed to load manifest: " + manifest_path);
+            return 1;
+        }
+
+        video_styler::utils::ThreadPool pool(budget.getPipelineWorkers(), [&budget](std::size_t worker_index)
+                                             { budget.pinCurrentThread(worker_index); });
+        logger->info("Batch manifest: " + std::to_string(jobs.size()) + " jobs on " +
+                     std::to_string(pool.size()) + " worker threads");
+
+        video_styler::video_processor::BatchProcessor processor(pool, segment_frames);
+        if (!processor.setRenderSettings(render))
+        {
+            logger->error("Invalid render settings for the batch");
+            return 1;
+        }
+        if (render.mode == "optimize")
+        {
+            logger->info("Optimize mode: each job's segments are stylized in order to keep warm starts");
+        }
+        processor.setDedupe(dedupe_capacity, dedupe_tolerance);
+        processor.setMemoryBudget(&memory_budget);
+        const auto report = processor.run(jobs);
+
+        logger->info("Batch summary:");
+        for (const auto &job : report.jobs)
+        {
+            std::string line = "  - [" + video_styler::video_processor::jobStatusToString(job.status) + "] " +
+                               job.job.input_path + " -> " + job.job.output_path + ": " +
+                               std::to_string(job.frames_processed) + " frames in " +
+                               std::to_string(job.seconds) + " s";
+            if (dedupe_capacity > 0)
+            {
+                line += ", " + std::to_string(job.frames_reused) + " reused";
+            }
+            if (!job.error.empty())
+            {
+                line += " (" + job.error + ")";
+            }
+            logger->info(line);
+        }
+        logger->info("  - Jobs completed: " + std::to_string(report.completedCount()) + "/" +
+                     std::to_string(report.jobs.size()));
+        logger->info("  - Total frames: " + std::to_string(report.total_frames));
+        logger->info("  - Wall time: " + std::to_string(report.wall_seconds) + " s");
+        logger->info("  - Throughput: " + std::to_string(report.throughput()) + " fps");
+        logger->info("  - Tasks stolen: " + std::to_string(report.steals));
+        logger->info("  - Memory: " + memory_budget.describe());
+
+        return report.completedCount() == report.jobs.size() ? 0 : 1;
+    }
+
+    /**
+     * @brief Serve sharded render requests until killed
+     * @param listen Address and port to listen on, as host:port
+     * @param memory_budget Budget that bounds the size of accepted requests
+     * @return Process exit code
+     */
+    int runWorker(const std::string &listen, const video_styler::utils::MemoryBudget &memory_budget)
+    {
+        auto logger = video_styler::utils::Logger::getInstance();
+
+        const auto colon = listen.rfind(':');
+        int port = -1;
+        try
+        {
+            port = colon == std::string::npos ? -1 : std::stoi(listen.substr(colon + 1));
+        }
+        catch (const std::exception &)
+        {
+        }
+        if (port < 0 || port > 65535)
+        {
+            logger->error("Invalid --listen (expected address:port): " + listen);
+            return 1;
+        }
+
+        video_styler::video_processor::ShardWorker worker;
+        if (memory_budget.isLimited())
+        {
+            // A request and its reply are held at once
+            worker.setMaxMessageBytes(std::max<std::size_t>(1, memory_budget.getCapacity() / 2));
+        }
+        if (!worker.listen(listen.substr(0, colon), static_cast<unsigned short>(port)))
+        {
+            return 1;
+        }
+        logger->info("Worker listening on " + listen.substr(0, colon) + ":" + std::to_string(worker.getPort()));
+        return worker.serve() ? 0 : 1;
+    }
+
+    /**
+     * @brief Stylize one video on remote workers and stitch the result
+     * @param vm Parsed options
+     * @param input_path Input video
+     * @param style_path Style image
+     * @param output_path Output video
+     * @param memory_budget Budget that bounds the chunks held per worker
+     * @return Process exit code
+     */
+    int runSharded(const po::variables_map &vm, const std::string &input_path, const std::string &style_path,
+                   const std::string &output_path, const video_styler::utils::MemoryBudget &memory_budget)
+    {
+        auto logger = video_styler::utils::Logger::getInstance();
+
+        std::vector<video_styler::video_processor::WorkerEndpoint> workers;
+        if (!video_styler::video_processor::ShardCoordinator::parseWorkers(vm["workers"].as<std::string>(), workers))
+        {
+            logger->error("Invalid --workers (expected host:port,...): " + vm["workers"].as<std::string>());
+            return 1;
+        }
+
+        video_styler::video_processor::RenderSettings render;
+        if (!parseRenderSettings(vm, render))
+        {
+            return 1;
+        }
+        if (render.mode == "optimize")
+        {
+            logger->warning("Optimize mode warm-starts within each chunk only; chunk boundaries may differ "
+                            "slightly from a single-node run");
+        }
+
+        video_styler::video_processor::ShardSettings settings;
+        settings.target_chunk_seconds = vm["shard-chunk-seconds"].as<double>();
+        if (memory_budget.isLimited())
+        {
+            // The coordinator holds a request and a returned segment per worker, at most a raw frame each
+            video_styler::video_processor::VideoLoader probe;
+            const std::size_t frame_bytes =
+                probe.loadVideo(input_path) ? video_styler::utils::MemoryBudget::frameBytes(probe.getWidth(), probe.getHeight()) : 0;
+            if (frame_bytes > 0)
+            {
+                const std::size_t fit = memory_budget.getCapacity() / (2 * workers.size() * frame_bytes);
+                settings.max_chunk_frames = static_cast<int>(
+                    std::clamp<std::size_t>(fit, 1, static_cast<std::size_t>(settings.max_chunk_frames)));
+                settings.min_chunk_frames = std::min(settings.min_chunk_frames, settings.max_chunk_frames);
+                settings.initial_chunk_frames = std::min(settings.initial_chunk_frames, settings.max_chunk_frames);
+                logger->info("Memory budget limits chunks to " + std::to_string(settings.max_chunk_frames) + " frames");
+            }
+        }
+
+        video_styler::video_processor::ShardCoordinator coordinator(workers, settings);
+        const auto report = coordinator.run(input_path, style_path, output_path, render);
+
+        logger->info("Shard summary:");
+        for (const auto &worker : report.workers)
+        {
+            logger->info("  - " + worker.endpoint.toString() + ": " + std::to_string(worker.chunks) + " chunks, " +
+                         std::to_string(worker.frames) + " frames, " + std::to_string(worker.frames_per_second) +
+                         " fps, " + std::to_string(worker.failures) + " failures" +
+                         (worker.dropped ? " (dropped)" : ""));
+        }
+        logger->info("  - Chunks: " + std::to_string(report.chunks) + ", retries: " + std::to_string(report.retries));
+        logger->info("  - Total frames: " + std::to_string(report.frames));
+        logger->info("  - Wall time: " + std::to_string(report.wall_seconds) + " s");
+        logger->info("  - Memory: peak RSS " +
+                     std::to_string(video_styler::utils::MemoryBudget::peakResidentBytes() / (1024 * 1024)) + " MB");
+
+        if (!report.success)
+        {
+            logger->error("Sharded run failed: " + report.error);
+            return 1;
+        }
+        logger->info("Output saved to: " + output_path);
+        return 0;
+    }
+
+    /**
+     * @brief Fingerprint the input, style and every option that changes the output frames
+     * @param vm Parsed options
+     * @param input_path Input video
+     * @param style_path Style image
+     * @return Key a checkpoint must match to be resumed
+     */
+    std::string checkpointJobKey(const po::variables_map &vm, const std::string &input_path,
+                                 const std::string &style_path)
+    {
+        auto describeFile = [](const std::string &path)
+        {
+            std::error_code ec;
+            const auto size = fs::file_size(path, ec);
+            const auto modified = fs::last_write_time(path, ec).time_since_epoch().count();
+            return path + "@" + std::to_string(size) + ":" + std::to_string(modified);
+        };
+
+        std::string key = describeFile(input_path) + "|" + describeFile(style_path) + "|" +
+                          vm["mode"].as<std::string>() + "|" + std::to_string(vm["iterations"].as<int>()) + "|" +
+                          std::to_string(vm["style-weight"].as<double>()) + "|" +
+                          std::to_string(vm["content-weight"].as<double>()) + "|" +
+                          vm["tensor-precision"].as<std::string>();
+        for (const char *option : {"roi", "mask", "matte"})
+        {
+            if (vm.count(option))
+            {
+                key += std::string("|") + option + "=" + vm[option].as<std::string>();
+            }
+        }
+        if (vm.count("dedupe"))
+        {
+            key += "|dedupe=" + std::to_string(vm["dedupe-tolerance"].as<int>());
+        }
+        return key;
+    }
+
+    /**
+     * @brief Stylize a frame at the working resolution of a quality level
+     * @param style_transfer Style transfer with a loaded style
+     * @param frame Source frame
+     * @param level Quality level to apply
+     * @param stylized Receives the stylized frame at source resolution
+     * @return true if successful, false otherwise
+     */
+    bool stylizeAtLevel(video_styler::style_transfer::NeuralStyleTransfer &style_transfer,
+                        const cv::Mat &frame,
+                        const video_styler::video_processor::QualityLevel &level,
+                        cv::Mat &stylized)
+    {
+        style_transfer.setIterations(level.iterations);
+        if (level.scale >= 1.0)
+        {
+            return style_transfer.applyStyleTransfer(frame, stylized);
+        }
+
+        cv::Mat working;
+        cv::Mat stylized_working;
+        cv::resize(frame, working, cv::Size(), level.scale, level.scale, cv::INTER_AREA);
+        if (!style_transfer.applyStyleTransfer(working, stylized_working))
+        {
+            return false;
+        }
+        cv::resize(stylized_working, stylized, frame.size(), 0, 0, cv::INTER_LINEAR);
+        return true;
+    }
+
+    /**
+     * @brief Log a realtime quality change and export it if requested
+     * @param controller Controller that just changed level
+     * @param status_path File the controller state is exported to (empty disables)
+     */
+    void reportQualityChange(const video_styler::video_processor::RealtimeController &controller,
+                             const std::string &status_path)
+    {
+        video_styler::utils::Logger::getInstance()->info("Realtime quality changed: " + controller.describe());
+        if (!status_path.empty())
+        {
+            controller.writeStatus(status_path);
+        }
+    }
+
+    /**
+     * @brief Stylize a video paced to its frame rate, trading quality for speed
+     * @param capture Opened source
+     * @param style_transfer Style transfer with a loaded style
+     * @param writer Opened output writer
+     * @param target_fps Frame rate to sustain
+     * @param latency_budget_ms Per-frame latency budget (0 uses one frame interval)
+     * @param iterations Optimizer iterations per frame at the best quality level
+     * @param status_path File the controller state is exported to (empty disables)
+     * @return Process exit code
+     */
+    int runRealtime(cv::VideoCapture &capture,
+                    video_styler::style_transfer::NeuralStyleTransfer &style_transfer,
+                    cv::VideoWriter &writer,
+                    double target_fps,
+                    double latency_budget_ms,
+                    int iterations,
+                    const std::string &status_path)
+    {
+        auto logger = video_styler::utils::Logger::getInstance();
+        video_styler::video_processor::RealtimeController controller(target_fps, latency_budget_ms);
+        controller.setLevels(video_styler::video_processor::RealtimeController::defaultLevels(iterations));
+        logger->info("Realtime mode: target " + std::to_string(target_fps) + " fps, " + controller.describe());
+
+        const double frame_interval_ms = 1000.0 / target_fps;
+        const auto start_time = Clock::now();
+
+        cv::Mat frame;
+        cv::Mat stylized;
+        int frame_index = 0;
+        while (capture.read(frame))
+        {
+            // Each source frame is due at its presentation time on the source clock
+            const double deadline_ms = frame_index++ * frame_interval_ms;
+            const double now_ms = Milliseconds(Clock::now() - start_time).count();
+            if (now_ms < deadline_ms)
+            {
+                std::this_thread::sleep_for(Milliseconds(deadline_ms - now_ms));
+            }
+            else if (controller.shouldDrop(now_ms - deadline_ms))
+            {
+                // Repeat the last output so the result keeps the source timing
+                if (!stylized.empty())
+                {
+                    writer.write(stylized);
+                }
+                continue;
+            }
+
+            const auto frame_start = Clock::now();
+            if (!stylizeAtLevel(style_transfer, frame, controller.getLevel(), stylized))
+            {
+                logger->error("Style transfer failed at frame " + std::to_string(frame_index - 1));
+                return 1;
+            }
+            writer.write(stylized);
+
+            if (controller.recordLatency(Milliseconds(Clock::now() - frame_start).count()))
+            {
+                reportQualityChange(controller, status_path);
+            }
+        }
+
+        logger->info("Realtime summary: " + controller.describe());
+        if (!status_path.empty() && !controller.writeStatus(status_path))
+        {
+            logger->warning("Failed to write realtime status: " + status_path);
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Stylize a live source, always working on the freshest frame
+     * @param source Opened camera or device
+     * @param style_transfer Style transfer with a loaded style
+     * @param writer Opened output writer
+     * @param target_fps Frame rate the quality controller aims for
+     * @param latency_budget_ms Per-frame latency budget (0 uses one frame interval)
+     * @param iterations Optimizer iterations per frame at the best quality level
+     * @param status_path File the controller state is exported to (empty disables)
+     * @param max_frames Stop after this many output frames (0 runs until interrupted)
+     * @return Process exit code
+     */
+    int runLive(cv::VideoCapture &source,
+                video_styler::style_transfer::NeuralStyleTransfer &style_transfer,
+                cv::VideoWriter &writer,
+                double target_fps,
+                double latency_budget_ms,
+                int iterations,
+                const std::string &status_path,
+                int max_frames)
+    {
+        auto logger = video_styler::utils::Logger::getInstance();
+        video_styler::video_processor::RealtimeController controller(target_fps, latency_budget_ms);
+        controller.setLevels(video_styler::video_processor::RealtimeController::defaultLevels(iterations));
+        logger->info("Live mode: target " + std::to_string(target_fps) + " fps, press Ctrl+C to stop");
+
+        video_styler::video_processor::LiveCapture capture(source);
+        capture.start();
+
+        video_styler::video_processor::CapturedFrame captured;
+        cv::Mat stylized;
+        int frame_count = 0;
+        double total_latency_ms = 0.0;
+        double max_latency_ms = 0.0;
+        while (!stop_requested && (max_frames <= 0 || frame_count < max_frames))
+        {
+            if (!capture.waitForFrame(captured, std::chrono::milliseconds(1000)))
+            {
+                if (capture.isFinished())
+                {
+                    break;
+                }
+                continue;
+            }
+
+            const auto frame_start = Clock::now();
+            if (!stylizeAtLevel(style_transfer, captured.image, controller.getLevel(), stylized))
+            {
+                logger->error("Style transfer failed at frame " + std::to_string(captured.sequence));
+                capture.stop();
+                return 1;
+            }
+            writer.write(stylized);
+            ++frame_count;
+
+            // Glass-to-glass: from the grab on the capture thread to the frame leaving the pipeline
+            const auto done = Clock::now();
+            const double latency_ms = Milliseconds(done - captured.capture_time).count();
+            total_latency_ms += latency_ms;
+            max_latency_ms = std::max(max_latency_ms, latency_ms);
+            logger->debug("Frame " + std::to_string(captured.sequence) + ": glass-to-glass " +
+                          std::to_string(latency_ms) + " ms");
+
+            if (controller.recordLatency(Milliseconds(done - frame_start).count()))
+            {
+                reportQualityChange(controller, status_path);
+            }
+        }
+        capture.stop();
+
+        logger->info("Live summary:");
+        logger->info("  - Frames captured: " + std::to_string(capture.getCapturedFrames()));
+        logger->info("  - Frames stylized: " + std::to_string(frame_count));
+        logger->info("  - Frames dropped (stale): " + std::to_string(capture.getDroppedFrames()));
+        if (frame_count > 0)
+        {
+            logger->info("  - Glass-to-glass latency: avg " + std::to_string(total_latency_ms / frame_count) +
+                         " ms, max " + std::to_string(max_latency_ms) + " ms");
+        }
+        logger->info("  - Quality: " + controller.describe());
+        if (!status_path.empty() && !controller.writeStatus(status_path))
+        {
+            logger->warning("Failed to write realtime status: " + status_path);
+        }
+        return 0;
+    }
+
+} // namespace
+
 int main(int argc, char *argv[])
 {
     try
     {
         // Program options
         po::options_description desc("Video Styler - Neural Style Transfer for Videos");
-        desc.add_options()("help,h", "Show help message")("input,i", po::value<std::string>(), "Input video file path")("output,o", po::value<std::string>(), "Output video file path")("style,s", po::value<std::string>(), "Style image file path")("verbose,v", "Enable verbose logging")("version", "Show version information");
+        desc.add_options()
+            ("help,h", "Show help message")
+            ("input,i", po::value<std::string>(), "Input video file path")
+            ("camera", po::value<int>(), "Live input from a camera index instead of a file")
+            ("device", po::value<std::string>(), "Live input from a capture device (e.g. /dev/video0, v4l2loopback)")
+            ("max-frames", po::value<int>()->default_value(0), "Stop live capture after this many frames (0: until Ctrl+C)")
+            ("output,o", po::value<std::string>(), "Output video file path")
+            ("style,s", po::value<std::string>(), "Style image file path")
+            ("mode", po::value<std::string>()->default_value("fast"), "Style transfer mode: fast (color LUT fitted to the style) or optimize")
+            ("export-lut", po::value<std::string>(), "Write the style's fitted color LUT as a .cube file (alone with --style, or alongside a run)")
+            ("iterations", po::value<int>()->default_value(500), "Maximum optimizer iterations per frame (optimize mode)")
+            ("style-weight", po::value<double>()->default_value(1e6), "Weight of the style loss (optimize mode)")
+            ("content-weight", po::value<double>()->default_value(1.0), "Weight of the content loss (optimize mode)")
+            ("tensor-precision", po::value<std::string>()->default_value("fp32"), "Storage of intermediate tensors in optimize mode: fp32, fp16 or bf16")
+            ("manifest,m", po::value<std::string>(), "Batch manifest (JSON) of input/style/output jobs")
+            ("segment-frames", po::value<int>()->default_value(32), "Frames per scheduled task in batch mode")
+            ("realtime", "Keep up with the source frame rate, lowering quality and dropping late frames")
+            ("target-fps", po::value<double>(), "Frame rate to sustain in realtime mode (default: source FPS)")
+            ("latency-budget", po::value<double>()->default_value(0.0), "Per-frame latency budget in ms for realtime mode (default: one frame interval)")
+            ("realtime-status", po::value<std::string>(), "Export the current realtime quality level to this JSON file")
+            ("threads", po::value<int>()->default_value(0), "Total CPU threads for pipeline, OpenCV and Eigen (0: all allowed CPUs)")
+            ("intra-op-threads", po::value<int>()->default_value(0), "Threads per OpenCV/Eigen operation (0: derived from the mode)")
+            ("pin-threads", "Pin pipeline workers to dedicated CPUs")
+            ("numa-node", po::value<int>(), "Restrict all threads to the CPUs of one NUMA node")
+            ("cpu-isa", po::value<std::string>()->default_value("auto"), "Highest SIMD kernel set to use: auto, avx512, avx2, sse4.2 or generic")
+            ("roi", po::value<std::string>(), "Only stylize this rectangle, given as x,y,width,height")
+            ("mask", po::value<std::string>(), "Only stylize where this grayscale mask image is set (scaled to the frame)")
+            ("matte", po::value<std::string>(), "Only stylize where a matte video, read frame by frame with the input, is set")
+            ("dedupe", "Reuse the stylized output of repeated frames (perceptual-hash cache)")
+            ("dedupe-tolerance", po::value<int>()->default_value(0), "Hash bits (of 64) two frames may differ in and still count as repeats")
+            ("dedupe-cache-size", po::value<int>()->default_value(16), "Stylized frames kept by the dedupe cache")
+            ("worker", "Run as a render worker for sharded runs (see --listen)")
+            ("listen", po::value<std::string>()->default_value("127.0.0.1:7800"), "Address and port a worker listens on (requests are not authenticated; use 0.0.0.0 only on a trusted network)")
+            ("workers", po::value<std::string>(), "Render the input on these workers (host:port,...) and stitch the result")
+            ("shard-chunk-seconds", po::value<double>()->default_value(10.0), "Work handed to a worker per request, in seconds at its measured rate")
+            ("max-memory", po::value<std::string>(), "Cap on decoded frame buffers, e.g. 2G or 512M; decoding waits while it is reached")
+            ("checkpoint-interval", po::value<int>()->default_value(300), "Frames between checkpoints in <output>.checkpoint/ (giving it enables checkpointing)")
+            ("resume", "Continue an interrupted run from its last checkpoint (enables checkpointing; segments are lossless and take a few MB of disk per 1080p frame)")
+            ("verbose,v", "Enable verbose logging")
+            ("version", "Show version information");
 
         po::variables_map vm;
         po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -46,20 +610,90 @@ int main(int argc, char *argv[])
 
         logger->info("Video Styler starting...");
 
+        // Pick the SIMD kernels once, before any worker starts
+        video_styler::utils::CpuIsa max_isa = video_styler::utils::CpuIsa::AVX512;
+        const std::string &isa_name = vm["cpu-isa"].as<std::string>();
+        if (isa_name != "auto" && !video_styler::utils::parseCpuIsa(isa_name, max_isa))
+        {
+            std::cerr << "Error: unknown --cpu-isa '" << isa_name << "'." << std::endl;
+            return 1;
+        }
+        const auto &kernels = video_styler::style_transfer::selectKernels(max_isa);
+        logger->info("Pixel kernels: " + video_styler::utils::cpuIsaToString(kernels.isa) + " (CPU supports " +
+                     video_styler::utils::cpuIsaToString(video_styler::utils::detectCpuIsa()) + ")");
+
+        std::size_t max_memory = 0;
+        if (vm.count("max-memory") && !video_styler::utils::MemoryBudget::parseSize(vm["max-memory"].as<std::string>(), max_memory))
+        {
+            std::cerr << "Error: invalid --max-memory '" << vm["max-memory"].as<std::string>() << "' (e.g. 2G, 512M)." << std::endl;
+            return 1;
+        }
+        // Tracks frame buffers even without a limit, so the peak can be reported
+        video_styler::utils::MemoryBudget memory_budget(max_memory);
+
+        if (vm.count("worker"))
+        {
+            // Requests are rendered one at a time: the whole budget goes to intra-op parallelism
+            const auto budget = applyThreadBudget(vm, 1);
+            budget.pinCurrentThread(0);
+            return runWorker(vm["listen"].as<std::string>(), memory_budget);
+        }
+
+        if (vm.count("manifest"))
+        {
+            video_styler::video_processor::RenderSettings render;
+            if (!parseRenderSettings(vm, render))
+            {
+                return 1;
+            }
+
+            // Many independent segments: as many pipeline workers as the budget allows
+            const auto budget = applyThreadBudget(vm, 0);
+            const std::size_t dedupe_capacity =
+                vm.count("dedupe") ? static_cast<std::size_t>(std::max(1, vm["dedupe-cache-size"].as<int>())) : 0;
+            return runManifest(vm["manifest"].as<std::string>(), vm["segment-frames"].as<int>(), render, budget,
+                               dedupe_capacity, vm["dedupe-tolerance"].as<int>(), memory_budget);
+        }
+
+        const bool live = vm.count("camera") || vm.count("device");
+
+        if (vm.count("export-lut"))
+        {
+            const std::string lut_path = vm["export-lut"].as<std::string>();
+            video_styler::style_transfer::NeuralStyleTransfer lut_source;
+            if (!vm.count("style") || !lut_source.loadStyleImage(vm["style"].as<std::string>()))
+            {
+                logger->error("--export-lut needs a readable --style image");
+                return 1;
+            }
+            if (!lut_source.exportColorLut(lut_path))
+            {
+                logger->error("Failed to write color LUT: " + lut_path);
+                return 1;
+            }
+            logger->info("Color LUT (" + std::to_string(lut_source.getColorLut().getSize()) + "^3) written to: " + lut_path);
+            if (!vm.count("input") && !live)
+            {
+                return 0;
+            }
+        }
+
         // Validate required arguments
-        if (!vm.count("input") || !vm.count("output") || !vm.count("style"))
+        if ((!vm.count("input") && !live) || !vm.count("output") || !vm.count("style"))
         {
-            std::cerr << "Error: input, output, and style arguments are required." << std::endl;
+            std::cerr << "Error: input (or --camera/--device), output, and style arguments (or --manifest) are required." << std::endl;
             std::cerr << "Use --help for more information." << std::endl;
             return 1;
         }
 
-        const std::string input_path = vm["input"].as<std::string>();
+        const std::string input_path = vm.count("camera")   ? "camera " + std::to_string(vm["camera"].as<int>())
+                                       : vm.count("device") ? vm["device"].as<std::string>()
+                                                            : vm["input"].as<std::string>();
         const std::string output_path = vm["output"].as<std::string>();
         const std::string style_path = vm["style"].as<std::string>();
 
         // Validate input files exist
-        if (!fs::exists(input_path))
+        if (!live && !fs::exists(input_path))
         {
             logger->error("Input video file does not exist: " + input_path);
             return 1;
@@ -71,6 +705,37 @@ int main(int argc, char *argv[])
             return 1;
         }
 
+        const bool checkpointing = vm.count("resume") || !vm["checkpoint-interval"].defaulted();
+        if (checkpointing && (live || vm.count("realtime")))
+        {
+            logger->error("Checkpointing needs a file input and is not available in realtime mode");
+            return 1;
+        }
+
+        if (vm.count("workers"))
+        {
+            if (live)
+            {
+                logger->error("Sharded rendering needs a file input");
+                return 1;
+            }
+            if (vm.count("roi") || vm.count("mask") || vm.count("matte") || vm.count("dedupe"))
+            {
+                // Workers render whole frames of independent chunks
+                logger->error("--roi, --mask, --matte and --dedupe are not supported for sharded runs");
+                return 1;
+            }
+            if (checkpointing)
+            {
+                logger->warning("Checkpointing is ignored for sharded runs; failed chunks are retried instead");
+            }
+            return runSharded(vm, input_path, style_path, output_path, memory_budget);
+        }
+
+        // One frame at a time: the whole budget goes to intra-op parallelism
+        const auto budget = applyThreadBudget(vm, 1);
+        budget.pinCurrentThread(0);
+
         logger->info("Input video: " + input_path);
         logger->info("Output video: " + output_path);
         logger->info("Style image: " + style_path);
@@ -79,48 +744,259 @@ int main(int argc, char *argv[])
         auto video_loader = video_styler::video_processor::VideoLoader();
         auto style_transfer = video_styler::style_transfer::NeuralStyleTransfer();
 
+        const std::string mode = vm["mode"].as<std::string>();
+        if (mode == "optimize")
+        {
+            style_transfer.setMode(video_styler::style_transfer::TransferMode::OPTIMIZATION);
+        }
+        else if (mode != "fast")
+        {
+            logger->error("Unknown mode: " + mode + " (expected fast or optimize)");
+            return 1;
+        }
+        style_transfer.setParameters(vm["iterations"].as<int>(), vm["style-weight"].as<double>(),
+                                     vm["content-weight"].as<double>());
+
+        video_styler::style_transfer::TensorPrecision precision = video_styler::style_transfer::TensorPrecision::FP32;
+        if (!video_styler::style_transfer::parseTensorPrecision(vm["tensor-precision"].as<std::string>(), precision))
+        {
+            logger->error("Unknown tensor precision: " + vm["tensor-precision"].as<std::string>() +
+                          " (expected fp32, fp16 or bf16)");
+            return 1;
+        }
+        style_transfer.setTensorPrecision(precision);
+
+        // Decode the style and extract its features on a pool while the video opens
+        video_styler::utils::ThreadPool style_pool(1);
+        style_transfer.loadStyleImageAsync(style_path, style_pool);
+
         // Load video
-        if (!video_loader.loadVideo(input_path))
+        const bool opened = vm.count("camera")   ? video_loader.openCamera(vm["camera"].as<int>())
+                            : vm.count("device") ? video_loader.openDevice(vm["device"].as<std::string>())
+                                                 : video_loader.loadVideo(input_path);
+        if (!opened)
         {
             logger->error("Failed to load input video");
             return 1;
         }
 
-        // Load style image
-        if (!style_transfer.loadStyleImage(style_path))
+        // Optional region restriction
+        video_styler::video_processor::RegionMask region;
+        if (vm.count("roi") + vm.count("mask") + vm.count("matte") > 1)
         {
-            logger->error("Failed to load style image");
+            logger->error("Use only one of --roi, --mask and --matte");
             return 1;
         }
+        if (vm.count("roi"))
+        {
+            cv::Rect rect;
+            if (!video_styler::video_processor::RegionMask::parseRectangle(vm["roi"].as<std::string>(), rect) ||
+                !region.setRectangle(rect))
+            {
+                logger->error("Invalid --roi (expected x,y,width,height): " + vm["roi"].as<std::string>());
+                return 1;
+            }
+        }
+        else if (vm.count("mask") && !region.loadImage(vm["mask"].as<std::string>()))
+        {
+            logger->error("Failed to load mask image: " + vm["mask"].as<std::string>());
+            return 1;
+        }
+        else if (vm.count("matte") && !region.openMatte(vm["matte"].as<std::string>()))
+        {
+            logger->error("Failed to open matte video: " + vm["matte"].as<std::string>());
+            return 1;
+        }
+        const bool masked = region.getSource() != video_styler::video_processor::RegionSource::NONE;
 
-        logger->info("Successfully loaded video and style image");
+        logger->info("Successfully loaded video");
         logger->info("Video properties:");
         logger->info("  - Frame count: " + std::to_string(video_loader.getFrameCount()));
         logger->info("  - FPS: " + std::to_string(video_loader.getFPS()));
         logger->info("  - Width: " + std::to_string(video_loader.getWidth()));
         logger->info("  - Height: " + std::to_string(video_loader.getHeight()));
 
-        // Process video (placeholder for now)
         logger->info("Starting style transfer processing...");
 
-        // TODO: Implement actual neural style transfer processing
-        // For now, just demonstrate the framework is working
-        logger->warning("Neural style transfer not yet implemented - this is a placeholder");
+        cv::VideoCapture &cap = video_loader.getCapture();
 
-        // Copy input to output as demonstration
-        cv::VideoCapture cap(input_path);
-        cv::VideoWriter writer(
-            output_path,
-            cv::VideoWriter::fourcc('M', 'P', '4', 'V'),
-            video_loader.getFPS(),
-            cv::Size(video_loader.getWidth(), video_loader.getHeight()));
+        // Live devices often report no rate; fall back to the requested or a common default
+        double output_fps = video_loader.getFPS();
+        if (vm.count("target-fps"))
+        {
+            output_fps = vm["target-fps"].as<double>();
+        }
+        else if (output_fps <= 0.0 && live)
+        {
+            output_fps = 30.0;
+        }
 
-        cv::Mat frame;
+        // With checkpoints, frames go to segments and the writer is only opened to stitch them
+        const cv::Size frame_size(video_loader.getWidth(), video_loader.getHeight());
+        const std::size_t frame_bytes = video_styler::utils::MemoryBudget::frameBytes(frame_size.width, frame_size.height);
+        if (memory_budget.isLimited() && memory_budget.getCapacity() < 2 * frame_bytes)
+        {
+            logger->warning("--max-memory is below one input and one output frame (" +
+                            std::to_string(2 * frame_bytes / (1024 * 1024)) + " MB); decoding will not run ahead");
+        }
+        cv::VideoWriter writer;
+        if (!checkpointing)
+        {
+            writer.open(output_path, cv::VideoWriter::fourcc('M', 'P', '4', 'V'), output_fps, frame_size);
+        }
+
+        // Only the first frame needs the style
+        const auto await_start = Clock::now();
+        if (!style_transfer.awaitStyle())
+        {
+            logger->error("Failed to load style image");
+            return 1;
+        }
+        logger->info("Style image ready; the first frame waited " +
+                     std::to_string(Milliseconds(Clock::now() - await_start).count()) + " ms for it");
+
+        if (vm.count("realtime") || live)
+        {
+            if (masked)
+            {
+                logger->warning("Region restriction is not supported in realtime mode; stylizing whole frames");
+            }
+            if (vm.count("dedupe"))
+            {
+                logger->warning("--dedupe is ignored in realtime mode");
+            }
+            if (output_fps <= 0.0)
+            {
+                logger->error("Realtime mode needs a positive target FPS");
+                return 1;
+            }
+
+            const std::string status_path = vm.count("realtime-status") ? vm["realtime-status"].as<std::string>() : "";
+            int result = 0;
+            if (live)
+            {
+                std::signal(SIGINT, handleInterrupt);
+                result = runLive(cap, style_transfer, writer, output_fps, vm["latency-budget"].as<double>(),
+                                 vm["iterations"].as<int>(), status_path, vm["max-frames"].as<int>());
+            }
+            else
+            {
+                result = runRealtime(cap, style_transfer, writer, output_fps, vm["latency-budget"].as<double>(),
+                                     vm["iterations"].as<int>(), status_path);
+            }
+            cap.release();
+            writer.release();
+            if (result == 0)
+            {
+                logger->info("Output saved to: " + output_path);
+            }
+            return result;
+        }
+
+        cv::Mat stylized;
         int frame_count = 0;
-        while (cap.read(frame))
+        double stylized_area = 0.0;
+        double frame_area = 0.0;
+        std::optional<video_styler::video_processor::FrameDedupeCache> dedupe;
+        if (vm.count("dedupe") && region.getSource() == video_styler::video_processor::RegionSource::MATTE)
+        {
+            // A repeated frame under a different matte frame needs a different output
+            logger->warning("--dedupe is ignored with --matte");
+        }
+        else if (vm.count("dedupe"))
+        {
+            std::size_t dedupe_capacity = static_cast<std::size_t>(std::max(1, vm["dedupe-cache-size"].as<int>()));
+            if (memory_budget.isLimited() && frame_bytes > 0)
+            {
+                // Cached outputs may take half the budget; decoding ahead gets the rest
+                dedupe_capacity = std::clamp<std::size_t>(memory_budget.getCapacity() / 2 / frame_bytes, 1, dedupe_capacity);
+            }
+            dedupe.emplace(dedupe_capacity, vm["dedupe-tolerance"].as<int>());
+        }
+
+        std::optional<video_styler::video_processor::RenderCheckpoint> checkpoint;
+        if (checkpointing)
         {
-            // TODO: Apply style transfer to frame
-            writer.write(frame);
+            checkpoint.emplace(output_path, checkpointJobKey(vm, input_path, style_path),
+                               vm["checkpoint-interval"].as<int>());
+            bool ready = false;
+            if (vm.count("resume"))
+            {
+                ready = checkpoint->resume(style_transfer) != video_styler::video_processor::ResumeResult::FAILED;
+            }
+            else
+            {
+                ready = checkpoint->start();
+            }
+            if (!ready)
+            {
+                logger->error("Cannot create checkpoint directory: " + checkpoint->getDirectory());
+                return 1;
+            }
+
+            // Skip the frames already in committed segments (and the matching matte frames)
+            cv::Mat skipped_mask;
+            for (; frame_count < checkpoint->getCommittedFrames(); ++frame_count)
+            {
+                if (!cap.grab() ||
+                    (region.getSource() == video_styler::video_processor::RegionSource::MATTE &&
+                     !region.next(frame_size, skipped_mask)))
+                {
+                    logger->error("Input ended before the checkpointed frame " +
+                                  std::to_string(checkpoint->getCommittedFrames()));
+                    return 1;
+                }
+            }
+
+            // Preemption sends SIGTERM: checkpoint what is done and exit
+            std::signal(SIGINT, handleInterrupt);
+            std::signal(SIGTERM, handleInterrupt);
+        }
+
+        // Decode on its own thread, held back by the queue depth and the memory budget
+        video_styler::video_processor::DecodeAhead decoder(cap, frame_bytes, kDecodeAheadFrames, &memory_budget);
+        video_styler::video_processor::DecodedFrame decoded;
+        while (!stop_requested && decoder.read(decoded))
+        {
+            const cv::Mat &frame = decoded.image;
+            video_styler::video_processor::FrameSignature signature;
+            bool reused = false;
+            if (dedupe)
+            {
+                signature = video_styler::video_processor::FrameDedupeCache::computeSignature(frame);
+                reused = dedupe->lookup(signature, stylized);
+            }
+            if (!reused)
+            {
+                cv::Mat mask;
+                if (masked && !region.next(frame.size(), mask))
+                {
+                    logger->error("Matte video has no frames");
+                    return 1;
+                }
+                const bool stylized_ok = masked ? style_transfer.applyStyleTransfer(frame, mask, stylized)
+                                                : style_transfer.applyStyleTransfer(frame, stylized);
+                if (!stylized_ok)
+                {
+                    logger->error("Style transfer failed at frame " + std::to_string(frame_count));
+                    return 1;
+                }
+                stylized_area += masked ? style_transfer.getLastRegion().area() : frame.size().area();
+                frame_area += frame.size().area();
+                if (dedupe)
+                {
+                    dedupe->insert(signature, stylized);
+                }
+            }
+            if (!checkpoint)
+            {
+                writer.write(stylized);
+            }
+            else if (!checkpoint->write(stylized, style_transfer))
+            {
+                logger->error("Failed to write checkpoint segment in " + checkpoint->getDirectory());
+                return 1;
+            }
             frame_count++;
 
             if (frame_count % 30 == 0)
@@ -129,9 +1005,47 @@ int main(int argc, char *argv[])
             }
         }
 
+        decoder.stop();
         cap.release();
+
+        if (checkpoint)
+        {
+            if (!checkpoint->flush(style_transfer))
+            {
+                logger->error("Failed to write checkpoint in " + checkpoint->getDirectory());
+                return 1;
+            }
+            if (stop_requested)
+            {
+                logger->warning("Stopped after " + std::to_string(frame_count) + " frames; continue with --resume");
+                return 1;
+            }
+
+            writer.open(output_path, cv::VideoWriter::fourcc('M', 'P', '4', 'V'), output_fps, frame_size);
+            if (!checkpoint->stitch(writer))
+            {
+                logger->error("Failed to stitch checkpoint segments from " + checkpoint->getDirectory());
+                return 1;
+            }
+            checkpoint->remove();
+        }
         writer.release();
 
+        if (dedupe)
+        {
+            logger->info("Dedupe cache: " + dedupe->describe());
+        }
+        if (masked && frame_area > 0.0)
+        {
+            logger->info("Region stylization covered " + std::to_string(100.0 * stylized_area / frame_area) +
+                         "% of the processed frame area");
+            if (region.isMatteExhausted())
+            {
+                logger->warning("Matte video ended before the input; its last frame was reused");
+            }
+        }
+        logger->info("Memory: " + memory_budget.describe() + ", decoded up to " +
+                     std::to_string(decoder.getPeakQueued()) + " frames ahead");
         logger->info("Video processing completed successfully!");
         logger->info("Output saved to: " + output_path);
 
@@ -0,0 +1,327 @@
+#include "style_transfer/color_lut.hpp"
+#include "style_transfer/pixel_kernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace video_styler::style_transfer
+{
+
+    namespace
+    {
+        // Style pixels beyond this are averaged away before the histograms are built
+        constexpr int kMaxStyleSide = 256;
+
+        // CIELAB with the sRGB primaries and a D65 white point, in double so the fit
+        // is identical on every machine regardless of the OpenCV build
+        constexpr double kWhiteX = 0.95047;
+        constexpr double kWhiteZ = 1.08883;
+        constexpr double kDelta = 6.0 / 29.0;
+
+        double srgbToLinear(double c)
+        {
+            return c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+        }
+
+        double linearToSrgb(double c)
+        {
+            c = std::clamp(c, 0.0, 1.0);
+            return c <= 0.0031308 ? 12.92 * c : 1.055 * std::pow(c, 1.0 / 2.4) - 0.055;
+        }
+
+        double labCurve(double t)
+        {
+            return t > kDelta * kDelta * kDelta ? std::cbrt(t) : t / (3.0 * kDelta * kDelta) + 4.0 / 29.0;
+        }
+
+        double labCurveInverse(double t)
+        {
+            return t > kDelta ? t * t * t : 3.0 * kDelta * kDelta * (t - 4.0 / 29.0);
+        }
+
+        /**
+         * @brief Convert a BGR color in [0, 1] to CIELAB
+         */
+        std::array<double, 3> bgrToLab(double b, double g, double r)
+        {
+            const double lr = srgbToLinear(r);
+            const double lg = srgbToLinear(g);
+            const double lb = srgbToLinear(b);
+            const double x = (0.4124564 * lr + 0.3575761 * lg + 0.1804375 * lb) / kWhiteX;
+            const double y = 0.2126729 * lr + 0.7151522 * lg + 0.0721750 * lb;
+            const double z = (0.0193339 * lr + 0.1191920 * lg + 0.9503041 * lb) / kWhiteZ;
+
+            const double fx = labCurve(x);
+            const double fy = labCurve(y);
+            const double fz = labCurve(z);
+            return {116.0 * fy - 16.0, 500.0 * (fx - fy), 200.0 * (fy - fz)};
+        }
+
+        /**
+         * @brief Convert CIELAB to a BGR color in [0, 1], clipping out-of-gamut colors
+         */
+        std::array<double, 3> labToBgr(const std::array<double, 3> &lab)
+        {
+            const double fy = (lab[0] + 16.0) / 116.0;
+            const double x = labCurveInverse(fy + lab[1] / 500.0) * kWhiteX;
+            const double y = labCurveInverse(fy);
+            const double z = labCurveInverse(fy - lab[2] / 200.0) * kWhiteZ;
+
+            const double lr = 3.2404542 * x - 1.5371385 * y - 0.4985314 * z;
+            const double lg = -0.9692660 * x + 1.8760108 * y + 0.0415560 * z;
+            const double lb = 0.0556434 * x - 0.2040259 * y + 1.0572252 * z;
+            return {linearToSrgb(lb), linearToSrgb(lg), linearToSrgb(lr)};
+        }
+
+        /**
+         * @brief Map a value through the quantile function of target at its rank in source
+         * @param value Value drawn from the source distribution
+         * @param source Sorted source samples
+         * @param target Sorted target samples
+         */
+        double matchHistogram(double value, const std::vector<double> &source, const std::vector<double> &target)
+        {
+            // Mid-rank of the value among the source samples, in [0, 1]
+            const auto lower = std::lower_bound(source.begin(), source.end(), value);
+            const auto upper = std::upper_bound(lower, source.end(), value);
+            const double rank = 0.5 * static_cast<double>((lower - source.begin()) + (upper - source.begin())) /
+                                static_cast<double>(source.size());
+
+            const double position = std::clamp(rank, 0.0, 1.0) * static_cast<double>(target.size() - 1);
+            const auto index = static_cast<std::size_t>(position);
+            if (index + 1 >= target.size())
+            {
+                return target.back();
+            }
+            const double fraction = position - static_cast<double>(index);
+            return target[index] + (target[index + 1] - target[index]) * fraction;
+        }
+    } // namespace
+
+    ColorLut ColorLut::identity(int size)
+    {
+        ColorLut lut;
+        lut.size_ = std::max(2, size);
+        lut.table_.resize(static_cast<std::size_t>(lut.size_) * lut.size_ * lut.size_ * 3);
+
+        const float step = 255.0f / static_cast<float>(lut.size_ - 1);
+        std::size_t entry = 0;
+        for (int b = 0; b < lut.size_; ++b)
+        {
+            for (int g = 0; g < lut.size_; ++g)
+            {
+                for (int r = 0; r < lut.size_; ++r)
+                {
+                    lut.table_[entry++] = b * step;
+                    lut.table_[entry++] = g * step;
+                    lut.table_[entry++] = r * step;
+                }
+            }
+        }
+        return lut;
+    }
+
+    ColorLut ColorLut::fitToStyle(const cv::Mat &style_image, int size)
+    {
+        if (style_image.empty() || style_image.type() != CV_8UC3)
+        {
+            return ColorLut();
+        }
+
+        cv::Mat style = style_image;
+        const int longest = std::max(style.cols, style.rows);
+        if (longest > kMaxStyleSide)
+        {
+            const double scale = static_cast<double>(kMaxStyleSide) / longest;
+            cv::resize(style_image, style, cv::Size(), scale, scale, cv::INTER_AREA);
+        }
+
+        // Per-channel CIELAB histograms of the style and of the lattice (the RGB cube)
+        std::array<std::vector<double>, 3> style_samples;
+        for (auto &samples : style_samples)
+        {
+            samples.reserve(style.total());
+        }
+        for (int y = 0; y < style.rows; ++y)
+        {
+            const auto *row = style.ptr<cv::Vec3b>(y);
+            for (int x = 0; x < style.cols; ++x)
+            {
+                const auto lab = bgrToLab(row[x][0] / 255.0, row[x][1] / 255.0, row[x][2] / 255.0);
+                for (int c = 0; c < 3; ++c)
+                {
+                    style_samples[c].push_back(lab[c]);
+                }
+            }
+        }
+
+        ColorLut lut = identity(size);
+        const std::size_t lattice_points = lut.table_.size() / 3;
+        std::vector<std::array<double, 3>> lattice_lab(lattice_points);
+        std::array<std::vector<double>, 3> lattice_samples;
+        for (std::size_t i = 0; i < lattice_points; ++i)
+        {
+            const float *bgr = &lut.table_[3 * i];
+            lattice_lab[i] = bgrToLab(bgr[0] / 255.0, bgr[1] / 255.0, bgr[2] / 255.0);
+            for (int c = 0; c < 3; ++c)
+            {
+                lattice_samples[c].push_back(lattice_lab[i][c]);
+            }
+        }
+        for (int c = 0; c < 3; ++c)
+        {
+            std::sort(style_samples[c].begin(), style_samples[c].end());
+            std::sort(lattice_samples[c].begin(), lattice_samples[c].end());
+        }
+
+        for (std::size_t i = 0; i < lattice_points; ++i)
+        {
+            std::array<double, 3> matched;
+            for (int c = 0; c < 3; ++c)
+            {
+                matched[c] = matchHistogram(lattice_lab[i][c], lattice_samples[c], style_samples[c]);
+            }
+            const auto bgr = labToBgr(matched);
+            for (int c = 0; c < 3; ++c)
+            {
+                lut.table_[3 * i + c] = static_cast<float>(bgr[c] * 255.0);
+            }
+        }
+        return lut;
+    }
+
+    bool ColorLut::empty() const
+    {
+        return table_.empty();
+    }
+
+    int ColorLut::getSize() const
+    {
+        return size_;
+    }
+
+    cv::Vec3f ColorLut::at(int r, int g, int b) const
+    {
+        const float *entry = &table_[3 * ((static_cast<std::size_t>(b) * size_ + g) * size_ + r)];
+        return cv::Vec3f(entry[0], entry[1], entry[2]);
+    }
+
+    bool ColorLut::apply(const cv::Mat &src, cv::Mat &dst) const
+    {
+        if (empty() || src.type() != CV_8UC3)
+        {
+            return false;
+        }
+
+        const cv::Mat source = src; // Keeps the data alive if src and dst are the same Mat
+        dst.create(source.size(), source.type());
+        cv::Mat &output = dst;
+
+        const auto &kernels = activeKernels();
+        const float *table = table_.data();
+        const int size = size_;
+        cv::parallel_for_(cv::Range(0, source.rows), [&](const cv::Range &range)
+                          {
+                              for (int y = range.start; y < range.end; ++y)
+                              {
+                                  kernels.apply_lut(source.ptr<std::uint8_t>(y), output.ptr<std::uint8_t>(y),
+                                                    static_cast<std::size_t>(source.cols), table, size);
+                              } });
+        return true;
+    }
+
+    bool ColorLut::exportCube(const std::string &path, const std::string &title) const
+    {
+        if (empty())
+        {
+            return false;
+        }
+
+        std::ofstream out(path);
+        if (!out)
+        {
+            return false;
+        }
+
+        if (!title.empty())
+        {
+            out << "TITLE \"" << title << "\"\n";
+        }
+        out << "LUT_3D_SIZE " << size_ << "\n";
+        out << "DOMAIN_MIN 0.0 0.0 0.0\n";
+        out << "DOMAIN_MAX 1.0 1.0 1.0\n";
+        out << std::fixed << std::setprecision(6);
+        for (std::size_t i = 0; i < table_.size(); i += 3)
+        {
+            // .cube rows are R G B in [0, 1]
+            out << table_[i + 2] / 255.0f << ' ' << table_[i + 1] / 255.0f << ' ' << table_[i] / 255.0f << '\n';
+        }
+        return static_cast<bool>(out);
+    }
+
+    bool ColorLut::loadCube(const std::string &path, ColorLut &lut)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            return false;
+        }
+
+        ColorLut loaded;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            std::istringstream fields(line);
+            std::string keyword;
+            if (!(fields >> keyword) || keyword[0] == '#' || keyword == "TITLE")
+            {
+                continue;
+            }
+            if (keyword == "LUT_3D_SIZE")
+            {
+                if (!(fields >> loaded.size_) || loaded.size_ < 2 || loaded.size_ > 256)
+                {
+                    return false;
+                }
+                loaded.table_.reserve(static_cast<std::size_t>(loaded.size_) * loaded.size_ * loaded.size_ * 3);
+                continue;
+            }
+            if (keyword == "DOMAIN_MIN" || keyword == "DOMAIN_MAX")
+            {
+                // Only the default domain is supported
+                double x = 0.0, y = 0.0, z = 0.0;
+                const double expected = keyword == "DOMAIN_MIN" ? 0.0 : 1.0;
+                if (!(fields >> x >> y >> z) || x != expected || y != expected || z != expected)
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            // Data row: R G B
+            double r = 0.0, g = 0.0, b = 0.0;
+            std::istringstream values(line);
+            if (loaded.size_ == 0 || !(values >> r >> g >> b))
+            {
+                return false;
+            }
+            loaded.table_.push_back(static_cast<float>(b * 255.0));
+            loaded.table_.push_back(static_cast<float>(g * 255.0));
+            loaded.table_.push_back(static_cast<float>(r * 255.0));
+        }
+
+        if (loaded.size_ == 0 ||
+            loaded.table_.size() != static_cast<std::size_t>(loaded.size_) * loaded.size_ * loaded.size_ * 3)
+        {
+            return false;
+        }
+        lut = std::move(loaded);
+        return true;
+    }
+
+} // namespace video_styler::style_transfer
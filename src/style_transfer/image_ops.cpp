@@ -0,0 +1,367 @@
+#include "style_transfer/image_ops.hpp"
+#include "style_transfer/pixel_kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace video_styler::style_transfer
+{
+
+    namespace
+    {
+        /**
+         * @brief Source pixel pair and weights for each output coordinate (cv::INTER_LINEAR convention)
+         */
+        void bilinearTaps(int src_size, int dst_size, std::vector<int> &first, std::vector<float> &weight)
+        {
+            first.resize(dst_size);
+            weight.resize(dst_size);
+            const double scale = static_cast<double>(src_size) / dst_size;
+            for (int d = 0; d < dst_size; ++d)
+            {
+                const double position = (d + 0.5) * scale - 0.5;
+                int s = static_cast<int>(std::floor(position));
+                float w = static_cast<float>(position - s);
+                if (s < 0)
+                {
+                    s = 0;
+                    w = 0.0f;
+                }
+                if (s >= src_size - 1)
+                {
+                    s = src_size - 1;
+                    w = 0.0f;
+                }
+                first[d] = s;
+                weight[d] = w;
+            }
+        }
+
+        /**
+         * @brief Pack one row of floats into a tensor's storage format
+         */
+        void packRow(const PixelKernels &kernels, const float *src, void *dst, std::size_t count,
+                     TensorPrecision precision)
+        {
+            switch (precision)
+            {
+            case TensorPrecision::FP16:
+                kernels.floats_to_half(src, static_cast<std::uint16_t *>(dst), count);
+                break;
+            case TensorPrecision::BF16:
+                kernels.floats_to_bfloat16(src, static_cast<std::uint16_t *>(dst), count);
+                break;
+            case TensorPrecision::FP32:
+                std::copy(src, src + count, static_cast<float *>(dst));
+                break;
+            }
+        }
+
+        /**
+         * @brief Expand one row of a tensor's storage format into floats
+         */
+        void unpackRow(const PixelKernels &kernels, const void *src, float *dst, std::size_t count,
+                       TensorPrecision precision)
+        {
+            switch (precision)
+            {
+            case TensorPrecision::FP16:
+                kernels.half_to_floats(static_cast<const std::uint16_t *>(src), dst, count);
+                break;
+            case TensorPrecision::BF16:
+                kernels.bfloat16_to_floats(static_cast<const std::uint16_t *>(src), dst, count);
+                break;
+            case TensorPrecision::FP32:
+                std::copy(static_cast<const float *>(src), static_cast<const float *>(src) + count, dst);
+                break;
+            }
+        }
+    } // namespace
+
+    std::string tensorPrecisionToString(TensorPrecision precision)
+    {
+        switch (precision)
+        {
+        case TensorPrecision::FP16:
+            return "fp16";
+        case TensorPrecision::BF16:
+            return "bf16";
+        default:
+            return "fp32";
+        }
+    }
+
+    bool parseTensorPrecision(const std::string &name, TensorPrecision &precision)
+    {
+        for (const TensorPrecision candidate : {TensorPrecision::FP32, TensorPrecision::FP16, TensorPrecision::BF16})
+        {
+            if (name == tensorPrecisionToString(candidate))
+            {
+                precision = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int tensorDepth(TensorPrecision precision)
+    {
+        switch (precision)
+        {
+        case TensorPrecision::FP16:
+            return CV_16F;
+        case TensorPrecision::BF16:
+            return CV_16U;
+        default:
+            return CV_32F;
+        }
+    }
+
+    void packTensor(const cv::Mat &src, cv::Mat &dst, TensorPrecision precision)
+    {
+        CV_Assert(src.depth() == CV_32F);
+        if (precision == TensorPrecision::FP32)
+        {
+            dst = src;
+            return;
+        }
+
+        const cv::Mat source = src;
+        dst.create(source.size(), CV_MAKETYPE(tensorDepth(precision), source.channels()));
+        const auto &kernels = activeKernels();
+        const std::size_t row_values = static_cast<std::size_t>(source.cols) * source.channels();
+        for (int row = 0; row < source.rows; ++row)
+        {
+            packRow(kernels, source.ptr<float>(row), dst.ptr(row), row_values, precision);
+        }
+    }
+
+    void unpackTensor(const cv::Mat &src, cv::Mat &dst, TensorPrecision precision)
+    {
+        CV_Assert(src.depth() == tensorDepth(precision));
+        if (precision == TensorPrecision::FP32)
+        {
+            dst = src;
+            return;
+        }
+
+        const cv::Mat source = src;
+        dst.create(source.size(), CV_MAKETYPE(CV_32F, source.channels()));
+        const auto &kernels = activeKernels();
+        const std::size_t row_values = static_cast<std::size_t>(source.cols) * source.channels();
+        for (int row = 0; row < source.rows; ++row)
+        {
+            unpackRow(kernels, source.ptr(row), dst.ptr<float>(row), row_values, precision);
+        }
+    }
+
+    void convertToFloat(const cv::Mat &src, cv::Mat &dst, float scale)
+    {
+        const cv::Mat source = src; // Keeps the data alive if src and dst are the same Mat
+        if (source.depth() != CV_8U)
+        {
+            source.convertTo(dst, CV_32F, scale);
+            return;
+        }
+
+        dst.create(source.size(), CV_MAKETYPE(CV_32F, source.channels()));
+        const auto &kernels = activeKernels();
+        if (source.isContinuous() && dst.isContinuous())
+        {
+            kernels.bytes_to_floats(source.ptr<std::uint8_t>(), dst.ptr<float>(), source.total() * source.channels(), scale);
+            return;
+        }
+        for (int row = 0; row < source.rows; ++row)
+        {
+            kernels.bytes_to_floats(source.ptr<std::uint8_t>(row), dst.ptr<float>(row),
+                                    static_cast<std::size_t>(source.cols) * source.channels(), scale);
+        }
+    }
+
+    void convertToByte(const cv::Mat &src, cv::Mat &dst, float scale)
+    {
+        const cv::Mat source = src;
+        if (source.depth() != CV_32F)
+        {
+            source.convertTo(dst, CV_8U, scale);
+            return;
+        }
+
+        dst.create(source.size(), CV_MAKETYPE(CV_8U, source.channels()));
+        const auto &kernels = activeKernels();
+        if (source.isContinuous() && dst.isContinuous())
+        {
+            kernels.floats_to_bytes(source.ptr<float>(), dst.ptr<std::uint8_t>(), source.total() * source.channels(), scale);
+            return;
+        }
+        for (int row = 0; row < source.rows; ++row)
+        {
+            kernels.floats_to_bytes(source.ptr<float>(row), dst.ptr<std::uint8_t>(row),
+                                    static_cast<std::size_t>(source.cols) * source.channels(), scale);
+        }
+    }
+
+    void blendImages(const cv::Mat &a, float weight_a, const cv::Mat &b, float weight_b, cv::Mat &dst)
+    {
+        CV_Assert(a.type() == b.type() && a.size() == b.size() && a.depth() == CV_32F);
+        const cv::Mat first = a;
+        const cv::Mat second = b;
+        dst.create(first.size(), first.type());
+
+        const auto &kernels = activeKernels();
+        const std::size_t row_values = static_cast<std::size_t>(first.cols) * first.channels();
+        for (int row = 0; row < first.rows; ++row)
+        {
+            kernels.blend(first.ptr<float>(row), second.ptr<float>(row), dst.ptr<float>(row), row_values,
+                          weight_a, weight_b);
+        }
+    }
+
+    void addDifference(const cv::Mat &base, const cv::Mat &plus, const cv::Mat &minus, cv::Mat &dst)
+    {
+        CV_Assert(base.type() == plus.type() && base.type() == minus.type() && base.depth() == CV_32F);
+        CV_Assert(base.size() == plus.size() && base.size() == minus.size());
+        const cv::Mat base_image = base;
+        const cv::Mat plus_image = plus;
+        const cv::Mat minus_image = minus;
+        dst.create(base_image.size(), base_image.type());
+
+        const auto &kernels = activeKernels();
+        const std::size_t row_values = static_cast<std::size_t>(base_image.cols) * base_image.channels();
+        for (int row = 0; row < base_image.rows; ++row)
+        {
+            kernels.add_difference(base_image.ptr<float>(row), plus_image.ptr<float>(row),
+                                   minus_image.ptr<float>(row), dst.ptr<float>(row), row_values);
+        }
+    }
+
+    void resizeBilinear(const cv::Mat &src, cv::Mat &dst, cv::Size size, TensorPrecision output_precision)
+    {
+        const cv::Mat source = src;
+        if (source.depth() != CV_32F || source.empty() || size.width <= 0 || size.height <= 0)
+        {
+            CV_Assert(output_precision == TensorPrecision::FP32);
+            cv::resize(source, dst, size, 0, 0, cv::INTER_LINEAR);
+            return;
+        }
+        if (source.size() == size)
+        {
+            if (output_precision == TensorPrecision::FP32)
+            {
+                source.copyTo(dst);
+            }
+            else
+            {
+                packTensor(source, dst, output_precision);
+            }
+            return;
+        }
+
+        const int channels = source.channels();
+        std::vector<int> x_first;
+        std::vector<float> x_weight;
+        std::vector<int> y_first;
+        std::vector<float> y_weight;
+        bilinearTaps(source.cols, size.width, x_first, x_weight);
+        bilinearTaps(source.rows, size.height, y_first, y_weight);
+
+        std::vector<int> offsets(2 * static_cast<std::size_t>(size.width));
+        std::vector<float> weights(2 * static_cast<std::size_t>(size.width));
+        for (int x = 0; x < size.width; ++x)
+        {
+            const int right = std::min(x_first[x] + 1, source.cols - 1);
+            offsets[2 * x] = x_first[x] * channels;
+            offsets[2 * x + 1] = right * channels;
+            weights[2 * x] = 1.0f - x_weight[x];
+            weights[2 * x + 1] = x_weight[x];
+        }
+
+        dst.create(size, CV_MAKETYPE(tensorDepth(output_precision), channels));
+        cv::Mat &output = dst;
+        const auto &kernels = activeKernels();
+        const std::size_t row_values = static_cast<std::size_t>(size.width) * channels;
+        const bool packed = output_precision != TensorPrecision::FP32;
+
+        const auto resize_rows = [&](const cv::Range &range)
+        {
+            // Horizontally interpolated source rows, reused while consecutive output rows share them
+            std::vector<float> top(row_values);
+            std::vector<float> bottom(row_values);
+            std::vector<float> blended(packed ? row_values : 0);
+            int top_row = -1;
+            int bottom_row = -1;
+
+            for (int y = range.start; y < range.end; ++y)
+            {
+                const int y0 = y_first[y];
+                const int y1 = std::min(y0 + 1, source.rows - 1);
+                if (y0 == bottom_row)
+                {
+                    std::swap(top, bottom);
+                    std::swap(top_row, bottom_row);
+                }
+                if (y0 != top_row)
+                {
+                    kernels.interpolate_columns(source.ptr<float>(y0), offsets.data(), weights.data(), top.data(),
+                                                size.width, channels);
+                    top_row = y0;
+                }
+                if (y1 != bottom_row)
+                {
+                    kernels.interpolate_columns(source.ptr<float>(y1), offsets.data(), weights.data(), bottom.data(),
+                                                size.width, channels);
+                    bottom_row = y1;
+                }
+                if (!packed)
+                {
+                    kernels.blend(top.data(), bottom.data(), output.ptr<float>(y), row_values,
+                                  1.0f - y_weight[y], y_weight[y]);
+                    continue;
+                }
+                kernels.blend(top.data(), bottom.data(), blended.data(), row_values, 1.0f - y_weight[y], y_weight[y]);
+                packRow(kernels, blended.data(), output.ptr(y), row_values, output_precision);
+            }
+        };
+        cv::parallel_for_(cv::Range(0, size.height), resize_rows);
+    }
+
+    void applyResidual(const cv::Mat &src, const cv::Mat &residual, TensorPrecision precision, cv::Mat &dst)
+    {
+        CV_Assert(src.depth() == CV_8U && residual.size() == src.size() && residual.channels() == src.channels());
+        CV_Assert(residual.depth() == tensorDepth(precision));
+        const cv::Mat source = src;
+        const cv::Mat delta = residual;
+        dst.create(source.size(), source.type());
+        cv::Mat &output = dst;
+
+        const auto &kernels = activeKernels();
+        const std::size_t row_values = static_cast<std::size_t>(source.cols) * source.channels();
+        const auto apply_rows = [&](const cv::Range &range)
+        {
+            std::vector<float> pixels(row_values);
+            std::vector<float> change(row_values);
+            for (int y = range.start; y < range.end; ++y)
+            {
+                kernels.bytes_to_floats(source.ptr<std::uint8_t>(y), pixels.data(), row_values, 1.0f / 255.0f);
+                unpackRow(kernels, delta.ptr(y), change.data(), row_values, precision);
+                kernels.blend(pixels.data(), change.data(), pixels.data(), row_values, 1.0f, 1.0f);
+                kernels.floats_to_bytes(pixels.data(), output.ptr<std::uint8_t>(y), row_values, 255.0f);
+            }
+        };
+        cv::parallel_for_(cv::Range(0, source.rows), apply_rows);
+    }
+
+    cv::Mat gramMatrix(const cv::Mat &features)
+    {
+        CV_Assert(features.type() == CV_32F && features.cols <= static_cast<int>(kMaxGramFeatures));
+        const cv::Mat samples = features.isContinuous() ? features : features.clone();
+
+        cv::Mat gram(samples.cols, samples.cols, CV_32F);
+        activeKernels().gram(samples.ptr<float>(), samples.rows, samples.cols, gram.ptr<float>());
+        return gram;
+    }
+
+} // namespace video_styler::style_transfer
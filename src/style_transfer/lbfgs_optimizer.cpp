@@ -0,0 +1,144 @@
+#include "style_transfer/lbfgs_optimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <vector>
+
+namespace video_styler::style_transfer
+{
+
+    namespace
+    {
+        // Armijo sufficient-decrease constant
+        constexpr double kArmijo = 1e-4;
+        // Step shrink factor per backtracking step
+        constexpr double kBacktrack = 0.5;
+        // Curvature pairs with s.y below this are skipped to keep H positive definite
+        constexpr double kCurvatureEpsilon = 1e-10;
+
+        struct CurvaturePair
+        {
+            Eigen::VectorXf s;
+            Eigen::VectorXf y;
+            double rho;
+        };
+    } // namespace
+
+    LbfgsOptimizer::LbfgsOptimizer(LbfgsSettings settings)
+        : settings_(settings)
+    {
+    }
+
+    LbfgsResult LbfgsOptimizer::minimize(const Objective &objective, Eigen::VectorXf &x) const
+    {
+        LbfgsResult result;
+
+        Eigen::VectorXf gradient(x.size());
+        double loss = objective(x, gradient);
+        result.initial_loss = loss;
+        result.final_loss = loss;
+
+        std::deque<CurvaturePair> history;
+        std::vector<double> alpha(settings_.history_size);
+        Eigen::VectorXf direction(x.size());
+        Eigen::VectorXf candidate(x.size());
+        Eigen::VectorXf candidate_gradient(x.size());
+        int plateau_count = 0;
+
+        for (int iteration = 0; iteration < settings_.max_iterations; ++iteration)
+        {
+            const double gradient_norm = gradient.norm();
+            if (gradient_norm / std::max(1.0, static_cast<double>(x.norm())) < settings_.gradient_tolerance)
+            {
+                result.stop_reason = LbfgsStopReason::GRADIENT_CONVERGED;
+                return result;
+            }
+
+            // Two-loop recursion: direction = -H * gradient
+            direction = -gradient;
+            for (std::size_t i = history.size(); i-- > 0;)
+            {
+                alpha[i] = history[i].rho * history[i].s.dot(direction);
+                direction -= static_cast<float>(alpha[i]) * history[i].y;
+            }
+            if (!history.empty())
+            {
+                // Scale by the most recent curvature estimate (Nocedal & Wright, eq. 7.20)
+                const auto &last = history.back();
+                direction *= static_cast<float>(last.s.dot(last.y) / last.y.squaredNorm());
+            }
+            for (std::size_t i = 0; i < history.size(); ++i)
+            {
+                const double beta = history[i].rho * history[i].y.dot(direction);
+                direction += static_cast<float>(alpha[i] - beta) * history[i].s;
+            }
+
+            double slope = gradient.dot(direction);
+            if (slope >= 0.0)
+            {
+                // Not a descent direction (numerical trouble): restart from steepest descent
+                history.clear();
+                direction = -gradient;
+                slope = -gradient_norm * gradient_norm;
+            }
+
+            // Without curvature information, take a unit-length first step
+            double step = history.empty() ? 1.0 / std::max(gradient_norm, 1e-12) : 1.0;
+            double candidate_loss = 0.0;
+            bool accepted = false;
+            for (int attempt = 0; attempt < settings_.max_line_search_steps; ++attempt)
+            {
+                candidate = x + static_cast<float>(step) * direction;
+                candidate_loss = objective(candidate, candidate_gradient);
+                if (std::isfinite(candidate_loss) && candidate_loss <= loss + kArmijo * step * slope)
+                {
+                    accepted = true;
+                    break;
+                }
+                step *= kBacktrack;
+            }
+
+            if (!accepted)
+            {
+                result.stop_reason = LbfgsStopReason::LINE_SEARCH_FAILED;
+                return result;
+            }
+
+            CurvaturePair pair{candidate - x, candidate_gradient - gradient, 0.0};
+            const double curvature = pair.s.dot(pair.y);
+            if (curvature > kCurvatureEpsilon)
+            {
+                pair.rho = 1.0 / curvature;
+                history.push_back(std::move(pair));
+                if (static_cast<int>(history.size()) > settings_.history_size)
+                {
+                    history.pop_front();
+                }
+            }
+
+            const double improvement = (loss - candidate_loss) / std::max(std::abs(loss), 1e-12);
+            x.swap(candidate);
+            gradient.swap(candidate_gradient);
+            loss = candidate_loss;
+            result.iterations = iteration + 1;
+            result.final_loss = loss;
+
+            plateau_count = improvement < settings_.plateau_tolerance ? plateau_count + 1 : 0;
+            if (plateau_count >= settings_.plateau_patience)
+            {
+                result.stop_reason = LbfgsStopReason::LOSS_PLATEAU;
+                return result;
+            }
+        }
+
+        result.stop_reason = LbfgsStopReason::MAX_ITERATIONS;
+        return result;
+    }
+
+    const LbfgsSettings &LbfgsOptimizer::getSettings() const
+    {
+        return settings_;
+    }
+
+} // namespace video_styler::style_transfer
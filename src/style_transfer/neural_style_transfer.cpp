@@ -1,11 +1,40 @@
 #include "style_transfer/neural_style_transfer.hpp"
+#include "style_transfer/image_ops.hpp"
+#include "style_transfer/lbfgs_optimizer.hpp"
+#include "style_transfer/style_loss.hpp"
+#include <algorithm>
 #include <iostream>
+#include <memory>
 
 namespace video_styler::style_transfer
 {
 
+    namespace
+    {
+        /**
+         * @brief Gram target of a style image at a working resolution
+         */
+        cv::Mat computeStyleGram(const cv::Mat &style_image, int working_max_side)
+        {
+            cv::Mat style;
+            convertToFloat(style_image, style, 1.0f / 255.0f);
+            const double scale = std::min(1.0, static_cast<double>(working_max_side) / std::max(style.cols, style.rows));
+            cv::Mat working;
+            if (scale < 1.0)
+            {
+                cv::resize(style, working, cv::Size(), scale, scale, cv::INTER_AREA);
+            }
+            else
+            {
+                working = style;
+            }
+            return StyleLoss::computeGram(working);
+        }
+    } // namespace
+
     bool NeuralStyleTransfer::loadStyleImage(const std::string &filepath)
     {
+        pending_style_ = {};
         style_image_ = cv::imread(filepath, cv::IMREAD_COLOR);
 
         if (style_image_.empty())
@@ -15,35 +44,273 @@ namespace video_styler::style_transfer
         }
 
         style_loaded_ = true;
+        style_gram_.release();
+        color_lut_ = ColorLut();
+        resetTemporalState();
+        return true;
+    }
+
+    bool NeuralStyleTransfer::setStyleImage(const cv::Mat &style_image)
+    {
+        pending_style_ = {};
+        style_image_ = style_image;
+        style_loaded_ = !style_image_.empty();
+        style_gram_.release();
+        color_lut_ = ColorLut();
+        resetTemporalState();
+        return style_loaded_;
+    }
+
+    std::shared_future<PreparedStyle> NeuralStyleTransfer::loadStyleImageAsync(const std::string &filepath,
+                                                                               utils::ThreadPool &pool)
+    {
+        // The task owns its promise and copies of the settings: it never touches this object
+        auto promise = std::make_shared<std::promise<PreparedStyle>>();
+        pending_style_ = promise->get_future().share();
+        pool.submit([promise, filepath, mode = mode_, working_max_side = working_max_side_]
+                    {
+                        try
+                        {
+                            promise->set_value(prepareStyle(cv::imread(filepath, cv::IMREAD_COLOR), mode, working_max_side));
+                        }
+                        catch (...)
+                        {
+                            promise->set_exception(std::current_exception());
+                        } });
+        return pending_style_;
+    }
+
+    bool NeuralStyleTransfer::awaitStyle()
+    {
+        if (pending_style_.valid())
+        {
+            const std::shared_future<PreparedStyle> pending = std::move(pending_style_);
+            try
+            {
+                setPreparedStyle(pending.get());
+            }
+            catch (const std::exception &)
+            {
+                style_image_.release();
+                style_loaded_ = false;
+            }
+        }
+        return style_loaded_;
+    }
+
+    PreparedStyle NeuralStyleTransfer::prepareStyle(const cv::Mat &style_image, TransferMode mode, int working_max_side)
+    {
+        PreparedStyle style;
+        if (style_image.empty())
+        {
+            return style;
+        }
+
+        style.image = style_image;
+        if (mode == TransferMode::OPTIMIZATION)
+        {
+            style.gram_side = std::max(16, working_max_side);
+            style.gram = computeStyleGram(style_image, style.gram_side);
+        }
+        else
+        {
+            style.color_lut = ColorLut::fitToStyle(style_image);
+        }
+        return style;
+    }
+
+    bool NeuralStyleTransfer::setPreparedStyle(const PreparedStyle &style)
+    {
+        if (!setStyleImage(style.image))
+        {
+            return false;
+        }
+        color_lut_ = style.color_lut;
+        style_gram_ = style.gram;
+        style_gram_side_ = style.gram_side;
         return true;
     }
 
     bool NeuralStyleTransfer::applyStyleTransfer(const cv::Mat &input_frame, cv::Mat &output_frame)
     {
-        if (!style_loaded_)
+        awaitStyle();
+        if (!style_loaded_ || input_frame.empty())
         {
             return false;
         }
 
-        // TODO: Implement actual neural style transfer
-        // For now, just copy the input frame as a placeholder
-        input_frame.copyTo(output_frame);
+        if (mode_ == TransferMode::OPTIMIZATION)
+        {
+            return applyOptimization(input_frame, output_frame);
+        }
+
+        return applyColorLut(input_frame, output_frame);
+    }
+
+    bool NeuralStyleTransfer::applyStyleTransfer(const cv::Mat &input_frame, const cv::Mat &mask, cv::Mat &output_frame)
+    {
+        awaitStyle();
+        if (!style_loaded_ || input_frame.empty() || mask.size() != input_frame.size() || mask.type() != CV_8UC1)
+        {
+            return false;
+        }
+
+        const cv::Rect region = activeRegion(mask);
+        if (region != last_region_)
+        {
+            resetTemporalState();
+            last_region_ = region;
+        }
+
+        cv::Mat result = input_frame.clone();
+        if (region.empty())
+        {
+            output_frame = result;
+            return true;
+        }
+
+        cv::Mat stylized;
+        if (!applyStyleTransfer(input_frame(region), stylized))
+        {
+            return false;
+        }
+
+        cv::Mat target = result(region);
+        const cv::Mat alpha = mask(region);
+        if (cv::countNonZero(alpha != 255) == 0)
+        {
+            stylized.copyTo(target);
+        }
+        else
+        {
+            cv::Mat weights;
+            alpha.convertTo(weights, CV_32F, 1.0 / 255.0);
+            const cv::Mat inverse_weights = 1.0 - weights;
+            cv::blendLinear(stylized, target, weights, inverse_weights, target);
+        }
+
+        output_frame = result;
+        return true;
+    }
+
+    cv::Rect NeuralStyleTransfer::getLastRegion() const
+    {
+        return last_region_;
+    }
+
+    cv::Rect NeuralStyleTransfer::activeRegion(const cv::Mat &mask, int tile_size)
+    {
+        const cv::Rect bounds = cv::boundingRect(mask);
+        if (bounds.empty())
+        {
+            return {};
+        }
+
+        // Snap outward to the tile grid; the slack also gives the filters some context
+        tile_size = std::max(1, tile_size);
+        const int x0 = bounds.x / tile_size * tile_size;
+        const int y0 = bounds.y / tile_size * tile_size;
+        const int x1 = (bounds.x + bounds.width + tile_size - 1) / tile_size * tile_size;
+        const int y1 = (bounds.y + bounds.height + tile_size - 1) / tile_size * tile_size;
+        return cv::Rect(x0, y0, x1 - x0, y1 - y0) & cv::Rect(0, 0, mask.cols, mask.rows);
+    }
+
+    bool NeuralStyleTransfer::applyColorLut(const cv::Mat &input_frame, cv::Mat &output_frame)
+    {
+        last_iterations_ = 0;
+        return getColorLut().apply(input_frame, output_frame);
+    }
+
+    bool NeuralStyleTransfer::applyOptimization(const cv::Mat &input_frame, cv::Mat &output_frame)
+    {
+        // Optimize at a bounded working resolution; detail above it comes from the input
+        const double scale = std::min(1.0, static_cast<double>(working_max_side_) / std::max(input_frame.cols, input_frame.rows));
+        cv::Mat input; // Full-resolution float frame, FP32 only
+        cv::Mat content;
+        if (tensor_precision_ == TensorPrecision::FP32)
+        {
+            input = preprocessImage(input_frame);
+            if (scale < 1.0)
+            {
+                cv::resize(input, content, cv::Size(), scale, scale, cv::INTER_AREA);
+            }
+            else
+            {
+                content = input.clone();
+            }
+        }
+        else
+        {
+            // Shrink the 8-bit frame first: only the working copy is ever widened to float
+            cv::Mat working = input_frame;
+            if (scale < 1.0)
+            {
+                cv::resize(input_frame, working, cv::Size(), scale, scale, cv::INTER_AREA);
+            }
+            content = preprocessImage(working);
+        }
+
+        // Warm start: carry the previous frame's stylization residual onto the new content
+        cv::Mat start = content.clone();
+        if (!previous_content_.empty() && previous_content_.size() == content.size())
+        {
+            cv::Mat previous_result;
+            cv::Mat previous_content;
+            unpackTensor(previous_result_, previous_result, tensor_precision_);
+            unpackTensor(previous_content_, previous_content, tensor_precision_);
+            addDifference(start, previous_result, previous_content, start);
+        }
+
+        Eigen::VectorXf x = Eigen::Map<const Eigen::VectorXf>(start.ptr<float>(), static_cast<Eigen::Index>(start.total()) * 3);
 
-        // Apply a simple color transformation as a placeholder
-        cv::Mat hsv_frame;
-        cv::cvtColor(output_frame, hsv_frame, cv::COLOR_BGR2HSV);
+        LbfgsSettings settings;
+        settings.max_iterations = std::max(0, iterations_);
+        const StyleLoss loss(content, styleGram(), content_weight_, style_weight_);
+        const auto result = LbfgsOptimizer(settings).minimize(
+            [&loss](const Eigen::VectorXf &point, Eigen::VectorXf &gradient)
+            { return loss.evaluate(point, gradient); },
+            x);
+        last_iterations_ = result.iterations;
 
-        // Shift hue slightly to show some processing is happening
-        std::vector<cv::Mat> hsv_channels;
-        cv::split(hsv_frame, hsv_channels);
-        hsv_channels[0] += 10; // Shift hue
-        cv::merge(hsv_channels, hsv_frame);
+        const cv::Mat stylized = cv::Mat(content.size(), CV_32FC3, x.data()).clone();
+        packTensor(content, previous_content_, tensor_precision_);
+        packTensor(stylized, previous_result_, tensor_precision_);
 
-        cv::cvtColor(hsv_frame, output_frame, cv::COLOR_HSV2BGR);
+        // Apply the optimized change as a residual so full-resolution detail survives
+        cv::Mat residual;
+        blendImages(stylized, 1.0f, content, -1.0f, residual);
 
+        if (tensor_precision_ != TensorPrecision::FP32)
+        {
+            // Only the packed residual exists at full resolution; it is added to
+            // the 8-bit input row by row
+            cv::Mat packed_residual;
+            resizeBilinear(residual, packed_residual, input_frame.size(), tensor_precision_);
+            applyResidual(input_frame, packed_residual, tensor_precision_, output_frame);
+            return true;
+        }
+
+        if (scale < 1.0)
+        {
+            resizeBilinear(residual, residual, input.size());
+        }
+
+        cv::Mat output;
+        blendImages(input, 1.0f, residual, 1.0f, output);
+        output_frame = postprocessImage(output);
         return true;
     }
 
+    const cv::Mat &NeuralStyleTransfer::styleGram()
+    {
+        if (style_gram_.empty() || style_gram_side_ != working_max_side_)
+        {
+            style_gram_ = computeStyleGram(style_image_, working_max_side_);
+            style_gram_side_ = working_max_side_;
+        }
+        return style_gram_;
+    }
+
     bool NeuralStyleTransfer::isStyleLoaded() const
     {
         return style_loaded_;
@@ -56,6 +323,110 @@ namespace video_styler::style_transfer
         content_weight_ = content_weight;
     }
 
+    void NeuralStyleTransfer::setIterations(int iterations)
+    {
+        iterations_ = iterations;
+    }
+
+    void NeuralStyleTransfer::setMode(TransferMode mode)
+    {
+        mode_ = mode;
+        resetTemporalState();
+    }
+
+    TransferMode NeuralStyleTransfer::getMode() const
+    {
+        return mode_;
+    }
+
+    void NeuralStyleTransfer::setWorkingResolution(int max_side)
+    {
+        working_max_side_ = std::max(16, max_side);
+        resetTemporalState();
+    }
+
+    const ColorLut &NeuralStyleTransfer::getColorLut()
+    {
+        awaitStyle();
+        if (color_lut_.empty() && style_loaded_)
+        {
+            color_lut_ = ColorLut::fitToStyle(style_image_);
+        }
+        return color_lut_;
+    }
+
+    bool NeuralStyleTransfer::exportColorLut(const std::string &path)
+    {
+        return awaitStyle() && getColorLut().exportCube(path, "video_styler style palette");
+    }
+
+    void NeuralStyleTransfer::setTensorPrecision(TensorPrecision precision)
+    {
+        tensor_precision_ = precision;
+        resetTemporalState();
+    }
+
+    TensorPrecision NeuralStyleTransfer::getTensorPrecision() const
+    {
+        return tensor_precision_;
+    }
+
+    void NeuralStyleTransfer::resetTemporalState()
+    {
+        previous_content_.release();
+        previous_result_.release();
+    }
+
+    void NeuralStyleTransfer::saveTemporalState(cv::FileStorage &fs, const std::string &name) const
+    {
+        // Stored as float32 whatever the tensor precision: packing it again is exact
+        fs << name << "{";
+        fs << "region" << last_region_;
+        if (!previous_content_.empty())
+        {
+            cv::Mat content;
+            cv::Mat result;
+            unpackTensor(previous_content_, content, tensor_precision_);
+            unpackTensor(previous_result_, result, tensor_precision_);
+            fs << "content" << content << "result" << result;
+        }
+        fs << "}";
+    }
+
+    bool NeuralStyleTransfer::loadTemporalState(const cv::FileNode &node)
+    {
+        resetTemporalState();
+        last_region_ = cv::Rect();
+        if (node.empty())
+        {
+            return false;
+        }
+
+        node["region"] >> last_region_;
+        if (node["content"].empty())
+        {
+            return true;
+        }
+
+        cv::Mat content;
+        cv::Mat result;
+        node["content"] >> content;
+        node["result"] >> result;
+        if (content.empty() || content.type() != CV_32FC3 || result.size() != content.size() ||
+            result.type() != content.type())
+        {
+            return false;
+        }
+        packTensor(content, previous_content_, tensor_precision_);
+        packTensor(result, previous_result_, tensor_precision_);
+        return true;
+    }
+
+    int NeuralStyleTransfer::getLastIterationCount() const
+    {
+        return last_iterations_;
+    }
+
     void NeuralStyleTransfer::initializeNetwork()
     {
         // TODO: Initialize the neural network for style transfer
@@ -67,10 +438,9 @@ namespace video_styler::style_transfer
         // TODO: Implement image preprocessing for the neural network
         // This typically involves normalization, resizing, etc.
         cv::Mat processed;
-        image.copyTo(processed);
 
         // Convert to float and normalize to [0, 1]
-        processed.convertTo(processed, CV_32F, 1.0 / 255.0);
+        convertToFloat(image, processed, 1.0f / 255.0f);
 
         return processed;
     }
@@ -82,7 +452,7 @@ namespace video_styler::style_transfer
         cv::Mat processed;
 
         // Convert back to 8-bit and scale to [0, 255]
-        image.convertTo(processed, CV_8U, 255.0);
+        convertToByte(image, processed, 255.0f);
 
         return processed;
     }
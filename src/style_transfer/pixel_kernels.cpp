@@ -0,0 +1,86 @@
+#include "style_transfer/pixel_kernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace video_styler::style_transfer
+{
+
+    // Entry points of the per-ISA translation units (pixel_kernels_*.cpp)
+    namespace generic
+    {
+        const PixelKernels &kernels();
+    }
+#ifdef VIDEO_STYLER_X86_KERNELS
+    namespace sse42
+    {
+        const PixelKernels &kernels();
+    }
+    namespace avx2
+    {
+        const PixelKernels &kernels();
+    }
+    namespace avx512
+    {
+        const PixelKernels &kernels();
+    }
+#endif
+
+    namespace
+    {
+        std::atomic<const PixelKernels *> active_kernels{nullptr};
+
+        const PixelKernels *compiledKernels(utils::CpuIsa isa)
+        {
+            switch (isa)
+            {
+            case utils::CpuIsa::GENERIC:
+                return &generic::kernels();
+#ifdef VIDEO_STYLER_X86_KERNELS
+            case utils::CpuIsa::SSE42:
+                return &sse42::kernels();
+            case utils::CpuIsa::AVX2:
+                return &avx2::kernels();
+            case utils::CpuIsa::AVX512:
+                return &avx512::kernels();
+#endif
+            default:
+                return nullptr;
+            }
+        }
+    } // namespace
+
+    const PixelKernels &activeKernels()
+    {
+        const PixelKernels *kernels = active_kernels.load(std::memory_order_acquire);
+        if (kernels == nullptr)
+        {
+            kernels = &selectKernels(utils::CpuIsa::AVX512);
+        }
+        return *kernels;
+    }
+
+    const PixelKernels &selectKernels(utils::CpuIsa max_isa)
+    {
+        // Walk down from the cap to the best variant that is both compiled in and supported
+        int level = static_cast<int>(std::min(max_isa, utils::detectCpuIsa()));
+        const PixelKernels *kernels = nullptr;
+        for (; kernels == nullptr; --level)
+        {
+            kernels = compiledKernels(static_cast<utils::CpuIsa>(level));
+        }
+
+        active_kernels.store(kernels, std::memory_order_release);
+        return *kernels;
+    }
+
+    const PixelKernels *kernelsForIsa(utils::CpuIsa isa)
+    {
+        if (isa > utils::detectCpuIsa())
+        {
+            return nullptr;
+        }
+        return compiledKernels(isa);
+    }
+
+} // namespace video_styler::style_transfer
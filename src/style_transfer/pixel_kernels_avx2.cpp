@@ -0,0 +1,5 @@
+// Pixel kernels, avx2 variant. Built with -mavx2 -mfma; selected only when the CPU reports AVX2 and FMA.
+#define VIDEO_STYLER_KERNEL_NAMESPACE avx2
+#define VIDEO_STYLER_KERNEL_ISA AVX2
+#define VIDEO_STYLER_KERNEL_LANES 8
+#include "pixel_kernels_impl.hpp"
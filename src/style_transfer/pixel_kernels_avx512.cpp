@@ -0,0 +1,5 @@
+// Pixel kernels, avx512 variant. Built with -mavx512f/bw/vl/dq; selected only when the CPU reports all four.
+#define VIDEO_STYLER_KERNEL_NAMESPACE avx512
+#define VIDEO_STYLER_KERNEL_ISA AVX512
+#define VIDEO_STYLER_KERNEL_LANES 16
+#include "pixel_kernels_impl.hpp"
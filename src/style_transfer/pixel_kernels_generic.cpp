@@ -0,0 +1,5 @@
+// Pixel kernels, generic variant. Built with the compiler's baseline flags; always available and the only variant off x86.
+#define VIDEO_STYLER_KERNEL_NAMESPACE generic
+#define VIDEO_STYLER_KERNEL_ISA GENERIC
+#define VIDEO_STYLER_KERNEL_LANES 4
+#include "pixel_kernels_impl.hpp"
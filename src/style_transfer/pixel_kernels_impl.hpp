@@ -0,0 +1,317 @@
+// Shared body of the per-ISA kernel translation units (pixel_kernels_*.cpp).
+//
+// Each includer defines VIDEO_STYLER_KERNEL_NAMESPACE (namespace of its
+// kernels() entry point), VIDEO_STYLER_KERNEL_ISA (utils::CpuIsa enumerator)
+// and VIDEO_STYLER_KERNEL_LANES (floats per vector register), and is compiled
+// with the matching -m flags plus -ffp-contract=off so every variant rounds
+// identically.
+//
+// Everything below has internal linkage and deliberately avoids standard
+// library templates: an inline function instantiated here with AVX-512 code
+// could otherwise be chosen by the linker for the whole program and fault on
+// older CPUs. Plain loops over fixed-width lane arrays vectorize without
+// reassociating floating-point sums.
+
+#include "style_transfer/pixel_kernels.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace video_styler::style_transfer::VIDEO_STYLER_KERNEL_NAMESPACE
+{
+
+    namespace
+    {
+        constexpr std::size_t kLanes = VIDEO_STYLER_KERNEL_LANES;
+        // Logical lanes of the Gram accumulators. Fixed rather than kLanes so every
+        // variant forms the same partial sums and reduces them in the same order
+        constexpr std::size_t kGramLanes = 16;
+        constexpr std::size_t kMaxGramPairs = kMaxGramFeatures * (kMaxGramFeatures + 1) / 2;
+
+        void bytesToFloats(const std::uint8_t *src, float *dst, std::size_t count, float scale)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                dst[i] = static_cast<float>(src[i]) * scale;
+            }
+        }
+
+        void floatsToBytes(const float *src, std::uint8_t *dst, std::size_t count, float scale)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                float value = src[i] * scale + 0.5f;
+                value = value > 0.0f ? value : 0.0f; // Also maps NaN to 0
+                value = value < 255.0f ? value : 255.0f;
+                dst[i] = static_cast<std::uint8_t>(value);
+            }
+        }
+
+        void blend(const float *a, const float *b, float *dst, std::size_t count, float weight_a, float weight_b)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                dst[i] = a[i] * weight_a + b[i] * weight_b;
+            }
+        }
+
+        void addDifference(const float *base, const float *plus, const float *minus, float *dst, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                dst[i] = base[i] + (plus[i] - minus[i]);
+            }
+        }
+
+        std::uint32_t floatBits(float value)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        float bitsFloat(std::uint32_t bits)
+        {
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        void floatsToHalf(const float *src, std::uint16_t *dst, std::size_t count)
+        {
+            // Round to nearest even with the exponent-rebias trick; selects instead of
+            // branches keep the loop vectorizable
+            const float subnormal_magic = bitsFloat(126u << 23);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const std::uint32_t bits = floatBits(src[i]);
+                const std::uint32_t sign = (bits >> 16) & 0x8000u;
+                const std::uint32_t magnitude = bits & 0x7fffffffu;
+
+                const std::uint32_t subnormal = floatBits(bitsFloat(magnitude) + subnormal_magic) - (126u << 23);
+                const std::uint32_t odd = (magnitude >> 13) & 1u;
+                const std::uint32_t normal = (magnitude + 0xc8000fffu + odd) >> 13; // Rebias 127 -> 15
+                const std::uint32_t special = magnitude > 0x7f800000u ? 0x7e00u : 0x7c00u;
+
+                const std::uint32_t half = magnitude >= 0x477ff000u  ? special
+                                           : magnitude < 0x38800000u ? subnormal
+                                                                     : normal;
+                dst[i] = static_cast<std::uint16_t>(sign | half);
+            }
+        }
+
+        void halfToFloats(const std::uint16_t *src, float *dst, std::size_t count)
+        {
+            const float subnormal_bias = bitsFloat(113u << 23);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const std::uint32_t half = src[i];
+                const std::uint32_t shifted = (half & 0x7fffu) << 13;
+                const std::uint32_t exponent = shifted & 0x0f800000u;
+                const std::uint32_t rebiased = shifted + (112u << 23);
+
+                const std::uint32_t special = rebiased + (112u << 23);
+                const std::uint32_t subnormal = floatBits(bitsFloat(rebiased + (1u << 23)) - subnormal_bias);
+                const std::uint32_t magnitude = exponent == 0x0f800000u ? special
+                                                : exponent == 0u        ? subnormal
+                                                                        : rebiased;
+                dst[i] = bitsFloat(magnitude | ((half & 0x8000u) << 16));
+            }
+        }
+
+        void floatsToBfloat16(const float *src, std::uint16_t *dst, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const std::uint32_t bits = floatBits(src[i]);
+                const std::uint32_t rounded = (bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16;
+                const std::uint32_t quiet_nan = (bits >> 16) | 0x40u;
+                dst[i] = static_cast<std::uint16_t>((bits & 0x7fffffffu) > 0x7f800000u ? quiet_nan : rounded);
+            }
+        }
+
+        void bfloat16ToFloats(const std::uint16_t *src, float *dst, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                dst[i] = bitsFloat(static_cast<std::uint32_t>(src[i]) << 16);
+            }
+        }
+
+        void applyLut(const std::uint8_t *src, std::uint8_t *dst, std::size_t pixels, const float *table, int size)
+        {
+            // Lattice offset (in floats) and position inside the cell for every byte value, per axis
+            const float scale = static_cast<float>(size - 1) / 255.0f;
+            const int last_cell = size - 2;
+            const int strides[3] = {size * size * 3, size * 3, 3}; // B, G, R
+            int offsets[3][256];
+            float fractions[3][256];
+            for (int value = 0; value < 256; ++value)
+            {
+                const float position = static_cast<float>(value) * scale;
+                int cell = static_cast<int>(position);
+                cell = cell < last_cell ? cell : last_cell;
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    offsets[axis][value] = cell * strides[axis];
+                    fractions[axis][value] = position - static_cast<float>(cell);
+                }
+            }
+
+            // kLanes pixels at a time: gather the eight corners into lane arrays and
+            // interpolate lane-wise along red, then green, then blue
+            int base[kLanes];
+            float fb[kLanes], fg[kLanes], fr[kLanes];
+            float corners[8][kLanes];
+            float result[kLanes];
+
+            std::size_t p = 0;
+            for (; p < pixels; p += kLanes)
+            {
+                const std::size_t lanes = pixels - p < kLanes ? pixels - p : kLanes;
+                for (std::size_t lane = 0; lane < kLanes; ++lane)
+                {
+                    // Tail lanes repeat the last pixel so the lane loops stay full width
+                    const std::uint8_t *pixel = src + 3 * (p + (lane < lanes ? lane : lanes - 1));
+                    base[lane] = offsets[0][pixel[0]] + offsets[1][pixel[1]] + offsets[2][pixel[2]];
+                    fb[lane] = fractions[0][pixel[0]];
+                    fg[lane] = fractions[1][pixel[1]];
+                    fr[lane] = fractions[2][pixel[2]];
+                }
+
+                for (int c = 0; c < 3; ++c)
+                {
+                    for (int corner = 0; corner < 8; ++corner)
+                    {
+                        const int offset = ((corner >> 2) & 1) * strides[0] + ((corner >> 1) & 1) * strides[1] +
+                                           (corner & 1) * strides[2] + c;
+                        for (std::size_t lane = 0; lane < kLanes; ++lane)
+                        {
+                            corners[corner][lane] = table[base[lane] + offset];
+                        }
+                    }
+                    for (std::size_t lane = 0; lane < kLanes; ++lane)
+                    {
+                        const float c00 = corners[0][lane] + (corners[1][lane] - corners[0][lane]) * fr[lane];
+                        const float c01 = corners[2][lane] + (corners[3][lane] - corners[2][lane]) * fr[lane];
+                        const float c10 = corners[4][lane] + (corners[5][lane] - corners[4][lane]) * fr[lane];
+                        const float c11 = corners[6][lane] + (corners[7][lane] - corners[6][lane]) * fr[lane];
+                        const float c0 = c00 + (c01 - c00) * fg[lane];
+                        const float c1 = c10 + (c11 - c10) * fg[lane];
+
+                        float value = c0 + (c1 - c0) * fb[lane] + 0.5f;
+                        value = value > 0.0f ? value : 0.0f;
+                        value = value < 255.0f ? value : 255.0f;
+                        result[lane] = value;
+                    }
+                    for (std::size_t lane = 0; lane < lanes; ++lane)
+                    {
+                        dst[3 * (p + lane) + c] = static_cast<std::uint8_t>(result[lane]);
+                    }
+                }
+            }
+        }
+
+        void interpolateColumns(const float *row, const int *offsets, const float *weights, float *dst,
+                                std::size_t width, int channels)
+        {
+            if (channels == 3)
+            {
+                for (std::size_t x = 0; x < width; ++x)
+                {
+                    const float *left = row + offsets[2 * x];
+                    const float *right = row + offsets[2 * x + 1];
+                    const float w0 = weights[2 * x];
+                    const float w1 = weights[2 * x + 1];
+                    dst[3 * x] = left[0] * w0 + right[0] * w1;
+                    dst[3 * x + 1] = left[1] * w0 + right[1] * w1;
+                    dst[3 * x + 2] = left[2] * w0 + right[2] * w1;
+                }
+                return;
+            }
+
+            for (std::size_t x = 0; x < width; ++x)
+            {
+                const float *left = row + offsets[2 * x];
+                const float *right = row + offsets[2 * x + 1];
+                for (int c = 0; c < channels; ++c)
+                {
+                    dst[x * channels + c] = left[c] * weights[2 * x] + right[c] * weights[2 * x + 1];
+                }
+            }
+        }
+
+        void gram(const float *features, std::size_t rows, std::size_t cols, float *gram)
+        {
+            // One accumulator per (feature pair, lane): kGramLanes rows are transposed into a
+            // block so the innermost loop is a contiguous lane-wise multiply-add
+            float accumulators[kMaxGramPairs][kGramLanes] = {};
+            float block[kMaxGramFeatures][kGramLanes];
+
+            std::size_t row = 0;
+            for (; row + kGramLanes <= rows; row += kGramLanes)
+            {
+                for (std::size_t lane = 0; lane < kGramLanes; ++lane)
+                {
+                    for (std::size_t c = 0; c < cols; ++c)
+                    {
+                        block[c][lane] = features[(row + lane) * cols + c];
+                    }
+                }
+
+                std::size_t pair = 0;
+                for (std::size_t i = 0; i < cols; ++i)
+                {
+                    for (std::size_t j = i; j < cols; ++j, ++pair)
+                    {
+                        for (std::size_t lane = 0; lane < kGramLanes; ++lane)
+                        {
+                            accumulators[pair][lane] += block[i][lane] * block[j][lane];
+                        }
+                    }
+                }
+            }
+
+            // Reduce lanes and the leftover rows in double precision
+            std::size_t pair = 0;
+            for (std::size_t i = 0; i < cols; ++i)
+            {
+                for (std::size_t j = i; j < cols; ++j, ++pair)
+                {
+                    double sum = 0.0;
+                    for (std::size_t lane = 0; lane < kGramLanes; ++lane)
+                    {
+                        sum += accumulators[pair][lane];
+                    }
+                    for (std::size_t r = row; r < rows; ++r)
+                    {
+                        sum += static_cast<double>(features[r * cols + i]) * features[r * cols + j];
+                    }
+                    gram[i * cols + j] = static_cast<float>(sum);
+                    gram[j * cols + i] = static_cast<float>(sum);
+                }
+            }
+        }
+    } // namespace
+
+    const PixelKernels &kernels()
+    {
+        static const PixelKernels table{
+            utils::CpuIsa::VIDEO_STYLER_KERNEL_ISA,
+            &bytesToFloats,
+            &floatsToBytes,
+            &blend,
+            &addDifference,
+            &interpolateColumns,
+            &gram,
+            &floatsToHalf,
+            &halfToFloats,
+            &floatsToBfloat16,
+            &bfloat16ToFloats,
+            &applyLut,
+        };
+        return table;
+    }
+
+} // namespace video_styler::style_transfer::VIDEO_STYLER_KERNEL_NAMESPACE
@@ -0,0 +1,5 @@
+// Pixel kernels, sse42 variant. Built with -msse4.2; selected only when the CPU reports SSE4.2.
+#define VIDEO_STYLER_KERNEL_NAMESPACE sse42
+#define VIDEO_STYLER_KERNEL_ISA SSE42
+#define VIDEO_STYLER_KERNEL_LANES 4
+#include "pixel_kernels_impl.hpp"
@@ -0,0 +1,106 @@
+#include "style_transfer/style_loss.hpp"
+#include "style_transfer/image_ops.hpp"
+
+#include <vector>
+
+namespace video_styler::style_transfer
+{
+
+    namespace
+    {
+        // Sobel kernels scaled by 1/8 so gradients share the range of the color channels
+        constexpr float kSobelX[9] = {-0.125f, 0.0f, 0.125f, -0.25f, 0.0f, 0.25f, -0.125f, 0.0f, 0.125f};
+        constexpr float kSobelY[9] = {-0.125f, -0.25f, -0.125f, 0.0f, 0.0f, 0.0f, 0.125f, 0.25f, 0.125f};
+
+        // The adjoint of a zero-padded correlation is the correlation with the rotated kernel
+        constexpr float kSobelXRotated[9] = {0.125f, 0.0f, -0.125f, 0.25f, 0.0f, -0.25f, 0.125f, 0.0f, -0.125f};
+        constexpr float kSobelYRotated[9] = {0.125f, 0.25f, 0.125f, 0.0f, 0.0f, 0.0f, -0.125f, -0.25f, -0.125f};
+
+        cv::Mat kernel(const float *values)
+        {
+            // Wraps the taps without copying; filter2D only reads its kernel
+            return cv::Mat(3, 3, CV_32F, const_cast<float *>(values));
+        }
+
+        cv::Mat correlate(const cv::Mat &image, const float *values)
+        {
+            cv::Mat result;
+            cv::filter2D(image, result, CV_32F, kernel(values), cv::Point(-1, -1), 0, cv::BORDER_CONSTANT);
+            return result;
+        }
+    } // namespace
+
+    StyleLoss::StyleLoss(const cv::Mat &content, const cv::Mat &style_gram, double content_weight, double style_weight)
+        : content_(content),
+          style_gram_(kFeatureCount, kFeatureCount),
+          content_weight_(content_weight),
+          style_weight_(style_weight)
+    {
+        for (int row = 0; row < kFeatureCount; ++row)
+        {
+            for (int col = 0; col < kFeatureCount; ++col)
+            {
+                style_gram_(row, col) = style_gram.at<float>(row, col);
+            }
+        }
+    }
+
+    double StyleLoss::evaluate(const Eigen::VectorXf &x, Eigen::VectorXf &gradient) const
+    {
+        const int rows = content_.rows;
+        const int cols = content_.cols;
+        const int pixels = rows * cols;
+
+        // View the optimization vector as an image without copying
+        const cv::Mat image(rows, cols, CV_32FC3, const_cast<float *>(x.data()));
+
+        // Content term: mean squared distance to the content frame
+        const Eigen::Map<const Eigen::VectorXf> content(content_.ptr<float>(), x.size());
+        const Eigen::VectorXf diff = x - content;
+        const double content_loss = content_weight_ * diff.squaredNorm() / pixels;
+        gradient = static_cast<float>(2.0 * content_weight_ / pixels) * diff;
+
+        // Style term: squared Frobenius distance between Gram matrices
+        const cv::Mat features = extractFeatures(image);
+        const Eigen::Map<const RowMatrixXf> f(features.ptr<float>(), pixels, kFeatureCount);
+        const cv::Mat gram = gramMatrix(features);
+        const Eigen::Map<const RowMatrixXf> g(gram.ptr<float>(), kFeatureCount, kFeatureCount);
+        const Eigen::MatrixXf error = g / static_cast<float>(pixels) - style_gram_;
+        const double style_loss = style_weight_ * error.squaredNorm();
+
+        // d(loss)/dF = 4 w / N * F * (G - T), then through the linear feature bank
+        RowMatrixXf feature_gradient = static_cast<float>(4.0 * style_weight_ / pixels) * (f * error);
+        const cv::Mat feature_gradient_mat(pixels, kFeatureCount, CV_32F, feature_gradient.data());
+
+        cv::Mat image_gradient = feature_gradient_mat.colRange(0, 3).clone().reshape(3, rows);
+        const cv::Mat gx_gradient = feature_gradient_mat.colRange(3, 6).clone().reshape(3, rows);
+        const cv::Mat gy_gradient = feature_gradient_mat.colRange(6, 9).clone().reshape(3, rows);
+        cv::add(image_gradient, correlate(gx_gradient, kSobelXRotated), image_gradient);
+        cv::add(image_gradient, correlate(gy_gradient, kSobelYRotated), image_gradient);
+
+        gradient += Eigen::Map<const Eigen::VectorXf>(image_gradient.ptr<float>(), x.size());
+        return content_loss + style_loss;
+    }
+
+    cv::Mat StyleLoss::computeGram(const cv::Mat &image)
+    {
+        const int pixels = image.rows * image.cols;
+        const cv::Mat gram = gramMatrix(extractFeatures(image));
+        return gram / static_cast<double>(pixels);
+    }
+
+    cv::Mat StyleLoss::extractFeatures(const cv::Mat &image)
+    {
+        const int pixels = image.rows * image.cols;
+        const std::vector<cv::Mat> columns = {
+            image.reshape(1, pixels),
+            correlate(image, kSobelX).reshape(1, pixels),
+            correlate(image, kSobelY).reshape(1, pixels),
+        };
+
+        cv::Mat features;
+        cv::hconcat(columns, features);
+        return features;
+    }
+
+} // namespace video_styler::style_transfer
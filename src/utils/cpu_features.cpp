@@ -0,0 +1,66 @@
+#include "utils/cpu_features.hpp"
+
+namespace video_styler::utils
+{
+
+    namespace
+    {
+        CpuIsa queryCpuIsa()
+        {
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+            // __builtin_cpu_supports also checks XCR0, so AVX is only reported if the OS saves its state
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512dq"))
+            {
+                return CpuIsa::AVX512;
+            }
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            {
+                return CpuIsa::AVX2;
+            }
+            if (__builtin_cpu_supports("sse4.2"))
+            {
+                return CpuIsa::SSE42;
+            }
+#endif
+            return CpuIsa::GENERIC;
+        }
+    } // namespace
+
+    CpuIsa detectCpuIsa()
+    {
+        static const CpuIsa isa = queryCpuIsa();
+        return isa;
+    }
+
+    std::string cpuIsaToString(CpuIsa isa)
+    {
+        switch (isa)
+        {
+        case CpuIsa::GENERIC:
+            return "generic";
+        case CpuIsa::SSE42:
+            return "sse4.2";
+        case CpuIsa::AVX2:
+            return "avx2";
+        case CpuIsa::AVX512:
+            return "avx512";
+        }
+        return "unknown";
+    }
+
+    bool parseCpuIsa(const std::string &name, CpuIsa &isa)
+    {
+        for (const CpuIsa candidate : {CpuIsa::GENERIC, CpuIsa::SSE42, CpuIsa::AVX2, CpuIsa::AVX512})
+        {
+            if (cpuIsaToString(candidate) == name)
+            {
+                isa = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace video_styler::utils
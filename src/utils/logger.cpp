@@ -7,6 +7,8 @@ namespace video_styler::utils
 
     std::shared_ptr<Logger> Logger::getInstance()
     {
+        static std::mutex instance_mutex;
+        std::lock_guard<std::mutex> lock(instance_mutex);
         if (!instance_)
         {
             instance_ = std::make_shared<Logger>(CreateLogger{});
@@ -16,6 +18,7 @@ namespace video_styler::utils
 
     void Logger::setLogLevel(LogLevel level)
     {
+        std::lock_guard<std::mutex> lock(mutex_);
         min_level_ = level;
     }
 
@@ -41,6 +44,7 @@ namespace video_styler::utils
 
     void Logger::setLogFile(const std::string &filename)
     {
+        std::lock_guard<std::mutex> lock(mutex_);
         if (file_stream_.is_open())
         {
             file_stream_.close();
@@ -55,6 +59,7 @@ namespace video_styler::utils
 
     void Logger::log(LogLevel level, const std::string &message)
     {
+        std::lock_guard<std::mutex> lock(mutex_);
         if (level < min_level_)
         {
             return;
@@ -0,0 +1,247 @@
+#include "utils/memory_budget.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+namespace video_styler::utils
+{
+
+    namespace
+    {
+        std::string toMegabytes(std::size_t bytes)
+        {
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(1) << bytes / (1024.0 * 1024.0) << " MB";
+            return ss.str();
+        }
+    } // namespace
+
+    MemoryBudget::MemoryBudget(std::size_t capacity)
+        : capacity_(capacity)
+    {
+    }
+
+    bool MemoryBudget::tryAcquire(std::size_t bytes, std::function<void()> on_available)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (fits(bytes))
+        {
+            take(bytes);
+            return true;
+        }
+        if (on_available)
+        {
+            deferred_.push_back(std::move(on_available));
+        }
+        return false;
+    }
+
+    bool MemoryBudget::acquire(std::size_t bytes, const std::atomic<bool> &cancelled)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        available_cv_.wait(lock, [this, bytes, &cancelled]
+                           { return cancelled.load() || fits(bytes); });
+        if (cancelled.load())
+        {
+            return false;
+        }
+        take(bytes);
+        return true;
+    }
+
+    void MemoryBudget::release(std::size_t bytes)
+    {
+        std::vector<std::function<void()>> deferred;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            in_use_ -= std::min(bytes, in_use_);
+            deferred.swap(deferred_);
+        }
+        available_cv_.notify_all();
+
+        // Outside the lock: callbacks typically try to acquire again
+        for (auto &callback : deferred)
+        {
+            callback();
+        }
+    }
+
+    void MemoryBudget::cancelWaits()
+    {
+        // Taking the mutex orders the caller's cancel flag before the waiters' predicate check
+        std::lock_guard<std::mutex> lock(mutex_);
+        available_cv_.notify_all();
+    }
+
+    bool MemoryBudget::isLimited() const
+    {
+        return capacity_ > 0;
+    }
+
+    std::size_t MemoryBudget::getCapacity() const
+    {
+        return capacity_;
+    }
+
+    std::size_t MemoryBudget::getInUse() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return in_use_;
+    }
+
+    std::size_t MemoryBudget::getPeak() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return peak_;
+    }
+
+    std::string MemoryBudget::describe() const
+    {
+        std::string line = "peak " + toMegabytes(getPeak()) + " of frame buffers";
+        line += isLimited() ? " (budget " + toMegabytes(capacity_) + ")" : " (no budget)";
+        const std::size_t rss = peakResidentBytes();
+        if (rss > 0)
+        {
+            line += ", peak RSS " + toMegabytes(rss);
+        }
+        return line;
+    }
+
+    bool MemoryBudget::parseSize(const std::string &text, std::size_t &bytes)
+    {
+        std::size_t digits = 0;
+        while (digits < text.size() && (std::isdigit(static_cast<unsigned char>(text[digits])) || text[digits] == '.'))
+        {
+            ++digits;
+        }
+        if (digits == 0)
+        {
+            return false;
+        }
+
+        double value = 0.0;
+        try
+        {
+            value = std::stod(text.substr(0, digits));
+        }
+        catch (const std::exception &)
+        {
+            return false;
+        }
+
+        std::string unit = text.substr(digits);
+        for (auto &c : unit)
+        {
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        if (unit.size() == 2 && unit[1] == 'B')
+        {
+            unit.pop_back();
+        }
+
+        double scale = 1.0;
+        if (unit == "K")
+        {
+            scale = 1024.0;
+        }
+        else if (unit == "M")
+        {
+            scale = 1024.0 * 1024.0;
+        }
+        else if (unit == "G")
+        {
+            scale = 1024.0 * 1024.0 * 1024.0;
+        }
+        else if (unit == "T")
+        {
+            scale = 1024.0 * 1024.0 * 1024.0 * 1024.0;
+        }
+        else if (!unit.empty() && unit != "B")
+        {
+            return false;
+        }
+
+        bytes = static_cast<std::size_t>(std::llround(value * scale));
+        return true;
+    }
+
+    std::size_t MemoryBudget::frameBytes(int width, int height, int channels)
+    {
+        return static_cast<std::size_t>(std::max(0, width)) * static_cast<std::size_t>(std::max(0, height)) *
+               static_cast<std::size_t>(std::max(1, channels));
+    }
+
+    std::size_t MemoryBudget::peakResidentBytes()
+    {
+#ifdef __linux__
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+            // Linux reports kilobytes
+            return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+        }
+#endif
+        return 0;
+    }
+
+    bool MemoryBudget::fits(std::size_t bytes) const
+    {
+        return capacity_ == 0 || in_use_ == 0 || in_use_ + bytes <= capacity_;
+    }
+
+    void MemoryBudget::take(std::size_t bytes)
+    {
+        in_use_ += bytes;
+        peak_ = std::max(peak_, in_use_);
+    }
+
+    MemoryLease::MemoryLease(MemoryBudget *budget, std::size_t bytes)
+        : budget_(budget), bytes_(budget ? bytes : 0)
+    {
+    }
+
+    MemoryLease::~MemoryLease()
+    {
+        reset();
+    }
+
+    MemoryLease::MemoryLease(MemoryLease &&other) noexcept
+        : budget_(std::exchange(other.budget_, nullptr)), bytes_(std::exchange(other.bytes_, 0))
+    {
+    }
+
+    MemoryLease &MemoryLease::operator=(MemoryLease &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            budget_ = std::exchange(other.budget_, nullptr);
+            bytes_ = std::exchange(other.bytes_, 0);
+        }
+        return *this;
+    }
+
+    void MemoryLease::reset()
+    {
+        if (budget_)
+        {
+            budget_->release(bytes_);
+        }
+        budget_ = nullptr;
+        bytes_ = 0;
+    }
+
+    std::size_t MemoryLease::getBytes() const
+    {
+        return bytes_;
+    }
+
+} // namespace video_styler::utils
@@ -0,0 +1,209 @@
+#include "utils/thread_budget.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <Eigen/Core>
+#include <opencv2/opencv.hpp>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace video_styler::utils
+{
+
+    ThreadBudget::ThreadBudget(int total_threads, int intra_op_threads, int pipeline_workers)
+        : cpus_(availableCpus()),
+          total_threads_(total_threads),
+          requested_intra_op_(intra_op_threads),
+          requested_workers_(pipeline_workers)
+    {
+        partition();
+    }
+
+    bool ThreadBudget::restrictToNumaNode(int node)
+    {
+        std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string line;
+        if (!cpulist || !std::getline(cpulist, line))
+        {
+            return false;
+        }
+
+        const std::vector<int> node_cpus = parseCpuList(line);
+        std::vector<int> restricted;
+        std::set_intersection(cpus_.begin(), cpus_.end(), node_cpus.begin(), node_cpus.end(),
+                              std::back_inserter(restricted));
+        if (restricted.empty())
+        {
+            return false;
+        }
+
+        cpus_ = std::move(restricted);
+        restricted_ = true;
+        partition();
+        return true;
+    }
+
+    void ThreadBudget::setPinning(bool enabled)
+    {
+        pinning_ = enabled;
+    }
+
+    bool ThreadBudget::apply() const
+    {
+        bool applied = true;
+#ifdef __linux__
+        if (restricted_)
+        {
+            // Threads inherit the mask, so restrict before OpenCV (re)creates its pool
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (const int cpu : cpus_)
+            {
+                CPU_SET(cpu, &set);
+            }
+            applied = sched_setaffinity(0, sizeof(set), &set) == 0;
+        }
+#endif
+        cv::setNumThreads(intra_op_threads_);
+        Eigen::setNbThreads(intra_op_threads_);
+        return applied;
+    }
+
+    bool ThreadBudget::pinCurrentThread(std::size_t worker_index) const
+    {
+#ifdef __linux__
+        if (!pinning_ || cpus_.empty())
+        {
+            return false;
+        }
+
+        // Give each worker a contiguous block of intra-op CPUs
+        const std::size_t first = (worker_index * intra_op_threads_) % cpus_.size();
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int i = 0; i < intra_op_threads_; ++i)
+        {
+            CPU_SET(cpus_[(first + i) % cpus_.size()], &set);
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)worker_index;
+        return false;
+#endif
+    }
+
+    int ThreadBudget::getTotalThreads() const
+    {
+        return pipeline_workers_ * intra_op_threads_;
+    }
+
+    int ThreadBudget::getPipelineWorkers() const
+    {
+        return pipeline_workers_;
+    }
+
+    int ThreadBudget::getIntraOpThreads() const
+    {
+        return intra_op_threads_;
+    }
+
+    const std::vector<int> &ThreadBudget::getCpus() const
+    {
+        return cpus_;
+    }
+
+    std::string ThreadBudget::describe() const
+    {
+        std::stringstream ss;
+        ss << getTotalThreads() << " threads = " << pipeline_workers_ << " pipeline workers x "
+           << intra_op_threads_ << " intra-op threads on " << cpus_.size() << " CPUs"
+           << (pinning_ ? " (pinned)" : "");
+        return ss.str();
+    }
+
+    std::vector<int> ThreadBudget::availableCpus()
+    {
+        std::vector<int> cpus;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &set))
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+#endif
+        if (cpus.empty())
+        {
+            const int count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+            for (int cpu = 0; cpu < count; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+
+    std::vector<int> ThreadBudget::parseCpuList(const std::string &cpu_list)
+    {
+        std::vector<int> cpus;
+        std::stringstream ss(cpu_list);
+        std::string range;
+        while (std::getline(ss, range, ','))
+        {
+            try
+            {
+                const auto dash = range.find('-');
+                const int first = std::stoi(range.substr(0, dash));
+                const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; ++cpu)
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+            catch (const std::exception &)
+            {
+                // Skip malformed entries such as trailing whitespace
+            }
+        }
+
+        std::sort(cpus.begin(), cpus.end());
+        cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+        return cpus;
+    }
+
+    void ThreadBudget::partition()
+    {
+        const int available = static_cast<int>(cpus_.size());
+        const int total = total_threads_ > 0 ? total_threads_ : available;
+
+        if (requested_intra_op_ > 0)
+        {
+            intra_op_threads_ = std::min(requested_intra_op_, total);
+        }
+        else if (requested_workers_ > 0)
+        {
+            // Spread what the requested workers leave over intra-op parallelism
+            intra_op_threads_ = std::max(1, total / requested_workers_);
+        }
+        else
+        {
+            intra_op_threads_ = 1;
+        }
+
+        const int max_workers = std::max(1, total / intra_op_threads_);
+        pipeline_workers_ = requested_workers_ > 0 ? std::min(requested_workers_, max_workers) : max_workers;
+    }
+
+} // namespace video_styler::utils
@@ -0,0 +1,167 @@
+#include "utils/thread_pool.hpp"
+#include <algorithm>
+
+namespace video_styler::utils
+{
+
+    namespace
+    {
+        // Identifies the pool and queue owned by the current worker thread
+        thread_local const ThreadPool *current_pool = nullptr;
+        thread_local std::size_t current_index = 0;
+    } // namespace
+
+    ThreadPool::ThreadPool(std::size_t num_threads, WorkerInitializer on_worker_start)
+        : on_worker_start_(std::move(on_worker_start))
+    {
+        if (num_threads == 0)
+        {
+            num_threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        queues_.reserve(num_threads);
+        for (std::size_t i = 0; i < num_threads; ++i)
+        {
+            queues_.push_back(std::make_unique<WorkerQueue>());
+        }
+
+        workers_.reserve(num_threads);
+        for (std::size_t i = 0; i < num_threads; ++i)
+        {
+            workers_.emplace_back([this, i]
+                                  { workerLoop(i); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        waitIdle();
+
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            stopping_ = true;
+        }
+        wake_cv_.notify_all();
+
+        for (auto &worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::submit(Task task)
+    {
+        // Tasks spawned by a worker stay local; external submissions are spread round-robin
+        const std::size_t index = current_pool == this
+                                      ? current_index
+                                      : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+        pending_.fetch_add(1, std::memory_order_acq_rel);
+        {
+            // Count before publishing so a thief can never decrement below zero
+            std::lock_guard<std::mutex> wake_lock(wake_mutex_);
+            queued_.fetch_add(1, std::memory_order_acq_rel);
+
+            std::lock_guard<std::mutex> queue_lock(queues_[index]->mutex);
+            queues_[index]->tasks.push_back(std::move(task));
+        }
+        wake_cv_.notify_one();
+    }
+
+    void ThreadPool::waitIdle()
+    {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        idle_cv_.wait(lock, [this]
+                      { return pending_.load(std::memory_order_acquire) == 0; });
+    }
+
+    std::size_t ThreadPool::size() const
+    {
+        return workers_.size();
+    }
+
+    std::size_t ThreadPool::stealCount() const
+    {
+        return steals_.load(std::memory_order_relaxed);
+    }
+
+    void ThreadPool::workerLoop(std::size_t index)
+    {
+        current_pool = this;
+        current_index = index;
+        if (on_worker_start_)
+        {
+            on_worker_start_(index);
+        }
+
+        while (true)
+        {
+            Task task;
+            if (acquireTask(index, task))
+            {
+                try
+                {
+                    task();
+                }
+                catch (...)
+                {
+                    // Tasks report their own failures; never let one take down a worker
+                }
+                task = nullptr; // Release captured state before reporting completion
+                finishTask();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_cv_.wait(lock, [this]
+                          { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+            if (stopping_ && queued_.load(std::memory_order_acquire) == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    bool ThreadPool::acquireTask(std::size_t index, Task &task)
+    {
+        // Own queue first, newest task first
+        {
+            auto &own = *queues_[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                queued_.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
+            }
+        }
+
+        // Steal the oldest task from the next non-empty victim
+        for (std::size_t offset = 1; offset < queues_.size(); ++offset)
+        {
+            auto &victim = *queues_[(index + offset) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queued_.fetch_sub(1, std::memory_order_acq_rel);
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::finishTask()
+    {
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            idle_cv_.notify_all();
+        }
+    }
+
+} // namespace video_styler::utils
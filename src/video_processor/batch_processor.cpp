@@ -0,0 +1,547 @@
+#include "video_processor/batch_processor.hpp"
+#include "video_processor/video_loader.hpp"
+#include "video_processor/frame_dedupe_cache.hpp"
+#include "style_transfer/neural_style_transfer.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+namespace video_styler::video_processor
+{
+
+    namespace fs = std::filesystem;
+    namespace pt = boost::property_tree;
+
+    struct BatchProcessor::ReadySegment
+    {
+        std::vector<cv::Mat> frames;
+        std::shared_ptr<utils::MemoryLease> lease;
+    };
+
+    struct BatchProcessor::JobState
+    {
+        JobReport report;
+        VideoLoader loader;
+        cv::VideoWriter writer;
+        std::chrono::steady_clock::time_point start_time;
+        int segment_frames{0};       // Sized from the frame dimensions and the memory budget
+        std::size_t frame_bytes{0};
+        std::unique_ptr<style_transfer::NeuralStyleTransfer> sequential; // Optimize mode: warm-started across segments
+
+        // Guards everything below
+        std::mutex mutex;
+        std::map<int, ReadySegment> ready_segments;
+        std::shared_ptr<const style_transfer::PreparedStyle> style; // Set once its style is ready
+        std::deque<std::function<void()>> queued_segments;         // Stylize tasks not yet submitted
+        bool stylizing{false};                                     // A sequential segment is running
+        int next_segment_to_write{0};
+        int total_segments{-1}; // Unknown until the decoder reaches the end
+        bool failed{false};
+    };
+
+    std::size_t BatchReport::completedCount() const
+    {
+        std::size_t completed = 0;
+        for (const auto &job : jobs)
+        {
+            if (job.status == JobStatus::COMPLETED)
+            {
+                ++completed;
+            }
+        }
+        return completed;
+    }
+
+    double BatchReport::throughput() const
+    {
+        return wall_seconds > 0.0 ? total_frames / wall_seconds : 0.0;
+    }
+
+    BatchProcessor::BatchProcessor(utils::ThreadPool &pool, int segment_frames)
+        : pool_(pool), segment_frames_(std::max(1, segment_frames))
+    {
+    }
+
+    void BatchProcessor::setDedupe(std::size_t capacity, int tolerance)
+    {
+        dedupe_capacity_ = capacity;
+        dedupe_tolerance_ = tolerance;
+    }
+
+    bool BatchProcessor::setRenderSettings(const RenderSettings &settings)
+    {
+        style_transfer::TransferMode mode = style_transfer::TransferMode::FAST;
+        if (settings.mode == "optimize")
+        {
+            mode = style_transfer::TransferMode::OPTIMIZATION;
+        }
+        else if (settings.mode != "fast")
+        {
+            return false;
+        }
+
+        style_transfer::TensorPrecision precision = style_transfer::TensorPrecision::FP32;
+        if (!style_transfer::parseTensorPrecision(settings.precision, precision))
+        {
+            return false;
+        }
+
+        render_ = settings;
+        mode_ = mode;
+        precision_ = precision;
+        return true;
+    }
+
+    void BatchProcessor::configure(style_transfer::NeuralStyleTransfer &style_transfer) const
+    {
+        style_transfer.setMode(mode_);
+        style_transfer.setParameters(render_.iterations, render_.style_weight, render_.content_weight);
+        style_transfer.setTensorPrecision(precision_);
+    }
+
+    void BatchProcessor::setMemoryBudget(utils::MemoryBudget *budget)
+    {
+        memory_budget_ = budget;
+    }
+
+    bool BatchProcessor::loadManifest(const std::string &filepath, std::vector<BatchJob> &jobs)
+    {
+        auto logger = utils::Logger::getInstance();
+
+        pt::ptree root;
+        try
+        {
+            pt::read_json(filepath, root);
+        }
+        catch (const pt::json_parser_error &e)
+        {
+            logger->error("Failed to parse manifest: " + std::string(e.what()));
+            return false;
+        }
+
+        const auto entries = root.get_child_optional("jobs");
+        if (!entries)
+        {
+            logger->error("Manifest has no \"jobs\" array: " + filepath);
+            return false;
+        }
+
+        // Relative paths in the manifest are resolved against the manifest's directory
+        const fs::path base_dir = fs::path(filepath).parent_path();
+        auto resolve = [&base_dir](const std::string &path)
+        {
+            const fs::path p(path);
+            return p.is_absolute() ? p.string() : (base_dir / p).string();
+        };
+
+        jobs.clear();
+        for (const auto &[key, entry] : *entries)
+        {
+            const auto input = entry.get_optional<std::string>("input");
+            const auto style = entry.get_optional<std::string>("style");
+            const auto output = entry.get_optional<std::string>("output");
+            if (!input || !style || !output)
+            {
+                logger->error("Manifest job #" + std::to_string(jobs.size()) +
+                              " must specify input, style and output");
+                return false;
+            }
+            jobs.push_back(BatchJob{resolve(*input), resolve(*style), resolve(*output)});
+        }
+
+        return true;
+    }
+
+    BatchReport BatchProcessor::run(const std::vector<BatchJob> &jobs)
+    {
+        const auto start_time = std::chrono::steady_clock::now();
+        const std::size_t steals_before = pool_.stealCount();
+
+        std::vector<std::unique_ptr<JobState>> states;
+        std::map<std::string, std::vector<JobState *>> jobs_by_style;
+        states.reserve(jobs.size());
+        for (const auto &job : jobs)
+        {
+            auto state = std::make_unique<JobState>();
+            state->report.job = job;
+            state->start_time = start_time;
+            jobs_by_style[job.style_path].push_back(state.get());
+            states.push_back(std::move(state));
+        }
+
+        // Styles load in parallel with each other and with the jobs opening their inputs
+        for (const auto &[style_path, style_jobs] : jobs_by_style)
+        {
+            pool_.submit([this, style_path, style_jobs]
+                         { loadStyle(style_path, style_jobs); });
+        }
+        for (auto &state : states)
+        {
+            JobState *job_state = state.get();
+            pool_.submit([this, job_state]
+                         { startJob(*job_state); });
+        }
+        pool_.waitIdle();
+
+        BatchReport report;
+        for (const auto &state : states)
+        {
+            report.total_frames += state->report.frames_processed;
+            report.jobs.push_back(state->report);
+        }
+        report.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        report.steals = pool_.stealCount() - steals_before;
+        return report;
+    }
+
+    void BatchProcessor::loadStyle(const std::string &style_path, const std::vector<JobState *> &jobs)
+    {
+        // The LUT fit (or Gram target) is computed once for every segment of every job using the style
+        const auto style = std::make_shared<const style_transfer::PreparedStyle>(style_transfer::NeuralStyleTransfer::prepareStyle(
+            cv::imread(style_path, cv::IMREAD_COLOR), mode_));
+
+        for (JobState *state : jobs)
+        {
+            if (style->image.empty())
+            {
+                failJob(*state, "failed to load style image");
+                continue;
+            }
+
+            std::vector<std::function<void()>> runnable;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->style = style;
+                runnable = takeRunnableSegments(*state);
+            }
+            for (auto &task : runnable)
+            {
+                pool_.submit(std::move(task));
+            }
+        }
+    }
+
+    void BatchProcessor::startJob(JobState &state)
+    {
+        const BatchJob &job = state.report.job;
+        {
+            // The job's style may already have failed to load
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (state.failed)
+            {
+                return;
+            }
+            state.start_time = std::chrono::steady_clock::now();
+            state.report.status = JobStatus::RUNNING;
+        }
+
+        if (mode_ == style_transfer::TransferMode::OPTIMIZATION)
+        {
+            // Warm starts carry over from segment to segment, as in a single-node run
+            state.sequential = std::make_unique<style_transfer::NeuralStyleTransfer>();
+            configure(*state.sequential);
+        }
+
+        if (!state.loader.loadVideo(job.input_path))
+        {
+            failJob(state, "failed to load input video");
+            return;
+        }
+
+        bool opened = false;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (state.failed)
+            {
+                return;
+            }
+            state.writer.open(
+                job.output_path,
+                cv::VideoWriter::fourcc('M', 'P', '4', 'V'),
+                state.loader.getFPS(),
+                cv::Size(state.loader.getWidth(), state.loader.getHeight()));
+            opened = state.writer.isOpened();
+        }
+        if (!opened)
+        {
+            failJob(state, "failed to open output video");
+            return;
+        }
+
+        state.frame_bytes = utils::MemoryBudget::frameBytes(state.loader.getWidth(), state.loader.getHeight());
+        state.segment_frames = segment_frames_;
+        if (memory_budget_ && memory_budget_->isLimited() && state.frame_bytes > 0)
+        {
+            // Every worker may hold a segment in half the budget; the other half is working memory
+            const std::size_t per_worker = memory_budget_->getCapacity() / (2 * std::max<std::size_t>(1, pool_.size()));
+            state.segment_frames = static_cast<int>(
+                std::clamp<std::size_t>(per_worker / state.frame_bytes, 1, static_cast<std::size_t>(segment_frames_)));
+        }
+
+        utils::Logger::getInstance()->debug("Started job: " + job.input_path + " (" +
+                                            std::to_string(state.segment_frames) + " frames per segment)");
+        decodeSegment(state, 0);
+    }
+
+    void BatchProcessor::decodeSegment(JobState &state, int segment_index)
+    {
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (state.failed)
+            {
+                return;
+            }
+        }
+
+        // Backpressure: without room for the segment, decode again once written segments free some
+        const std::size_t segment_bytes = state.frame_bytes * static_cast<std::size_t>(state.segment_frames);
+        if (memory_budget_ &&
+            !memory_budget_->tryAcquire(segment_bytes, [this, &state, segment_index]
+                                        { pool_.submit([this, &state, segment_index]
+                                                       { decodeSegment(state, segment_index); }); }))
+        {
+            return;
+        }
+        auto lease = std::make_shared<utils::MemoryLease>(memory_budget_, segment_bytes);
+
+        std::vector<cv::Mat> frames;
+        frames.reserve(state.segment_frames);
+        cv::Mat frame;
+        while (static_cast<int>(frames.size()) < state.segment_frames && state.loader.getCapture().read(frame))
+        {
+            frames.push_back(frame.clone());
+        }
+
+        const int decoded = static_cast<int>(frames.size());
+        const bool reached_end = decoded < state.segment_frames;
+        const bool sequential = state.sequential != nullptr;
+        if (!reached_end && !sequential)
+        {
+            // Queue the next decode before this segment's stylization so the
+            // owning worker stylizes while an idle worker steals the decoder
+            pool_.submit([this, &state, segment_index]
+                         { decodeSegment(state, segment_index + 1); });
+        }
+
+        if (decoded > 0)
+        {
+            // A sequential job decodes the next segment only once this one starts: one segment ahead
+            const bool decode_next = !reached_end && sequential;
+            std::function<void()> stylize = [this, &state, segment_index, frames = std::move(frames), lease,
+                                             decode_next]() mutable
+            {
+                if (decode_next)
+                {
+                    pool_.submit([this, &state, segment_index]
+                                 { decodeSegment(state, segment_index + 1); });
+                }
+                stylizeSegment(state, segment_index, std::move(frames), std::move(lease));
+            };
+
+            // Segments wait for loadStyle() and, in optimize mode, for the previous segment
+            std::vector<std::function<void()>> runnable;
+            {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                if (!state.failed)
+                {
+                    state.queued_segments.push_back(std::move(stylize));
+                    runnable = takeRunnableSegments(state);
+                }
+            }
+            for (auto &task : runnable)
+            {
+                pool_.submit(std::move(task));
+            }
+        }
+
+        if (!reached_end)
+        {
+            return;
+        }
+
+        state.loader.getCapture().release();
+        if (segment_index == 0 && decoded == 0)
+        {
+            failJob(state, "input video contains no frames");
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.total_segments = decoded > 0 ? segment_index + 1 : segment_index;
+        // All segments may already have been written before the end was known
+        writeReadySegments(state);
+    }
+
+    void BatchProcessor::stylizeSegment(JobState &state, int segment_index, std::vector<cv::Mat> frames,
+                                        std::shared_ptr<utils::MemoryLease> lease)
+    {
+        std::shared_ptr<const style_transfer::PreparedStyle> style;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            style = state.style;
+        }
+
+        // Only one segment of a sequential job runs at a time, so its transfer needs no lock
+        std::optional<style_transfer::NeuralStyleTransfer> local;
+        if (!state.sequential)
+        {
+            local.emplace();
+            configure(*local);
+        }
+        style_transfer::NeuralStyleTransfer &style_transfer = state.sequential ? *state.sequential : *local;
+        if (!style_transfer.isStyleLoaded())
+        {
+            style_transfer.setPreparedStyle(*style);
+        }
+
+        std::optional<FrameDedupeCache> cache;
+        if (dedupe_capacity_ > 0)
+        {
+            cache.emplace(dedupe_capacity_, dedupe_tolerance_);
+        }
+
+        cv::Mat stylized;
+        for (auto &frame : frames)
+        {
+            FrameSignature signature;
+            if (cache)
+            {
+                signature = FrameDedupeCache::computeSignature(frame);
+                if (cache->lookup(signature, frame))
+                {
+                    continue;
+                }
+            }
+
+            if (!style_transfer.applyStyleTransfer(frame, stylized))
+            {
+                failJob(state, "style transfer failed in segment " + std::to_string(segment_index));
+                return;
+            }
+            if (cache)
+            {
+                cache->insert(signature, stylized);
+            }
+            frame = stylized.clone();
+        }
+
+        std::vector<std::function<void()>> runnable;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (cache)
+            {
+                state.report.frames_reused += static_cast<int>(cache->getHits());
+            }
+            state.ready_segments.emplace(segment_index, ReadySegment{std::move(frames), std::move(lease)});
+            writeReadySegments(state);
+            state.stylizing = false;
+            runnable = takeRunnableSegments(state);
+        }
+        for (auto &task : runnable)
+        {
+            pool_.submit(std::move(task));
+        }
+    }
+
+    std::vector<std::function<void()>> BatchProcessor::takeRunnableSegments(JobState &state)
+    {
+        std::vector<std::function<void()>> runnable;
+        if (!state.style || state.failed)
+        {
+            return runnable;
+        }
+
+        if (!state.sequential)
+        {
+            std::move(state.queued_segments.begin(), state.queued_segments.end(), std::back_inserter(runnable));
+            state.queued_segments.clear();
+        }
+        else if (!state.stylizing && !state.queued_segments.empty())
+        {
+            // Segments are queued in decode order, which is the warm-start order
+            state.stylizing = true;
+            runnable.push_back(std::move(state.queued_segments.front()));
+            state.queued_segments.pop_front();
+        }
+        return runnable;
+    }
+
+    void BatchProcessor::writeReadySegments(JobState &state)
+    {
+        if (state.failed)
+        {
+            state.ready_segments.clear();
+            return;
+        }
+
+        // Write every segment that is now contiguous with what has been written
+        auto it = state.ready_segments.find(state.next_segment_to_write);
+        while (it != state.ready_segments.end())
+        {
+            for (const auto &frame : it->second.frames)
+            {
+                state.writer.write(frame);
+            }
+            state.report.frames_processed += static_cast<int>(it->second.frames.size());
+            state.ready_segments.erase(it); // Releases its budget and resumes waiting decoders
+            it = state.ready_segments.find(++state.next_segment_to_write);
+        }
+
+        if (state.total_segments >= 0 && state.next_segment_to_write == state.total_segments &&
+            state.report.status == JobStatus::RUNNING)
+        {
+            state.writer.release();
+            state.report.status = JobStatus::COMPLETED;
+            state.report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - state.start_time).count();
+            utils::Logger::getInstance()->info("Completed job: " + state.report.job.output_path + " (" +
+                                               std::to_string(state.report.frames_processed) + " frames)");
+        }
+    }
+
+    void BatchProcessor::failJob(JobState &state, const std::string &error)
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.failed)
+        {
+            return;
+        }
+
+        state.failed = true;
+        state.ready_segments.clear();
+        state.queued_segments.clear();
+        state.writer.release();
+        state.report.status = JobStatus::FAILED;
+        state.report.error = error;
+        state.report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - state.start_time).count();
+        utils::Logger::getInstance()->error("Job failed (" + state.report.job.input_path + "): " + error);
+    }
+
+    std::string jobStatusToString(JobStatus status)
+    {
+        switch (status)
+        {
+        case JobStatus::PENDING:
+            return "PENDING";
+        case JobStatus::RUNNING:
+            return "RUNNING";
+        case JobStatus::COMPLETED:
+            return "COMPLETED";
+        case JobStatus::FAILED:
+            return "FAILED";
+        default:
+            return "UNKNOWN";
+        }
+    }
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,115 @@
+#include "video_processor/decode_ahead.hpp"
+
+#include <algorithm>
+
+namespace video_styler::video_processor
+{
+
+    DecodeAhead::DecodeAhead(FrameSource source, std::size_t frame_bytes, std::size_t max_queued,
+                             utils::MemoryBudget *budget)
+        : source_(std::move(source)),
+          frame_bytes_(frame_bytes),
+          max_queued_(std::max<std::size_t>(1, max_queued)),
+          budget_(budget)
+    {
+        thread_ = std::thread(&DecodeAhead::decodeLoop, this);
+    }
+
+    DecodeAhead::DecodeAhead(cv::VideoCapture &capture, std::size_t frame_bytes, std::size_t max_queued,
+                             utils::MemoryBudget *budget)
+        : DecodeAhead([&capture](cv::Mat &frame)
+                      { return capture.read(frame); },
+                      frame_bytes, max_queued, budget)
+    {
+    }
+
+    DecodeAhead::~DecodeAhead()
+    {
+        stop();
+    }
+
+    bool DecodeAhead::read(DecodedFrame &frame)
+    {
+        // Give the previous frame's bytes back first, or a one-frame budget could never refill
+        frame = DecodedFrame();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        queue_cv_.wait(lock, [this]
+                       { return !queue_.empty() || finished_; });
+        if (queue_.empty())
+        {
+            return false;
+        }
+
+        frame = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+        queue_cv_.notify_all();
+        return true;
+    }
+
+    void DecodeAhead::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        queue_cv_.notify_all();
+        if (budget_)
+        {
+            budget_->cancelWaits();
+        }
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.clear();
+        finished_ = true;
+    }
+
+    std::size_t DecodeAhead::getPeakQueued() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return peak_queued_;
+    }
+
+    void DecodeAhead::decodeLoop()
+    {
+        while (!stopping_)
+        {
+            // Wait for a free slot, then for room in the budget: both are backpressure
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                queue_cv_.wait(lock, [this]
+                               { return stopping_ || queue_.size() < max_queued_; });
+            }
+            if (stopping_ || (budget_ && !budget_->acquire(frame_bytes_, stopping_)))
+            {
+                break;
+            }
+
+            DecodedFrame decoded;
+            decoded.lease = utils::MemoryLease(budget_, frame_bytes_);
+            if (!source_(decoded.image) || decoded.image.empty())
+            {
+                break;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                queue_.push_back(std::move(decoded));
+                peak_queued_ = std::max(peak_queued_, queue_.size());
+            }
+            queue_cv_.notify_all();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_ = true;
+        }
+        queue_cv_.notify_all();
+    }
+
+} // namespace video_styler::video_processor
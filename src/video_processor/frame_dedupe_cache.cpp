@@ -0,0 +1,193 @@
+#include "video_processor/frame_dedupe_cache.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <string_view>
+
+namespace video_styler::video_processor
+{
+
+    namespace
+    {
+        // Frames whose channel means differ by more than this are never shared, so fades
+        // and tints (which leave the gradient pattern and thus dHash unchanged) restylize
+        constexpr double kMeanTolerance = 1.5;
+
+        // Side of the thumbnail that confirms a near repeat, and the largest difference it may show
+        constexpr int kDetailSide = 32;
+        constexpr double kDetailTolerance = 6.0;
+
+        /**
+         * @brief Hash every pixel of a frame, row by row so padded ROIs hash like their copies
+         */
+        std::uint64_t contentHash(const cv::Mat &frame)
+        {
+            std::uint64_t hash = (static_cast<std::uint64_t>(frame.rows) << 32) ^
+                                 (static_cast<std::uint64_t>(frame.cols) << 8) ^ static_cast<std::uint64_t>(frame.type());
+            const std::size_t row_bytes = frame.cols * frame.elemSize();
+            for (int y = 0; y < frame.rows; ++y)
+            {
+                const std::string_view row(reinterpret_cast<const char *>(frame.ptr(y)), row_bytes);
+                hash = (hash ^ std::hash<std::string_view>{}(row)) * 0x9E3779B97F4A7C15ull;
+            }
+            return hash;
+        }
+
+        bool detailsMatch(const cv::Mat &a, const cv::Mat &b)
+        {
+            if (a.size() != b.size() || a.type() != b.type())
+            {
+                return false;
+            }
+            return a.empty() || cv::norm(a, b, cv::NORM_INF) <= kDetailTolerance;
+        }
+
+        bool meansMatch(const cv::Scalar &a, const cv::Scalar &b)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                if (std::abs(a[c] - b[c]) > kMeanTolerance)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    } // namespace
+
+    FrameDedupeCache::FrameDedupeCache(std::size_t capacity, int tolerance)
+        : capacity_(std::max<std::size_t>(1, capacity)),
+          tolerance_(std::clamp(tolerance, 0, 64))
+    {
+    }
+
+    FrameSignature FrameDedupeCache::computeSignature(const cv::Mat &frame)
+    {
+        FrameSignature signature;
+        signature.content = contentHash(frame);
+        cv::resize(frame, signature.detail, cv::Size(kDetailSide, kDetailSide), 0, 0, cv::INTER_AREA);
+
+        // Shrink first so the color conversion only touches 72 pixels
+        cv::Mat thumbnail;
+        cv::resize(signature.detail, thumbnail, cv::Size(9, 8), 0, 0, cv::INTER_AREA);
+        thumbnail.convertTo(thumbnail, CV_32F);
+
+        cv::Mat gray;
+        if (thumbnail.channels() == 3)
+        {
+            cv::cvtColor(thumbnail, gray, cv::COLOR_BGR2GRAY);
+        }
+        else if (thumbnail.channels() == 4)
+        {
+            cv::cvtColor(thumbnail, gray, cv::COLOR_BGRA2GRAY);
+        }
+        else
+        {
+            gray = thumbnail;
+        }
+
+        // One bit per horizontally adjacent pair: is the right pixel brighter?
+        for (int y = 0; y < 8; ++y)
+        {
+            const float *row = gray.ptr<float>(y);
+            for (int x = 0; x < 8; ++x)
+            {
+                signature.hash = (signature.hash << 1) | (row[x + 1] > row[x] ? 1u : 0u);
+            }
+        }
+        signature.mean = cv::mean(thumbnail);
+        return signature;
+    }
+
+    int FrameDedupeCache::hammingDistance(std::uint64_t a, std::uint64_t b)
+    {
+        return std::popcount(a ^ b);
+    }
+
+    bool FrameDedupeCache::lookup(const FrameSignature &signature, cv::Mat &output)
+    {
+        ++lookups_;
+
+        auto best = entries_.end();
+        int best_distance = tolerance_ + 1;
+        for (auto it = entries_.begin(); it != entries_.end(); ++it)
+        {
+            if (!meansMatch(it->signature.mean, signature.mean))
+            {
+                continue;
+            }
+            const int distance = hammingDistance(it->signature.hash, signature.hash);
+            if (distance >= best_distance)
+            {
+                continue;
+            }
+
+            // Confirm the candidate on the full frame (exact) or the detail thumbnail (near)
+            const bool confirmed = tolerance_ == 0 ? it->signature.content == signature.content
+                                                   : detailsMatch(it->signature.detail, signature.detail);
+            if (confirmed)
+            {
+                best = it;
+                best_distance = distance;
+            }
+        }
+
+        if (best == entries_.end())
+        {
+            return false;
+        }
+
+        ++hits_;
+        entries_.splice(entries_.begin(), entries_, best);
+        // Copy, so a caller reusing the output buffer cannot corrupt the cache
+        entries_.front().output.copyTo(output);
+        return true;
+    }
+
+    void FrameDedupeCache::insert(const FrameSignature &signature, const cv::Mat &output)
+    {
+        entries_.push_front({signature, output.clone()});
+        if (entries_.size() > capacity_)
+        {
+            entries_.pop_back();
+        }
+    }
+
+    void FrameDedupeCache::clear()
+    {
+        entries_.clear();
+    }
+
+    std::size_t FrameDedupeCache::size() const
+    {
+        return entries_.size();
+    }
+
+    std::size_t FrameDedupeCache::getLookups() const
+    {
+        return lookups_;
+    }
+
+    std::size_t FrameDedupeCache::getHits() const
+    {
+        return hits_;
+    }
+
+    double FrameDedupeCache::getHitRate() const
+    {
+        return lookups_ > 0 ? static_cast<double>(hits_) / lookups_ : 0.0;
+    }
+
+    std::string FrameDedupeCache::describe() const
+    {
+        std::stringstream ss;
+        ss << hits_ << "/" << lookups_ << " frames reused (" << std::fixed << std::setprecision(1)
+           << getHitRate() * 100.0 << "% hit rate, tolerance " << tolerance_ << " bits)";
+        return ss.str();
+    }
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,224 @@
+#include "video_processor/frame_store.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace video_styler::video_processor
+{
+
+    namespace fs = std::filesystem;
+
+    FrameStore::~FrameStore()
+    {
+        close();
+    }
+
+    FrameStore::FrameStore(FrameStore &&other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    FrameStore &FrameStore::operator=(FrameStore &&other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            mapping_ = std::exchange(other.mapping_, nullptr);
+            mapping_bytes_ = std::exchange(other.mapping_bytes_, 0);
+            stride_ = std::exchange(other.stride_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+            frame_size_ = std::exchange(other.frame_size_, cv::Size());
+            type_ = std::exchange(other.type_, 0);
+            written_ = std::move(other.written_);
+            other.written_.clear();
+        }
+        return *this;
+    }
+
+    bool FrameStore::create(int capacity, cv::Size frame_size, int type, const std::string &directory)
+    {
+        close();
+
+        auto logger = utils::Logger::getInstance();
+        if (capacity <= 0 || frame_size.width <= 0 || frame_size.height <= 0)
+        {
+            logger->error("Invalid frame store geometry");
+            return false;
+        }
+
+        // Page-aligned stride so every frame can be advised and evicted on its own
+        const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const std::size_t frame_bytes = static_cast<std::size_t>(frame_size.area()) * CV_ELEM_SIZE(type);
+        const std::size_t stride = (frame_bytes + page_size - 1) / page_size * page_size;
+        const std::size_t total_bytes = stride * static_cast<std::size_t>(capacity);
+
+        const fs::path base_dir = directory.empty() ? fs::temp_directory_path() : fs::path(directory);
+        std::string file_template = (base_dir / "video_styler_frames_XXXXXX").string();
+
+        const int fd = mkstemp(file_template.data());
+        if (fd < 0)
+        {
+            logger->error("Failed to create frame store in " + base_dir.string() + ": " + std::strerror(errno));
+            return false;
+        }
+
+        // Unlink immediately: the mapping keeps the data alive and the kernel
+        // reclaims the space on close, exit or crash
+        unlink(file_template.c_str());
+
+        // Reserve the blocks up front: a sparse file would turn a full disk into
+        // SIGBUS on the first write through the mapping instead of an error here
+        const int error = posix_fallocate(fd, 0, static_cast<off_t>(total_bytes));
+        if (error != 0)
+        {
+            logger->error("Failed to reserve " + std::to_string(total_bytes / (1024 * 1024)) +
+                          " MiB for frame store in " + base_dir.string() + ": " + std::strerror(error));
+            ::close(fd);
+            return false;
+        }
+
+        void *mapping = mmap(nullptr, total_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            logger->error("Failed to map frame store: " + std::string(std::strerror(errno)));
+            return false;
+        }
+
+        mapping_ = static_cast<unsigned char *>(mapping);
+        mapping_bytes_ = total_bytes;
+        stride_ = stride;
+        capacity_ = capacity;
+        frame_size_ = frame_size;
+        type_ = type;
+        written_.assign(capacity, false);
+
+        logger->debug("Frame store mapped: " + std::to_string(capacity) + " frames, " +
+                      std::to_string(total_bytes / (1024 * 1024)) + " MiB");
+        return true;
+    }
+
+    bool FrameStore::write(int index, const cv::Mat &frame)
+    {
+        if (!isOpen() || index < 0 || index >= capacity_ || frame.size() != frame_size_ || frame.type() != type_)
+        {
+            return false;
+        }
+
+        cv::Mat destination(frame_size_, type_, mapping_ + stride_ * index);
+        frame.copyTo(destination);
+        written_[index] = true;
+        return true;
+    }
+
+    bool FrameStore::read(int index, cv::Mat &frame) const
+    {
+        const cv::Mat stored = view(index);
+        if (stored.empty())
+        {
+            return false;
+        }
+
+        stored.copyTo(frame);
+        return true;
+    }
+
+    cv::Mat FrameStore::view(int index) const
+    {
+        if (!contains(index))
+        {
+            return cv::Mat();
+        }
+
+        return cv::Mat(frame_size_, type_, mapping_ + stride_ * index);
+    }
+
+    bool FrameStore::contains(int index) const
+    {
+        return isOpen() && index >= 0 && index < capacity_ && written_[index];
+    }
+
+    void FrameStore::adviseAccessPattern(AccessPattern pattern)
+    {
+        switch (pattern)
+        {
+        case AccessPattern::SEQUENTIAL:
+            advise(0, capacity_, MADV_SEQUENTIAL);
+            break;
+        case AccessPattern::RANDOM:
+            advise(0, capacity_, MADV_RANDOM);
+            break;
+        case AccessPattern::NORMAL:
+        default:
+            advise(0, capacity_, MADV_NORMAL);
+            break;
+        }
+    }
+
+    void FrameStore::prefetch(int first, int count)
+    {
+        advise(first, count, MADV_WILLNEED);
+    }
+
+    void FrameStore::evict(int first, int count)
+    {
+        // Shared file mapping: pages are written back and dropped, not lost
+        advise(first, count, MADV_DONTNEED);
+    }
+
+    void FrameStore::close()
+    {
+        if (mapping_ != nullptr)
+        {
+            munmap(mapping_, mapping_bytes_);
+        }
+
+        mapping_ = nullptr;
+        mapping_bytes_ = 0;
+        stride_ = 0;
+        capacity_ = 0;
+        frame_size_ = cv::Size();
+        type_ = 0;
+        written_.clear();
+    }
+
+    bool FrameStore::isOpen() const
+    {
+        return mapping_ != nullptr;
+    }
+
+    int FrameStore::getCapacity() const
+    {
+        return capacity_;
+    }
+
+    std::size_t FrameStore::getStride() const
+    {
+        return stride_;
+    }
+
+    void FrameStore::advise(int first, int count, int advice)
+    {
+        if (!isOpen())
+        {
+            return;
+        }
+
+        first = std::clamp(first, 0, capacity_);
+        const int last = std::clamp(first + std::max(count, 0), first, capacity_);
+        if (last == first)
+        {
+            return;
+        }
+
+        madvise(mapping_ + stride_ * first, stride_ * (last - first), advice);
+    }
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,116 @@
+#include "video_processor/live_capture.hpp"
+
+namespace video_styler::video_processor
+{
+
+    LiveCapture::LiveCapture(FrameSource source)
+        : source_(std::move(source))
+    {
+    }
+
+    LiveCapture::LiveCapture(cv::VideoCapture &capture)
+        : source_([&capture](cv::Mat &frame)
+                  { return capture.read(frame); })
+    {
+    }
+
+    LiveCapture::~LiveCapture()
+    {
+        stop();
+    }
+
+    bool LiveCapture::start()
+    {
+        if (running_.exchange(true))
+        {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_ = false;
+        }
+        thread_ = std::thread([this]
+                              { captureLoop(); });
+        return true;
+    }
+
+    void LiveCapture::stop()
+    {
+        running_ = false;
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    bool LiveCapture::waitForFrame(CapturedFrame &frame, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!frame_cv_.wait_for(lock, timeout, [this]
+                                { return has_unconsumed_ || finished_; }) ||
+            !has_unconsumed_)
+        {
+            return false;
+        }
+
+        frame = std::move(latest_);
+        has_unconsumed_ = false;
+        return true;
+    }
+
+    bool LiveCapture::isFinished() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return finished_ && !has_unconsumed_;
+    }
+
+    std::uint64_t LiveCapture::getCapturedFrames() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return captured_;
+    }
+
+    std::uint64_t LiveCapture::getDroppedFrames() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return dropped_;
+    }
+
+    void LiveCapture::captureLoop()
+    {
+        cv::Mat frame;
+        while (running_)
+        {
+            if (!source_(frame) || frame.empty())
+            {
+                break;
+            }
+
+            // Timestamp as close to the grab as possible for glass-to-glass latency
+            const auto capture_time = std::chrono::steady_clock::now();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (has_unconsumed_)
+                {
+                    ++dropped_;
+                }
+                // Swap in a fresh buffer so the consumer's frame is never overwritten
+                latest_.image = frame;
+                latest_.capture_time = capture_time;
+                latest_.sequence = captured_++;
+                has_unconsumed_ = true;
+            }
+            frame_cv_.notify_one();
+            frame = cv::Mat();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_ = true;
+        }
+        frame_cv_.notify_all();
+    }
+
+} // namespace video_styler::video_processor
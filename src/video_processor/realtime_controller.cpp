@@ -0,0 +1,163 @@
+#include "video_processor/realtime_controller.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+#include <iomanip>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+namespace video_styler::video_processor
+{
+
+    namespace
+    {
+        // Weight of the newest sample in the latency moving average
+        constexpr double kSmoothing = 0.2;
+        // Frames to wait after a change before stepping down again
+        constexpr int kDownHoldFrames = 3;
+        // Frames the average must stay under the headroom before stepping up
+        constexpr int kUpHoldFrames = 30;
+        // Fraction of the budget below which a better level is attempted
+        constexpr double kUpHeadroom = 0.6;
+    } // namespace
+
+    RealtimeController::RealtimeController(double target_fps, double latency_budget_ms)
+        : levels_(defaultLevels(QualityLevel().iterations)),
+          budget_ms_(latency_budget_ms > 0.0 ? latency_budget_ms : 1000.0 / std::max(target_fps, 1.0))
+    {
+    }
+
+    std::vector<QualityLevel> RealtimeController::defaultLevels(int iterations)
+    {
+        iterations = std::max(1, iterations);
+        auto share = [iterations](int numerator, int denominator)
+        {
+            return std::max(1, iterations * numerator / denominator);
+        };
+        return {{1.0, iterations}, {0.75, share(2, 5)}, {0.5, share(1, 5)}, {0.35, share(1, 10)}, {0.25, share(1, 25)}};
+    }
+
+    void RealtimeController::setLevels(std::vector<QualityLevel> levels)
+    {
+        if (levels.empty())
+        {
+            return;
+        }
+
+        levels_ = std::move(levels);
+        changeLevel(std::min(level_, getLevelCount() - 1));
+    }
+
+    bool RealtimeController::shouldDrop(double lateness_ms)
+    {
+        if (lateness_ms > budget_ms_)
+        {
+            ++dropped_;
+            return true;
+        }
+        return false;
+    }
+
+    bool RealtimeController::recordLatency(double latency_ms)
+    {
+        average_ms_ = processed_ == 0 ? latency_ms : kSmoothing * latency_ms + (1.0 - kSmoothing) * average_ms_;
+        ++processed_;
+        ++frames_since_change_;
+
+        if (average_ms_ > budget_ms_ && level_ + 1 < getLevelCount() && frames_since_change_ >= kDownHoldFrames)
+        {
+            changeLevel(level_ + 1);
+            return true;
+        }
+
+        if (average_ms_ < budget_ms_ * kUpHeadroom && level_ > 0 && frames_since_change_ >= kUpHoldFrames)
+        {
+            changeLevel(level_ - 1);
+            return true;
+        }
+
+        return false;
+    }
+
+    const QualityLevel &RealtimeController::getLevel() const
+    {
+        return levels_[level_];
+    }
+
+    int RealtimeController::getLevelIndex() const
+    {
+        return level_;
+    }
+
+    int RealtimeController::getLevelCount() const
+    {
+        return static_cast<int>(levels_.size());
+    }
+
+    double RealtimeController::getAverageLatency() const
+    {
+        return average_ms_;
+    }
+
+    double RealtimeController::getLatencyBudget() const
+    {
+        return budget_ms_;
+    }
+
+    int RealtimeController::getProcessedFrames() const
+    {
+        return processed_;
+    }
+
+    int RealtimeController::getDroppedFrames() const
+    {
+        return dropped_;
+    }
+
+    std::string RealtimeController::describe() const
+    {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(2)
+           << "level " << level_ + 1 << "/" << getLevelCount()
+           << " (scale " << getLevel().scale << ", iterations " << getLevel().iterations << ")"
+           << ", avg latency " << average_ms_ << " ms / budget " << budget_ms_ << " ms"
+           << ", dropped " << dropped_ << "/" << dropped_ + processed_;
+        return ss.str();
+    }
+
+    bool RealtimeController::writeStatus(const std::string &filepath) const
+    {
+        boost::property_tree::ptree status;
+        status.put("level", level_);
+        status.put("level_count", getLevelCount());
+        status.put("scale", getLevel().scale);
+        status.put("iterations", getLevel().iterations);
+        status.put("average_latency_ms", average_ms_);
+        status.put("latency_budget_ms", budget_ms_);
+        status.put("processed_frames", processed_);
+        status.put("dropped_frames", dropped_);
+
+        // Write then rename so readers never observe a partial file
+        const std::string temp_path = filepath + ".tmp";
+        try
+        {
+            boost::property_tree::write_json(temp_path, status);
+        }
+        catch (const boost::property_tree::json_parser_error &)
+        {
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temp_path, filepath, ec);
+        return !ec;
+    }
+
+    void RealtimeController::changeLevel(int level)
+    {
+        level_ = level;
+        frames_since_change_ = 0;
+    }
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,160 @@
+#include "video_processor/region_mask.hpp"
+
+#include <sstream>
+
+namespace video_styler::video_processor
+{
+
+    namespace
+    {
+        // Matte values at or below this count as background (compression noise)
+        constexpr double kMatteNoiseFloor = 8.0;
+
+        cv::Mat toGray(const cv::Mat &image)
+        {
+            cv::Mat gray;
+            if (image.channels() == 3)
+            {
+                cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+            }
+            else if (image.channels() == 4)
+            {
+                cv::cvtColor(image, gray, cv::COLOR_BGRA2GRAY);
+            }
+            else
+            {
+                gray = image;
+            }
+            if (gray.depth() != CV_8U)
+            {
+                gray.convertTo(gray, CV_8U);
+            }
+            return gray;
+        }
+    } // namespace
+
+    bool RegionMask::setRectangle(const cv::Rect &rect)
+    {
+        if (rect.empty())
+        {
+            return false;
+        }
+        source_ = RegionSource::RECTANGLE;
+        rect_ = rect;
+        current_.release();
+        return true;
+    }
+
+    bool RegionMask::loadImage(const std::string &filepath)
+    {
+        const cv::Mat image = cv::imread(filepath, cv::IMREAD_GRAYSCALE);
+        if (image.empty())
+        {
+            return false;
+        }
+        source_ = RegionSource::IMAGE;
+        image_ = image;
+        current_.release();
+        return true;
+    }
+
+    bool RegionMask::openMatte(const std::string &filepath)
+    {
+        if (!matte_.loadVideo(filepath))
+        {
+            return false;
+        }
+        source_ = RegionSource::MATTE;
+        matte_exhausted_ = false;
+        current_.release();
+        return true;
+    }
+
+    bool RegionMask::next(const cv::Size &frame_size, cv::Mat &mask)
+    {
+        switch (source_)
+        {
+        case RegionSource::NONE:
+            return false;
+
+        case RegionSource::RECTANGLE:
+            if (current_.size() != frame_size)
+            {
+                current_ = cv::Mat::zeros(frame_size, CV_8UC1);
+                current_(rect_ & cv::Rect(0, 0, frame_size.width, frame_size.height)).setTo(255);
+            }
+            break;
+
+        case RegionSource::IMAGE:
+            if (current_.size() != frame_size)
+            {
+                cv::resize(image_, current_, frame_size, 0, 0, cv::INTER_LINEAR);
+            }
+            break;
+
+        case RegionSource::MATTE:
+        {
+            cv::Mat frame;
+            if (!matte_exhausted_ && matte_.getCapture().read(frame))
+            {
+                cv::Mat gray = toGray(frame);
+                if (gray.size() != frame_size)
+                {
+                    cv::resize(gray, gray, frame_size, 0, 0, cv::INTER_LINEAR);
+                }
+                cv::threshold(gray, current_, kMatteNoiseFloor, 255, cv::THRESH_TOZERO);
+            }
+            else
+            {
+                // Keep the last matte frame for the rest of the input
+                matte_exhausted_ = true;
+                if (current_.empty())
+                {
+                    return false;
+                }
+                if (current_.size() != frame_size)
+                {
+                    cv::resize(current_, current_, frame_size, 0, 0, cv::INTER_LINEAR);
+                }
+            }
+            break;
+        }
+        }
+
+        mask = current_;
+        return true;
+    }
+
+    RegionSource RegionMask::getSource() const
+    {
+        return source_;
+    }
+
+    bool RegionMask::isMatteExhausted() const
+    {
+        return matte_exhausted_;
+    }
+
+    bool RegionMask::parseRectangle(const std::string &text, cv::Rect &rect)
+    {
+        std::stringstream ss(text);
+        int values[4];
+        char separator = ',';
+        for (int i = 0; i < 4; ++i)
+        {
+            if ((i > 0 && (!(ss >> separator) || separator != ',')) || !(ss >> values[i]))
+            {
+                return false;
+            }
+        }
+        ss >> std::ws;
+        if (!ss.eof() || values[2] <= 0 || values[3] <= 0)
+        {
+            return false;
+        }
+
+        rect = cv::Rect(values[0], values[1], values[2], values[3]);
+        return true;
+    }
+
+} // namespace video_styler::video_processor
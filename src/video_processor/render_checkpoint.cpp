@@ -0,0 +1,227 @@
+#include "video_processor/render_checkpoint.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace video_styler::video_processor
+{
+
+    namespace
+    {
+        constexpr const char *kCheckpointFile = "checkpoint.yml";
+        // Keeps the .yml extension so FileStorage picks the same format
+        constexpr const char *kPartialCheckpointFile = "checkpoint.partial.yml";
+
+        std::string segmentFileName(std::size_t index)
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "segment_%06zu.vsseg", index);
+            return name;
+        }
+    } // namespace
+
+    RenderCheckpoint::RenderCheckpoint(const std::string &output_path, std::string job_key, int interval)
+        : directory_(output_path + ".checkpoint"),
+          job_key_(std::move(job_key)),
+          interval_(std::max(1, interval))
+    {
+    }
+
+    ResumeResult RenderCheckpoint::resume(style_transfer::NeuralStyleTransfer &style_transfer)
+    {
+        auto logger = utils::Logger::getInstance();
+
+        cv::FileStorage storage;
+        if (!fs::exists(pathOf(kCheckpointFile)) || !storage.open(pathOf(kCheckpointFile), cv::FileStorage::READ))
+        {
+            logger->info("No checkpoint in " + directory_ + "; starting from the first frame");
+            return start() ? ResumeResult::STARTED_FRESH : ResumeResult::FAILED;
+        }
+
+        std::string job_key;
+        storage["job"] >> job_key;
+        if (job_key != job_key_)
+        {
+            logger->warning("Checkpoint in " + directory_ + " belongs to a different input or settings; starting over");
+            storage.release();
+            return start() ? ResumeResult::STARTED_FRESH : ResumeResult::FAILED;
+        }
+
+        std::vector<CheckpointSegment> segments;
+        int frames = 0;
+        const cv::FileNode segment_nodes = storage["segments"];
+        for (std::size_t i = 0; i < segment_nodes.size(); ++i)
+        {
+            CheckpointSegment segment;
+            segment_nodes[static_cast<int>(i)]["file"] >> segment.file;
+            segment_nodes[static_cast<int>(i)]["first_frame"] >> segment.first_frame;
+            segment_nodes[static_cast<int>(i)]["frame_count"] >> segment.frame_count;
+            if (segment.first_frame != frames || segment.frame_count <= 0 || !fs::exists(pathOf(segment.file)))
+            {
+                logger->warning("Checkpoint in " + directory_ + " references a missing segment; starting over");
+                storage.release();
+                return start() ? ResumeResult::STARTED_FRESH : ResumeResult::FAILED;
+            }
+            frames += segment.frame_count;
+            segments.push_back(segment);
+        }
+
+        if (!style_transfer.loadTemporalState(storage["temporal"]))
+        {
+            logger->warning("Checkpoint temporal state is unreadable; the first resumed frame starts cold");
+        }
+        storage.release();
+
+        // Anything else was written after the last checkpoint and is rendered again
+        std::error_code ec;
+        for (const auto &entry : fs::directory_iterator(directory_, ec))
+        {
+            const std::string name = entry.path().filename().string();
+            const bool committed = std::any_of(segments.begin(), segments.end(),
+                                               [&name](const CheckpointSegment &segment)
+                                               { return segment.file == name; });
+            if (!committed && name != kCheckpointFile)
+            {
+                fs::remove(entry.path(), ec);
+            }
+        }
+
+        segments_ = std::move(segments);
+        committed_frames_ = frames;
+        logger->info("Resuming from checkpoint: " + std::to_string(committed_frames_) + " frames in " +
+                     std::to_string(segments_.size()) + " segments");
+        return ResumeResult::RESUMED;
+    }
+
+    bool RenderCheckpoint::start()
+    {
+        segment_writer_.reset();
+        segment_stream_.reset();
+        segments_.clear();
+        committed_frames_ = 0;
+
+        std::error_code ec;
+        fs::remove_all(directory_, ec);
+        fs::create_directories(directory_, ec);
+        return !ec;
+    }
+
+    bool RenderCheckpoint::write(const cv::Mat &frame, const style_transfer::NeuralStyleTransfer &style_transfer)
+    {
+        if (!segment_writer_ && !openSegment())
+        {
+            return false;
+        }
+        if (!segment_writer_->write(frame))
+        {
+            return false;
+        }
+        return segment_writer_->getFrameCount() < interval_ || flush(style_transfer);
+    }
+
+    bool RenderCheckpoint::flush(const style_transfer::NeuralStyleTransfer &style_transfer)
+    {
+        if (!segment_writer_ || segment_writer_->getFrameCount() == 0)
+        {
+            return true;
+        }
+
+        const int frame_count = segment_writer_->getFrameCount();
+        segment_writer_.reset();
+        segment_stream_->close();
+        const bool written = !segment_stream_->fail();
+        segment_stream_.reset();
+        if (!written)
+        {
+            return false;
+        }
+
+        segments_.push_back({segment_file_, committed_frames_, frame_count});
+        committed_frames_ += frame_count;
+        return writeCheckpoint(style_transfer);
+    }
+
+    bool RenderCheckpoint::stitch(cv::VideoWriter &writer) const
+    {
+        SegmentStitcher stitcher(writer);
+        for (const auto &segment : segments_)
+        {
+            if (!stitcher.append(pathOf(segment.file)))
+            {
+                return false;
+            }
+        }
+        return stitcher.getFramesWritten() == committed_frames_;
+    }
+
+    void RenderCheckpoint::remove() const
+    {
+        std::error_code ec;
+        fs::remove_all(directory_, ec);
+    }
+
+    int RenderCheckpoint::getCommittedFrames() const
+    {
+        return committed_frames_;
+    }
+
+    const std::vector<CheckpointSegment> &RenderCheckpoint::getSegments() const
+    {
+        return segments_;
+    }
+
+    const std::string &RenderCheckpoint::getDirectory() const
+    {
+        return directory_;
+    }
+
+    bool RenderCheckpoint::openSegment()
+    {
+        segment_file_ = segmentFileName(segments_.size());
+        segment_stream_ = std::make_unique<std::ofstream>(pathOf(segment_file_), std::ios::binary | std::ios::trunc);
+        if (!*segment_stream_)
+        {
+            segment_stream_.reset();
+            return false;
+        }
+        segment_writer_ = std::make_unique<SegmentWriter>(*segment_stream_);
+        return true;
+    }
+
+    bool RenderCheckpoint::writeCheckpoint(const style_transfer::NeuralStyleTransfer &style_transfer) const
+    {
+        const std::string partial = pathOf(kPartialCheckpointFile);
+        cv::FileStorage storage(partial, cv::FileStorage::WRITE_BASE64);
+        if (!storage.isOpened())
+        {
+            return false;
+        }
+
+        storage << "job" << job_key_;
+        storage << "committed_frames" << committed_frames_;
+        storage << "segments" << "[";
+        for (const auto &segment : segments_)
+        {
+            storage << "{" << "file" << segment.file << "first_frame" << segment.first_frame
+                    << "frame_count" << segment.frame_count << "}";
+        }
+        storage << "]";
+        style_transfer.saveTemporalState(storage, "temporal");
+        storage.release();
+
+        // A crash mid-write leaves the previous checkpoint intact
+        std::error_code ec;
+        fs::rename(partial, pathOf(kCheckpointFile), ec);
+        return !ec;
+    }
+
+    std::string RenderCheckpoint::pathOf(const std::string &name) const
+    {
+        return (fs::path(directory_) / name).string();
+    }
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,138 @@
+#include "video_processor/segment_file.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace video_styler::video_processor
+{
+
+    namespace
+    {
+        constexpr char kMagic[8] = {'V', 'S', 'S', 'E', 'G', '0', '0', '1'};
+
+        // Fast PNG level: segments are short-lived and the encode sits on the critical path
+        constexpr int kPngCompression = 1;
+
+        void writeLength(std::ostream &out, std::uint32_t length)
+        {
+            const unsigned char bytes[4] = {
+                static_cast<unsigned char>(length),
+                static_cast<unsigned char>(length >> 8),
+                static_cast<unsigned char>(length >> 16),
+                static_cast<unsigned char>(length >> 24),
+            };
+            out.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+        }
+
+        bool readLength(std::istream &in, std::uint32_t &length)
+        {
+            unsigned char bytes[4];
+            if (!in.read(reinterpret_cast<char *>(bytes), sizeof(bytes)))
+            {
+                return false;
+            }
+            length = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<std::uint32_t>(bytes[3]) << 24);
+            return true;
+        }
+    } // namespace
+
+    SegmentWriter::SegmentWriter(std::ostream &out)
+        : out_(out)
+    {
+        out_.write(kMagic, sizeof(kMagic));
+    }
+
+    bool SegmentWriter::write(const cv::Mat &frame)
+    {
+        std::vector<uchar> encoded;
+        if (frame.empty() || !cv::imencode(".png", frame, encoded, {cv::IMWRITE_PNG_COMPRESSION, kPngCompression}))
+        {
+            return false;
+        }
+
+        writeLength(out_, static_cast<std::uint32_t>(encoded.size()));
+        out_.write(reinterpret_cast<const char *>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+        if (!out_)
+        {
+            return false;
+        }
+        ++frame_count_;
+        return true;
+    }
+
+    int SegmentWriter::getFrameCount() const
+    {
+        return frame_count_;
+    }
+
+    SegmentReader::SegmentReader(std::istream &in)
+        : in_(in)
+    {
+        char magic[sizeof(kMagic)];
+        valid_ = static_cast<bool>(in_.read(magic, sizeof(magic))) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+    }
+
+    bool SegmentReader::isValid() const
+    {
+        return valid_;
+    }
+
+    bool SegmentReader::read(cv::Mat &frame)
+    {
+        std::uint32_t length = 0;
+        if (!valid_ || !readLength(in_, length))
+        {
+            return false;
+        }
+
+        std::vector<uchar> encoded(length);
+        if (!in_.read(reinterpret_cast<char *>(encoded.data()), length))
+        {
+            return false;
+        }
+        frame = cv::imdecode(encoded, cv::IMREAD_UNCHANGED);
+        return !frame.empty();
+    }
+
+    SegmentStitcher::SegmentStitcher(cv::VideoWriter &writer)
+        : writer_(writer)
+    {
+    }
+
+    bool SegmentStitcher::append(const std::string &segment_path)
+    {
+        std::ifstream in(segment_path, std::ios::binary);
+        return in && appendStream(in);
+    }
+
+    bool SegmentStitcher::appendBuffer(const std::string &segment)
+    {
+        std::istringstream in(segment);
+        return appendStream(in);
+    }
+
+    int SegmentStitcher::getFramesWritten() const
+    {
+        return frames_written_;
+    }
+
+    bool SegmentStitcher::appendStream(std::istream &in)
+    {
+        SegmentReader reader(in);
+        if (!reader.isValid())
+        {
+            return false;
+        }
+
+        cv::Mat frame;
+        while (reader.read(frame))
+        {
+            writer_.write(frame);
+            ++frames_written_;
+        }
+        return true;
+    }
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,414 @@
+#include "video_processor/shard_coordinator.hpp"
+#include "video_processor/segment_file.hpp"
+#include "utils/logger.hpp"
+#include "utils/memory_budget.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+namespace video_styler::video_processor
+{
+
+    namespace fs = std::filesystem;
+    namespace pt = boost::property_tree;
+
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // Weight of the newest throughput sample in a worker's estimate
+        constexpr double kThroughputSmoothing = 0.5;
+
+        // Room left in a message for the settings JSON and the segment header
+        constexpr std::uint64_t kMessageOverheadBytes = 64 * 1024;
+
+        /**
+         * @brief Read the frame count a worker reported for a segment
+         * @param stats Stats JSON of a SEGMENT reply
+         * @return Frame count, or -1 if malformed
+         */
+        int reportedFrames(const std::string &stats)
+        {
+            try
+            {
+                std::istringstream in(stats);
+                pt::ptree tree;
+                pt::read_json(in, tree);
+                return tree.get<int>("frames");
+            }
+            catch (const pt::ptree_error &)
+            {
+                return -1;
+            }
+        }
+    } // namespace
+
+    std::string WorkerEndpoint::toString() const
+    {
+        return host + ":" + std::to_string(port);
+    }
+
+    ShardCoordinator::ShardCoordinator(std::vector<WorkerEndpoint> workers, ShardSettings settings)
+        : workers_(std::move(workers)), settings_(settings)
+    {
+    }
+
+    ShardReport ShardCoordinator::run(const std::string &input_path, const std::string &style_path,
+                                      const std::string &output_path, const RenderSettings &render)
+    {
+        auto logger = utils::Logger::getInstance();
+        ShardReport report;
+        if (workers_.empty())
+        {
+            report.error = "no workers";
+            return report;
+        }
+
+        loader_ = VideoLoader();
+        if (!loader_.loadVideo(input_path))
+        {
+            report.error = "failed to open input " + input_path;
+            return report;
+        }
+
+        std::ifstream style_file(style_path, std::ios::binary);
+        std::string style_bytes((std::istreambuf_iterator<char>(style_file)), std::istreambuf_iterator<char>());
+        if (!style_file || style_bytes.empty())
+        {
+            report.error = "failed to read style image " + style_path;
+            return report;
+        }
+
+        // Lossless PNG can exceed the raw frame size slightly on noise; budget for 1/8 more
+        const std::uint64_t frame_bytes = utils::MemoryBudget::frameBytes(loader_.getWidth(), loader_.getHeight());
+        const std::uint64_t overhead = style_bytes.size() + kMessageOverheadBytes;
+        const std::uint64_t encoded_frame_bytes = std::max<std::uint64_t>(1, frame_bytes + frame_bytes / 8);
+        if (overhead + encoded_frame_bytes > settings_.max_message_bytes)
+        {
+            report.error = "a frame and the style image do not fit in a worker message";
+            return report;
+        }
+        max_message_frames_ = static_cast<int>(std::min<std::uint64_t>(
+            (settings_.max_message_bytes - overhead) / encoded_frame_bytes, static_cast<std::uint64_t>(settings_.max_chunk_frames)));
+
+        next_frame_ = 0;
+        next_chunk_ = 0;
+        input_exhausted_ = false;
+        retry_queue_.clear();
+        finished_.clear();
+        outstanding_ = 0;
+        live_workers_ = static_cast<int>(workers_.size());
+        retries_ = 0;
+        failure_.clear();
+
+        const std::string shard_dir = output_path + ".shards";
+        std::error_code ec;
+        fs::create_directories(shard_dir, ec);
+        if (ec)
+        {
+            report.error = "cannot create " + shard_dir + ": " + ec.message();
+            return report;
+        }
+
+        logger->info("Sharding " + std::to_string(loader_.getFrameCount()) + " frames at " +
+                     std::to_string(loader_.getFPS()) + " fps over " + std::to_string(workers_.size()) + " workers");
+
+        ShardMessage render_request;
+        render_request.type = ShardMessageType::RENDER;
+        render_request.parts = {render.toJson(), std::move(style_bytes), std::string()};
+
+        const auto start = Clock::now();
+        report.workers.resize(workers_.size());
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < workers_.size(); ++i)
+        {
+            report.workers[i].endpoint = workers_[i];
+            threads.emplace_back([this, &report, &render_request, &shard_dir, i]
+                                 { workerLoop(report.workers[i], render_request, shard_dir); });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        loader_.getCapture().release();
+
+        // Every chunk index below next_chunk_ must have come back exactly once
+        if (failure_.empty() && static_cast<int>(finished_.size()) != next_chunk_)
+        {
+            failure_ = "missing stylized chunks";
+        }
+
+        if (failure_.empty())
+        {
+            cv::VideoWriter writer(output_path, cv::VideoWriter::fourcc('M', 'P', '4', 'V'), loader_.getFPS(),
+                                   cv::Size(loader_.getWidth(), loader_.getHeight()));
+            SegmentStitcher stitcher(writer);
+            for (const auto &[index, segment_path] : finished_)
+            {
+                if (!stitcher.append(segment_path))
+                {
+                    failure_ = "unreadable segment for chunk " + std::to_string(index);
+                    break;
+                }
+                fs::remove(segment_path, ec);
+            }
+            writer.release();
+            report.frames = stitcher.getFramesWritten();
+        }
+        fs::remove_all(shard_dir, ec);
+
+        report.wall_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        report.chunks = next_chunk_;
+        report.retries = retries_;
+        report.error = failure_;
+        report.success = failure_.empty();
+        return report;
+    }
+
+    bool ShardCoordinator::parseWorkers(const std::string &list, std::vector<WorkerEndpoint> &workers)
+    {
+        std::vector<WorkerEndpoint> parsed;
+        std::stringstream ss(list);
+        std::string entry;
+        while (std::getline(ss, entry, ','))
+        {
+            const auto colon = entry.rfind(':');
+            if (colon == std::string::npos || colon == 0 || colon + 1 == entry.size())
+            {
+                return false;
+            }
+
+            std::size_t consumed = 0;
+            int port = 0;
+            try
+            {
+                port = std::stoi(entry.substr(colon + 1), &consumed);
+            }
+            catch (const std::exception &)
+            {
+                return false;
+            }
+            if (consumed != entry.size() - colon - 1 || port <= 0 || port > 65535)
+            {
+                return false;
+            }
+            parsed.push_back({entry.substr(0, colon), static_cast<unsigned short>(port)});
+        }
+
+        if (parsed.empty())
+        {
+            return false;
+        }
+        workers = std::move(parsed);
+        return true;
+    }
+
+    void ShardCoordinator::workerLoop(WorkerReport &report, const ShardMessage &render_request,
+                                      const std::string &shard_dir)
+    {
+        auto logger = utils::Logger::getInstance();
+        ShardConnection connection(settings_.timeout, settings_.max_message_bytes);
+        ShardMessage request = render_request;
+        int consecutive_failures = 0;
+
+        Chunk chunk;
+        while (takeChunk(report.frames_per_second, chunk))
+        {
+            const auto start = Clock::now();
+            request.parts[2] = std::move(chunk.segment);
+
+            ShardMessage reply;
+            std::string error;
+            if (!connection.isOpen() && !connection.connect(report.endpoint.host, report.endpoint.port))
+            {
+                error = "cannot connect";
+            }
+            else if (!connection.send(request) || !connection.receive(reply))
+            {
+                error = "connection lost or timed out";
+            }
+            else if (reply.type == ShardMessageType::FAILURE)
+            {
+                error = reply.parts.empty() ? "worker error" : reply.parts[0];
+            }
+            else if (reply.type != ShardMessageType::SEGMENT || reply.parts.size() != 2 ||
+                     reportedFrames(reply.parts[0]) != chunk.frame_count)
+            {
+                // The stream may be out of step; start over on a fresh connection
+                connection.close();
+                error = "unexpected reply";
+            }
+            chunk.segment = std::move(request.parts[2]);
+
+            std::string segment_path;
+            if (error.empty())
+            {
+                std::ostringstream name;
+                name << shard_dir << "/chunk_" << std::setw(6) << std::setfill('0') << chunk.index << ".seg";
+                segment_path = name.str();
+                std::ofstream out(segment_path, std::ios::binary);
+                out.write(reply.parts[1].data(), static_cast<std::streamsize>(reply.parts[1].size()));
+                if (!out)
+                {
+                    error = "cannot write " + segment_path;
+                }
+            }
+
+            if (error.empty())
+            {
+                const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                const double sample = chunk.frame_count / std::max(seconds, 1e-3);
+                report.frames_per_second = report.frames_per_second > 0.0
+                                               ? (1.0 - kThroughputSmoothing) * report.frames_per_second +
+                                                     kThroughputSmoothing * sample
+                                               : sample;
+                report.chunks++;
+                report.frames += chunk.frame_count;
+                consecutive_failures = 0;
+
+                logger->debug("Worker " + report.endpoint.toString() + " finished chunk " +
+                              std::to_string(chunk.index) + " (frames " + std::to_string(chunk.first_frame) + "-" +
+                              std::to_string(chunk.first_frame + chunk.frame_count - 1) + ", " +
+                              std::to_string(report.frames_per_second) + " fps)");
+
+                std::lock_guard<std::mutex> lock(state_mutex_);
+                finished_[chunk.index] = segment_path;
+                --outstanding_;
+                state_cv_.notify_all();
+                continue;
+            }
+
+            report.failures++;
+            const bool drop = ++consecutive_failures >= settings_.max_worker_failures;
+            logger->warning("Worker " + report.endpoint.toString() + " failed chunk " + std::to_string(chunk.index) +
+                            ": " + error + (drop ? "; dropping worker" : "; retrying"));
+
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            --outstanding_;
+            ++retries_;
+            if (++chunk.attempts >= settings_.max_attempts)
+            {
+                failure_ = "chunk " + std::to_string(chunk.index) + " failed " + std::to_string(chunk.attempts) +
+                           " times, last: " + error;
+            }
+            else
+            {
+                // Retry first: the stitcher cannot move past a missing chunk
+                retry_queue_.push_front(std::move(chunk));
+            }
+            if (drop && --live_workers_ == 0 && failure_.empty())
+            {
+                failure_ = "all workers failed, last: " + error;
+            }
+            state_cv_.notify_all();
+            if (drop)
+            {
+                report.dropped = true;
+                break;
+            }
+        }
+    }
+
+    bool ShardCoordinator::takeChunk(double frames_per_second, Chunk &chunk)
+    {
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        while (true)
+        {
+            if (!failure_.empty())
+            {
+                return false;
+            }
+            if (!retry_queue_.empty())
+            {
+                chunk = std::move(retry_queue_.front());
+                retry_queue_.pop_front();
+                ++outstanding_;
+                return true;
+            }
+            if (!input_exhausted_)
+            {
+                // Reserve the chunk so idle workers wait instead of finishing early
+                ++outstanding_;
+                const int live_workers = live_workers_;
+                lock.unlock();
+                std::string error;
+                const bool decoded = decodeChunk(frames_per_second, live_workers, chunk, error);
+                lock.lock();
+                if (decoded)
+                {
+                    return true;
+                }
+                --outstanding_;
+                input_exhausted_ = true;
+                if (!error.empty() && failure_.empty())
+                {
+                    failure_ = error;
+                }
+                state_cv_.notify_all();
+                continue;
+            }
+            if (outstanding_ == 0)
+            {
+                return false;
+            }
+            state_cv_.wait(lock);
+        }
+    }
+
+    bool ShardCoordinator::decodeChunk(double frames_per_second, int live_workers, Chunk &chunk, std::string &error)
+    {
+        std::lock_guard<std::mutex> lock(decode_mutex_);
+        const int target = chunkFrames(frames_per_second, live_workers);
+
+        std::ostringstream out;
+        SegmentWriter writer(out);
+        cv::Mat frame;
+        while (writer.getFrameCount() < target && loader_.getCapture().read(frame))
+        {
+            if (!writer.write(frame))
+            {
+                // A short chunk would silently drop frames from the output
+                error = "failed to encode input frame " + std::to_string(next_frame_ + writer.getFrameCount());
+                return false;
+            }
+        }
+        if (writer.getFrameCount() == 0)
+        {
+            return false;
+        }
+
+        chunk = Chunk();
+        chunk.index = next_chunk_++;
+        chunk.first_frame = next_frame_;
+        chunk.frame_count = writer.getFrameCount();
+        chunk.segment = out.str();
+        next_frame_ += chunk.frame_count;
+        return true;
+    }
+
+    int ShardCoordinator::chunkFrames(double frames_per_second, int live_workers) const
+    {
+        int frames = frames_per_second > 0.0
+                         ? static_cast<int>(std::lround(frames_per_second * settings_.target_chunk_seconds))
+                         : settings_.initial_chunk_frames;
+        frames = std::clamp(frames, settings_.min_chunk_frames, settings_.max_chunk_frames);
+        frames = std::min(frames, max_message_frames_);
+
+        const int remaining = loader_.getFrameCount() - next_frame_;
+        if (remaining > 0 && live_workers > 0)
+        {
+            const int share = (remaining + live_workers - 1) / live_workers;
+            frames = std::min(frames, std::max(settings_.min_chunk_frames, share));
+        }
+        return std::max(1, frames);
+    }
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,225 @@
+#include "video_processor/shard_protocol.hpp"
+
+#include <sstream>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+namespace video_styler::video_processor
+{
+
+    namespace pt = boost::property_tree;
+
+    namespace
+    {
+        // Sanity limit on the header; the payload is bounded by max_message_bytes_
+        constexpr std::uint32_t kMaxParts = 16;
+
+        void appendInteger(std::string &out, std::uint64_t value, int bytes)
+        {
+            for (int i = 0; i < bytes; ++i)
+            {
+                out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+            }
+        }
+
+        std::uint64_t parseInteger(const unsigned char *data, int bytes)
+        {
+            std::uint64_t value = 0;
+            for (int i = bytes - 1; i >= 0; --i)
+            {
+                value = (value << 8) | data[i];
+            }
+            return value;
+        }
+    } // namespace
+
+    std::string RenderSettings::toJson() const
+    {
+        pt::ptree tree;
+        tree.put("mode", mode);
+        tree.put("iterations", iterations);
+        tree.put("style_weight", style_weight);
+        tree.put("content_weight", content_weight);
+        tree.put("precision", precision);
+
+        std::ostringstream out;
+        pt::write_json(out, tree, false);
+        return out.str();
+    }
+
+    bool RenderSettings::fromJson(const std::string &json, RenderSettings &settings)
+    {
+        try
+        {
+            std::istringstream in(json);
+            pt::ptree tree;
+            pt::read_json(in, tree);
+
+            RenderSettings parsed;
+            parsed.mode = tree.get<std::string>("mode");
+            parsed.iterations = tree.get<int>("iterations");
+            parsed.style_weight = tree.get<double>("style_weight");
+            parsed.content_weight = tree.get<double>("content_weight");
+            parsed.precision = tree.get<std::string>("precision", parsed.precision);
+            settings = parsed;
+            return true;
+        }
+        catch (const pt::ptree_error &)
+        {
+            return false;
+        }
+    }
+
+    ShardConnection::ShardConnection(std::chrono::milliseconds timeout, std::uint64_t max_message_bytes)
+        : socket_(io_), timeout_(timeout), max_message_bytes_(max_message_bytes)
+    {
+    }
+
+    bool ShardConnection::connect(const std::string &host, unsigned short port)
+    {
+        close();
+
+        boost::system::error_code ec;
+        boost::asio::ip::tcp::resolver resolver(io_);
+        const auto endpoints = resolver.resolve(host, std::to_string(port), ec);
+        if (ec)
+        {
+            return false;
+        }
+
+        boost::system::error_code result = boost::asio::error::would_block;
+        boost::asio::async_connect(socket_, endpoints,
+                                   [&result](const boost::system::error_code &error, const auto &)
+                                   { result = error; });
+        if (!wait(result))
+        {
+            return false;
+        }
+
+        socket_.set_option(boost::asio::ip::tcp::no_delay(true), ec);
+        return true;
+    }
+
+    bool ShardConnection::send(const ShardMessage &message)
+    {
+        std::string header;
+        appendInteger(header, static_cast<std::uint32_t>(message.type), 4);
+        appendInteger(header, message.parts.size(), 4);
+
+        // Gather writes: only the small length prefixes are copied
+        std::vector<std::string> prefixes(message.parts.size());
+        std::vector<boost::asio::const_buffer> buffers{boost::asio::buffer(header)};
+        for (std::size_t i = 0; i < message.parts.size(); ++i)
+        {
+            appendInteger(prefixes[i], message.parts[i].size(), 8);
+            buffers.push_back(boost::asio::buffer(prefixes[i]));
+            buffers.push_back(boost::asio::buffer(message.parts[i]));
+        }
+
+        boost::system::error_code result = boost::asio::error::would_block;
+        boost::asio::async_write(socket_, buffers,
+                                 [&result](const boost::system::error_code &error, std::size_t)
+                                 { result = error; });
+        return wait(result);
+    }
+
+    bool ShardConnection::receive(ShardMessage &message)
+    {
+        unsigned char header[8];
+        if (!readExactly(header, sizeof(header)))
+        {
+            return false;
+        }
+
+        const auto type = static_cast<std::uint32_t>(parseInteger(header, 4));
+        const auto part_count = static_cast<std::uint32_t>(parseInteger(header + 4, 4));
+        if (type < static_cast<std::uint32_t>(ShardMessageType::RENDER) ||
+            type > static_cast<std::uint32_t>(ShardMessageType::FAILURE) || part_count > kMaxParts)
+        {
+            close();
+            return false;
+        }
+
+        message.type = static_cast<ShardMessageType>(type);
+        message.parts.assign(part_count, std::string());
+        std::uint64_t remaining = max_message_bytes_;
+        for (auto &part : message.parts)
+        {
+            unsigned char length_bytes[8];
+            if (!readExactly(length_bytes, sizeof(length_bytes)))
+            {
+                return false;
+            }
+            const std::uint64_t length = parseInteger(length_bytes, 8);
+            if (length > remaining)
+            {
+                close();
+                return false;
+            }
+            remaining -= length;
+            part.resize(length);
+            if (length > 0 && !readExactly(part.data(), part.size()))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void ShardConnection::close()
+    {
+        boost::system::error_code ignored;
+        socket_.close(ignored);
+    }
+
+    bool ShardConnection::isOpen() const
+    {
+        return socket_.is_open();
+    }
+
+    boost::asio::ip::tcp::socket &ShardConnection::socket()
+    {
+        return socket_;
+    }
+
+    bool ShardConnection::readExactly(void *data, std::size_t size)
+    {
+        boost::system::error_code result = boost::asio::error::would_block;
+        boost::asio::async_read(socket_, boost::asio::buffer(data, size),
+                                [&result](const boost::system::error_code &error, std::size_t)
+                                { result = error; });
+        return wait(result);
+    }
+
+    bool ShardConnection::wait(boost::system::error_code &result)
+    {
+        io_.restart();
+        if (timeout_.count() > 0)
+        {
+            io_.run_for(timeout_);
+        }
+        else
+        {
+            io_.run();
+        }
+
+        if (result == boost::asio::error::would_block)
+        {
+            // Timed out: cancel the operation and let its handler run
+            close();
+            io_.restart();
+            io_.run();
+            return false;
+        }
+        if (result)
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+} // namespace video_styler::video_processor
@@ -0,0 +1,240 @@
+#include "video_processor/shard_worker.hpp"
+#include "video_processor/segment_file.hpp"
+#include "utils/logger.hpp"
+
+#include <chrono>
+#include <functional>
+#include <sstream>
+#include <vector>
+
+#ifdef __linux__
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+namespace video_styler::video_processor
+{
+
+    namespace
+    {
+        /**
+         * @brief Probe an idle connection so a peer that vanished without a FIN is detected in minutes
+         * @param socket Accepted socket
+         */
+        void enableKeepalive(boost::asio::ip::tcp::socket &socket)
+        {
+            boost::system::error_code ec;
+            socket.set_option(boost::asio::socket_base::keep_alive(true), ec);
+#ifdef __linux__
+            // First probe after 60 s idle, then every 10 s; 6 unanswered probes drop the connection
+            const int idle_seconds = 60;
+            const int interval_seconds = 10;
+            const int probes = 6;
+            const int fd = socket.native_handle();
+            setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &idle_seconds, sizeof(idle_seconds));
+            setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &interval_seconds, sizeof(interval_seconds));
+            setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &probes, sizeof(probes));
+#endif
+        }
+    } // namespace
+
+    ShardWorker::ShardWorker() = default;
+
+    ShardWorker::~ShardWorker() = default;
+
+    bool ShardWorker::listen(const std::string &address, unsigned short port)
+    {
+        boost::system::error_code ec;
+        const auto bind_address = boost::asio::ip::make_address(address, ec);
+        if (ec)
+        {
+            utils::Logger::getInstance()->error("Invalid worker listen address: " + address);
+            return false;
+        }
+
+        auto acceptor = std::make_unique<boost::asio::ip::tcp::acceptor>(io_);
+        const boost::asio::ip::tcp::endpoint endpoint(bind_address, port);
+        acceptor->open(endpoint.protocol(), ec);
+        if (!ec)
+        {
+            acceptor->set_option(boost::asio::ip::tcp::acceptor::reuse_address(true), ec);
+            acceptor->bind(endpoint, ec);
+        }
+        if (!ec)
+        {
+            acceptor->listen(boost::asio::socket_base::max_listen_connections, ec);
+        }
+        if (ec)
+        {
+            utils::Logger::getInstance()->error("Worker failed to listen on " + address + ":" + std::to_string(port) +
+                                                ": " + ec.message());
+            return false;
+        }
+
+        if (!bind_address.is_loopback())
+        {
+            // Requests are not authenticated: anyone who can connect can make the worker decode images
+            utils::Logger::getInstance()->warning("Worker accepts unauthenticated requests from other hosts on " +
+                                                  address + "; expose it only on a trusted network");
+        }
+
+        acceptor_ = std::move(acceptor);
+        return true;
+    }
+
+    void ShardWorker::setIdleTimeout(std::chrono::milliseconds timeout)
+    {
+        idle_timeout_ = timeout;
+    }
+
+    void ShardWorker::setMaxMessageBytes(std::uint64_t bytes)
+    {
+        max_message_bytes_ = bytes;
+    }
+
+    unsigned short ShardWorker::getPort() const
+    {
+        boost::system::error_code ec;
+        return acceptor_ ? acceptor_->local_endpoint(ec).port() : 0;
+    }
+
+    bool ShardWorker::serve(std::size_t max_connections)
+    {
+        if (!acceptor_)
+        {
+            return false;
+        }
+
+        auto logger = utils::Logger::getInstance();
+        for (std::size_t served = 0; max_connections == 0 || served < max_connections; ++served)
+        {
+            // The idle timeout outlasts a coordinator decoding its next chunk or waiting for retries
+            ShardConnection connection(idle_timeout_, max_message_bytes_);
+            boost::system::error_code ec;
+            acceptor_->accept(connection.socket(), ec);
+            if (ec)
+            {
+                logger->error("Worker accept failed: " + ec.message());
+                return false;
+            }
+
+            enableKeepalive(connection.socket());
+            logger->info("Coordinator connected from " +
+                         connection.socket().remote_endpoint(ec).address().to_string());
+            serveConnection(connection);
+        }
+        return true;
+    }
+
+    void ShardWorker::serveConnection(ShardConnection &connection)
+    {
+        ShardMessage request;
+        while (connection.receive(request))
+        {
+            ShardMessage reply;
+            handleRequest(request, reply);
+            if (!connection.send(reply))
+            {
+                break;
+            }
+        }
+    }
+
+    void ShardWorker::handleRequest(const ShardMessage &request, ShardMessage &reply)
+    {
+        std::string error;
+        if (!render(request, reply, error))
+        {
+            utils::Logger::getInstance()->warning("Worker rejected chunk: " + error);
+            reply.type = ShardMessageType::FAILURE;
+            reply.parts = {error};
+        }
+    }
+
+    std::size_t ShardWorker::getChunksRendered() const
+    {
+        return chunks_rendered_;
+    }
+
+    bool ShardWorker::render(const ShardMessage &request, ShardMessage &reply, std::string &error)
+    {
+        RenderSettings settings;
+        if (request.type != ShardMessageType::RENDER || request.parts.size() != 3 ||
+            !RenderSettings::fromJson(request.parts[0], settings))
+        {
+            error = "malformed render request";
+            return false;
+        }
+
+        if (settings.mode == "optimize")
+        {
+            style_transfer_.setMode(style_transfer::TransferMode::OPTIMIZATION);
+        }
+        else if (settings.mode == "fast")
+        {
+            style_transfer_.setMode(style_transfer::TransferMode::FAST);
+        }
+        else
+        {
+            error = "unknown mode " + settings.mode;
+            return false;
+        }
+        style_transfer_.setParameters(settings.iterations, settings.style_weight, settings.content_weight);
+
+        style_transfer::TensorPrecision precision = style_transfer::TensorPrecision::FP32;
+        if (!style_transfer::parseTensorPrecision(settings.precision, precision))
+        {
+            error = "unknown tensor precision " + settings.precision;
+            return false;
+        }
+        style_transfer_.setTensorPrecision(precision);
+
+        const std::string &style_bytes = request.parts[1];
+        const std::size_t style_hash = std::hash<std::string>{}(style_bytes);
+        if (!style_transfer_.isStyleLoaded() || style_hash != style_hash_)
+        {
+            const std::vector<uchar> encoded(style_bytes.begin(), style_bytes.end());
+            if (!style_transfer_.setStyleImage(cv::imdecode(encoded, cv::IMREAD_COLOR)))
+            {
+                error = "undecodable style image";
+                return false;
+            }
+            style_hash_ = style_hash;
+        }
+
+        // Each chunk is an independent range; never warm-start from another one
+        style_transfer_.resetTemporalState();
+
+        const auto start = std::chrono::steady_clock::now();
+        std::istringstream in(request.parts[2]);
+        SegmentReader reader(in);
+        if (!reader.isValid())
+        {
+            error = "input is not a segment";
+            return false;
+        }
+
+        std::ostringstream out;
+        SegmentWriter writer(out);
+        cv::Mat frame;
+        cv::Mat stylized;
+        while (reader.read(frame))
+        {
+            if (!style_transfer_.applyStyleTransfer(frame, stylized) || !writer.write(stylized))
+            {
+                error = "style transfer failed at chunk frame " + std::to_string(writer.getFrameCount());
+                return false;
+            }
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::ostringstream stats;
+        stats << R"({"frames": )" << writer.getFrameCount() << R"(, "seconds": )" << seconds << "}";
+        reply.type = ShardMessageType::SEGMENT;
+        reply.parts = {stats.str(), out.str()};
+        ++chunks_rendered_;
+        return true;
+    }
+
+} // namespace video_styler::video_processor
@@ -7,20 +7,48 @@ namespace video_styler::video_processor
     bool VideoLoader::loadVideo(const std::string &filepath)
     {
         video_capture_.open(filepath);
+        return readProperties(false);
+    }
+
+    bool VideoLoader::openCamera(int index)
+    {
+        video_capture_.open(index);
+        return readProperties(true);
+    }
+
+    bool VideoLoader::openDevice(const std::string &device)
+    {
+#ifdef __linux__
+        video_capture_.open(device, cv::CAP_V4L2);
+#else
+        video_capture_.open(device);
+#endif
+        return readProperties(true);
+    }
 
+    bool VideoLoader::readProperties(bool live)
+    {
         if (!video_capture_.isOpened())
         {
             is_loaded_ = false;
+            is_live_ = false;
             return false;
         }
 
+        if (live)
+        {
+            // Keep the driver queue minimal so grabs return the newest frame
+            video_capture_.set(cv::CAP_PROP_BUFFERSIZE, 1);
+        }
+
         // Get video properties
-        frame_count_ = static_cast<int>(video_capture_.get(cv::CAP_PROP_FRAME_COUNT));
+        frame_count_ = live ? 0 : static_cast<int>(video_capture_.get(cv::CAP_PROP_FRAME_COUNT));
         fps_ = video_capture_.get(cv::CAP_PROP_FPS);
         width_ = static_cast<int>(video_capture_.get(cv::CAP_PROP_FRAME_WIDTH));
         height_ = static_cast<int>(video_capture_.get(cv::CAP_PROP_FRAME_HEIGHT));
 
         is_loaded_ = true;
+        is_live_ = live;
         return true;
     }
 
@@ -49,6 +77,11 @@ namespace video_styler::video_processor
         return is_loaded_;
     }
 
+    bool VideoLoader::isLive() const
+    {
+        return is_live_;
+    }
+
     cv::VideoCapture &VideoLoader::getCapture()
     {
         return video_capture_;
@@ -0,0 +1,288 @@
+#include <gtest/gtest.h>
+#include "video_processor/batch_processor.hpp"
+#include "video_processor/video_loader.hpp"
+#include "style_transfer/neural_style_transfer.hpp"
+#include <opencv2/opencv.hpp>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+class BatchProcessorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        test_dir_ = "batch_test";
+        fs::create_directories(test_dir_);
+
+        style_path_ = test_dir_ + "/style.png";
+        cv::Mat style_image(64, 64, CV_8UC3, cv::Scalar(50, 100, 150));
+        cv::imwrite(style_path_, style_image);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            const std::string path = test_dir_ + "/input_" + std::to_string(i) + ".mp4";
+            if (createTestVideo(path, 10 + i * 7))
+            {
+                input_paths_.push_back(path);
+            }
+        }
+    }
+
+    void TearDown() override
+    {
+        // Clean up test files
+        fs::remove_all(test_dir_);
+    }
+
+    bool createTestVideo(const std::string &path, int frames)
+    {
+        cv::VideoWriter writer(
+            path,
+            cv::VideoWriter::fourcc('M', 'P', '4', 'V'),
+            30.0, // FPS
+            cv::Size(160, 120));
+
+        if (!writer.isOpened())
+        {
+            return false;
+        }
+
+        for (int i = 0; i < frames; ++i)
+        {
+            cv::Mat frame(120, 160, CV_8UC3, cv::Scalar(i * 10, 100, 200));
+            writer.write(frame);
+        }
+        writer.release();
+        return true;
+    }
+
+    std::string test_dir_;
+    std::string style_path_;
+    std::vector<std::string> input_paths_;
+};
+
+TEST_F(BatchProcessorTest, LoadManifestResolvesRelativePaths)
+{
+    const std::string manifest_path = test_dir_ + "/jobs.json";
+    std::ofstream manifest(manifest_path);
+    manifest << R"({"jobs": [{"input": "a.mp4", "style": "s.png", "output": "/tmp/out.mp4"}]})";
+    manifest.close();
+
+    std::vector<video_styler::video_processor::BatchJob> jobs;
+    ASSERT_TRUE(video_styler::video_processor::BatchProcessor::loadManifest(manifest_path, jobs));
+    ASSERT_EQ(jobs.size(), 1u);
+    EXPECT_EQ(fs::path(jobs[0].input_path), fs::path(test_dir_) / "a.mp4");
+    EXPECT_EQ(fs::path(jobs[0].style_path), fs::path(test_dir_) / "s.png");
+    EXPECT_EQ(jobs[0].output_path, "/tmp/out.mp4");
+}
+
+TEST_F(BatchProcessorTest, LoadManifestRejectsIncompleteJob)
+{
+    const std::string manifest_path = test_dir_ + "/jobs.json";
+    std::ofstream manifest(manifest_path);
+    manifest << R"({"jobs": [{"input": "a.mp4", "output": "b.mp4"}]})";
+    manifest.close();
+
+    std::vector<video_styler::video_processor::BatchJob> jobs;
+    EXPECT_FALSE(video_styler::video_processor::BatchProcessor::loadManifest(manifest_path, jobs));
+}
+
+TEST_F(BatchProcessorTest, LoadManifestRejectsInvalidJson)
+{
+    const std::string manifest_path = test_dir_ + "/jobs.json";
+    std::ofstream manifest(manifest_path);
+    manifest << "{ not json";
+    manifest.close();
+
+    std::vector<video_styler::video_processor::BatchJob> jobs;
+    EXPECT_FALSE(video_styler::video_processor::BatchProcessor::loadManifest(manifest_path, jobs));
+}
+
+TEST_F(BatchProcessorTest, RunsAllJobsOnSharedPool)
+{
+    if (input_paths_.size() != 3)
+    {
+        GTEST_SKIP() << "Could not create test video files";
+    }
+
+    std::vector<video_styler::video_processor::BatchJob> jobs;
+    for (std::size_t i = 0; i < input_paths_.size(); ++i)
+    {
+        jobs.push_back({input_paths_[i], style_path_, test_dir_ + "/output_" + std::to_string(i) + ".mp4"});
+    }
+
+    video_styler::utils::ThreadPool pool(3);
+    video_styler::video_processor::BatchProcessor processor(pool, 4);
+    const auto report = processor.run(jobs);
+
+    ASSERT_EQ(report.jobs.size(), 3u);
+    EXPECT_EQ(report.completedCount(), 3u);
+    EXPECT_GT(report.throughput(), 0.0);
+
+    int expected_total = 0;
+    for (std::size_t i = 0; i < report.jobs.size(); ++i)
+    {
+        const auto &job = report.jobs[i];
+        EXPECT_EQ(job.status, video_styler::video_processor::JobStatus::COMPLETED);
+
+        video_styler::video_processor::VideoLoader input;
+        ASSERT_TRUE(input.loadVideo(job.job.input_path));
+        EXPECT_EQ(job.frames_processed, input.getFrameCount());
+        expected_total += input.getFrameCount();
+
+        video_styler::video_processor::VideoLoader output;
+        ASSERT_TRUE(output.loadVideo(job.job.output_path));
+        EXPECT_EQ(output.getFrameCount(), input.getFrameCount());
+    }
+    EXPECT_EQ(report.total_frames, expected_total);
+}
+
+TEST_F(BatchProcessorTest, MissingInputFailsOnlyThatJob)
+{
+    if (input_paths_.empty())
+    {
+        GTEST_SKIP() << "Could not create test video files";
+    }
+
+    std::vector<video_styler::video_processor::BatchJob> jobs = {
+        {test_dir_ + "/missing.mp4", style_path_, test_dir_ + "/missing_out.mp4"},
+        {input_paths_[0], style_path_, test_dir_ + "/output.mp4"},
+    };
+
+    video_styler::utils::ThreadPool pool(2);
+    video_styler::video_processor::BatchProcessor processor(pool);
+    const auto report = processor.run(jobs);
+
+    ASSERT_EQ(report.jobs.size(), 2u);
+    EXPECT_EQ(report.jobs[0].status, video_styler::video_processor::JobStatus::FAILED);
+    EXPECT_FALSE(report.jobs[0].error.empty());
+    EXPECT_EQ(report.jobs[1].status, video_styler::video_processor::JobStatus::COMPLETED);
+}
+
+TEST_F(BatchProcessorTest, DedupeReusesRepeatedFrames)
+{
+    const std::string path = test_dir_ + "/static.mp4";
+    cv::VideoWriter writer(path, cv::VideoWriter::fourcc('M', 'P', '4', 'V'), 30.0, cv::Size(160, 120));
+    if (!writer.isOpened())
+    {
+        GTEST_SKIP() << "Could not create test video files";
+    }
+    const cv::Mat frame(120, 160, CV_8UC3, cv::Scalar(30, 90, 160));
+    for (int i = 0; i < 12; ++i)
+    {
+        writer.write(frame);
+    }
+    writer.release();
+
+    video_styler::utils::ThreadPool pool(2);
+    video_styler::video_processor::BatchProcessor processor(pool, 6);
+    processor.setDedupe(4, 2);
+    const auto report = processor.run({{path, style_path_, test_dir_ + "/static_out.mp4"}});
+
+    ASSERT_EQ(report.jobs.size(), 1u);
+    EXPECT_EQ(report.jobs[0].status, video_styler::video_processor::JobStatus::COMPLETED);
+    EXPECT_EQ(report.jobs[0].frames_processed, 12);
+    // At least every frame after the first of each segment is a repeat
+    EXPECT_GE(report.jobs[0].frames_reused, 10);
+}
+
+TEST_F(BatchProcessorTest, MemoryBudgetBoundsDecodedSegments)
+{
+    if (input_paths_.size() != 3)
+    {
+        GTEST_SKIP() << "Could not create test video files";
+    }
+
+    std::vector<video_styler::video_processor::BatchJob> jobs;
+    for (std::size_t i = 0; i < input_paths_.size(); ++i)
+    {
+        jobs.push_back({input_paths_[i], style_path_, test_dir_ + "/output_" + std::to_string(i) + ".mp4"});
+    }
+
+    // Room for six 160x120 frames: segments shrink to one frame per worker and decoders wait
+    const std::size_t frame_bytes = video_styler::utils::MemoryBudget::frameBytes(160, 120);
+    video_styler::utils::MemoryBudget budget(6 * frame_bytes);
+    video_styler::utils::ThreadPool pool(3);
+    video_styler::video_processor::BatchProcessor processor(pool, 8);
+    processor.setMemoryBudget(&budget);
+    const auto report = processor.run(jobs);
+
+    EXPECT_EQ(report.completedCount(), 3u);
+    EXPECT_EQ(report.total_frames, 10 + 17 + 24);
+    EXPECT_GT(budget.getPeak(), 0u);
+    EXPECT_LE(budget.getPeak(), budget.getCapacity());
+    EXPECT_EQ(budget.getInUse(), 0u);
+}
+
+TEST_F(BatchProcessorTest, RejectsUnknownRenderSettings)
+{
+    video_styler::utils::ThreadPool pool(1);
+    video_styler::video_processor::BatchProcessor processor(pool);
+
+    video_styler::video_processor::RenderSettings settings;
+    settings.mode = "sketch";
+    EXPECT_FALSE(processor.setRenderSettings(settings));
+
+    settings.mode = "optimize";
+    settings.precision = "fp8";
+    EXPECT_FALSE(processor.setRenderSettings(settings));
+
+    settings.precision = "fp16";
+    EXPECT_TRUE(processor.setRenderSettings(settings));
+}
+
+TEST_F(BatchProcessorTest, OptimizeModeWarmStartsAcrossSegments)
+{
+    if (input_paths_.empty())
+    {
+        GTEST_SKIP() << "Could not create test video files";
+    }
+
+    video_styler::video_processor::RenderSettings settings;
+    settings.mode = "optimize";
+    settings.iterations = 3;
+    settings.style_weight = 1e3;
+
+    video_styler::utils::ThreadPool pool(3);
+    video_styler::video_processor::BatchProcessor processor(pool, 3);
+    ASSERT_TRUE(processor.setRenderSettings(settings));
+    const std::string output_path = test_dir_ + "/optimized.mp4";
+    const auto report = processor.run({{input_paths_[0], style_path_, output_path}});
+    ASSERT_EQ(report.completedCount(), 1u);
+
+    // Reference: one transfer over the whole clip, encoded the same way
+    video_styler::style_transfer::NeuralStyleTransfer reference;
+    reference.setMode(video_styler::style_transfer::TransferMode::OPTIMIZATION);
+    reference.setParameters(settings.iterations, settings.style_weight, settings.content_weight);
+    ASSERT_TRUE(reference.loadStyleImage(style_path_));
+
+    const std::string reference_path = test_dir_ + "/reference.mp4";
+    video_styler::video_processor::VideoLoader input;
+    ASSERT_TRUE(input.loadVideo(input_paths_[0]));
+    cv::VideoWriter writer(reference_path, cv::VideoWriter::fourcc('M', 'P', '4', 'V'), input.getFPS(),
+                           cv::Size(input.getWidth(), input.getHeight()));
+    cv::Mat frame;
+    cv::Mat stylized;
+    while (input.getCapture().read(frame))
+    {
+        ASSERT_TRUE(reference.applyStyleTransfer(frame, stylized));
+        writer.write(stylized);
+    }
+    writer.release();
+
+    video_styler::video_processor::VideoLoader batch_output;
+    video_styler::video_processor::VideoLoader reference_output;
+    ASSERT_TRUE(batch_output.loadVideo(output_path));
+    ASSERT_TRUE(reference_output.loadVideo(reference_path));
+    cv::Mat batch_frame;
+    cv::Mat reference_frame;
+    int frames = 0;
+    while (batch_output.getCapture().read(batch_frame) && reference_output.getCapture().read(reference_frame))
+    {
+        EXPECT_LE(cv::norm(batch_frame, reference_frame, cv::NORM_L1) / batch_frame.total(), 1.0) << "frame " << frames;
+        ++frames;
+    }
+    EXPECT_EQ(frames, report.jobs[0].frames_processed);
+}
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include "style_transfer/color_lut.hpp"
+#include "style_transfer/neural_style_transfer.hpp"
+#include "style_transfer/pixel_kernels.hpp"
+#include <opencv2/opencv.hpp>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using video_styler::style_transfer::ColorLut;
+using video_styler::utils::CpuIsa;
+
+class ColorLutTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        frame_.create(47, 61, CV_8UC3);
+        cv::RNG(5).fill(frame_, cv::RNG::UNIFORM, 0, 256);
+
+        // A warm, mostly dark palette: orange and brown with a few highlights
+        style_.create(64, 64, CV_8UC3);
+        style_.setTo(cv::Scalar(20, 60, 120));
+        cv::rectangle(style_, cv::Rect(0, 0, 64, 20), cv::Scalar(30, 120, 230), -1);
+        cv::circle(style_, cv::Point(40, 44), 8, cv::Scalar(180, 220, 250), -1);
+
+        cube_path_ = "test_color_lut.cube";
+    }
+
+    void TearDown() override
+    {
+        fs::remove(cube_path_);
+        video_styler::style_transfer::selectKernels(CpuIsa::AVX512);
+    }
+
+    cv::Mat frame_;
+    cv::Mat style_;
+    std::string cube_path_;
+};
+
+TEST_F(ColorLutTest, DefaultIsEmpty)
+{
+    ColorLut lut;
+    EXPECT_TRUE(lut.empty());
+    EXPECT_EQ(lut.getSize(), 0);
+    cv::Mat output;
+    EXPECT_FALSE(lut.apply(frame_, output));
+    EXPECT_FALSE(lut.exportCube(cube_path_));
+}
+
+TEST_F(ColorLutTest, IdentityReproducesFrame)
+{
+    for (const int size : {2, 17, 33})
+    {
+        const ColorLut lut = ColorLut::identity(size);
+        ASSERT_EQ(lut.getSize(), size);
+
+        cv::Mat output;
+        ASSERT_TRUE(lut.apply(frame_, output));
+        EXPECT_EQ(cv::norm(output, frame_, cv::NORM_INF), 0.0) << "size " << size;
+    }
+}
+
+TEST_F(ColorLutTest, RejectsNonBgrFrames)
+{
+    const ColorLut lut = ColorLut::identity();
+    cv::Mat output;
+    EXPECT_FALSE(lut.apply(cv::Mat(8, 8, CV_8UC1, cv::Scalar(3)), output));
+    EXPECT_FALSE(lut.apply(cv::Mat(8, 8, CV_32FC3, cv::Scalar(0.5, 0.5, 0.5)), output));
+}
+
+TEST_F(ColorLutTest, TrilinearMatchesReferenceOnEveryVariant)
+{
+    const ColorLut lut = ColorLut::fitToStyle(style_, 9);
+    ASSERT_FALSE(lut.empty());
+
+    // Scalar double-precision trilinear interpolation of the lattice
+    cv::Mat expected(frame_.size(), CV_8UC3);
+    for (int y = 0; y < frame_.rows; ++y)
+    {
+        for (int x = 0; x < frame_.cols; ++x)
+        {
+            const cv::Vec3b pixel = frame_.at<cv::Vec3b>(y, x);
+            double position[3];
+            int cell[3];
+            for (int c = 0; c < 3; ++c)
+            {
+                position[c] = pixel[c] * (lut.getSize() - 1) / 255.0;
+                cell[c] = std::min(static_cast<int>(position[c]), lut.getSize() - 2);
+                position[c] -= cell[c];
+            }
+            cv::Vec3d value(0.0, 0.0, 0.0);
+            for (int corner = 0; corner < 8; ++corner)
+            {
+                const int db = corner >> 2, dg = (corner >> 1) & 1, dr = corner & 1;
+                const double weight = (db ? position[0] : 1.0 - position[0]) * (dg ? position[1] : 1.0 - position[1]) *
+                                      (dr ? position[2] : 1.0 - position[2]);
+                const cv::Vec3f entry = lut.at(cell[2] + dr, cell[1] + dg, cell[0] + db);
+                value += cv::Vec3d(entry[0], entry[1], entry[2]) * weight;
+            }
+            expected.at<cv::Vec3b>(y, x) = cv::Vec3b(cv::saturate_cast<uchar>(value[0]), cv::saturate_cast<uchar>(value[1]),
+                                                     cv::saturate_cast<uchar>(value[2]));
+        }
+    }
+
+    cv::Mat reference_output;
+    for (const CpuIsa isa : {CpuIsa::GENERIC, CpuIsa::SSE42, CpuIsa::AVX2, CpuIsa::AVX512})
+    {
+        if (video_styler::style_transfer::kernelsForIsa(isa) == nullptr)
+        {
+            continue;
+        }
+        video_styler::style_transfer::selectKernels(isa);
+
+        cv::Mat output;
+        ASSERT_TRUE(lut.apply(frame_, output));
+        EXPECT_LE(cv::norm(output, expected, cv::NORM_INF), 1.0) << video_styler::utils::cpuIsaToString(isa);
+        if (reference_output.empty())
+        {
+            reference_output = output;
+        }
+        EXPECT_EQ(cv::norm(output, reference_output, cv::NORM_INF), 0.0) << video_styler::utils::cpuIsaToString(isa);
+    }
+}
+
+TEST_F(ColorLutTest, FittedLutTakesOnStylePalette)
+{
+    const ColorLut lut = ColorLut::fitToStyle(style_);
+    ASSERT_EQ(lut.getSize(), ColorLut::kDefaultSize);
+
+    // A neutral gray ramp picks up the warm cast of the style...
+    cv::Mat ramp(16, 256, CV_8UC3);
+    for (int x = 0; x < 256; ++x)
+    {
+        ramp.col(x).setTo(cv::Scalar(x, x, x));
+    }
+    cv::Mat output;
+    ASSERT_TRUE(lut.apply(ramp, output));
+    const cv::Scalar mean = cv::mean(output);
+    EXPECT_GT(mean[2], mean[0] + 20.0); // Red well above blue
+
+    // ...while keeping its lightness order
+    double previous = -1.0;
+    for (int x = 0; x < 256; x += 15)
+    {
+        const cv::Vec3b pixel = output.at<cv::Vec3b>(0, x);
+        const double luma = 0.114 * pixel[0] + 0.587 * pixel[1] + 0.299 * pixel[2];
+        EXPECT_GE(luma, previous - 1.0) << "gray level " << x;
+        previous = luma;
+    }
+
+    // Fitting is deterministic
+    const ColorLut again = ColorLut::fitToStyle(style_);
+    EXPECT_EQ(again.at(7, 19, 30), lut.at(7, 19, 30));
+    EXPECT_TRUE(ColorLut::fitToStyle(cv::Mat()).empty());
+}
+
+TEST_F(ColorLutTest, CubeFileRoundTrip)
+{
+    const ColorLut lut = ColorLut::fitToStyle(style_, 17);
+    ASSERT_TRUE(lut.exportCube(cube_path_, "test palette"));
+
+    std::ifstream in(cube_path_);
+    std::string first_line;
+    std::getline(in, first_line);
+    EXPECT_EQ(first_line, "TITLE \"test palette\"");
+    std::string second_line;
+    std::getline(in, second_line);
+    EXPECT_EQ(second_line, "LUT_3D_SIZE 17");
+    in.close();
+
+    ColorLut loaded;
+    ASSERT_TRUE(ColorLut::loadCube(cube_path_, loaded));
+    ASSERT_EQ(loaded.getSize(), 17);
+    for (const int index : {0, 5, 16})
+    {
+        const cv::Vec3f original = lut.at(index, 16 - index, index / 2);
+        const cv::Vec3f restored = loaded.at(index, 16 - index, index / 2);
+        for (int c = 0; c < 3; ++c)
+        {
+            EXPECT_NEAR(restored[c], original[c], 1e-3);
+        }
+    }
+
+    cv::Mat expected;
+    cv::Mat output;
+    ASSERT_TRUE(lut.apply(frame_, expected));
+    ASSERT_TRUE(loaded.apply(frame_, output));
+    EXPECT_LE(cv::norm(output, expected, cv::NORM_INF), 1.0);
+}
+
+TEST_F(ColorLutTest, LoadCubeRejectsMalformedFiles)
+{
+    ColorLut lut;
+    EXPECT_FALSE(ColorLut::loadCube("does_not_exist.cube", lut));
+
+    std::ofstream(cube_path_) << "LUT_3D_SIZE 2\n0 0 0\n1 1 1\n";
+    EXPECT_FALSE(ColorLut::loadCube(cube_path_, lut)); // Too few entries
+
+    std::ofstream(cube_path_) << "LUT_1D_SIZE 4\n0 0 0\n";
+    EXPECT_FALSE(ColorLut::loadCube(cube_path_, lut));
+    EXPECT_TRUE(lut.empty());
+}
+
+TEST_F(ColorLutTest, FastModeAppliesStyleLut)
+{
+    video_styler::style_transfer::NeuralStyleTransfer nst;
+    ASSERT_TRUE(nst.setStyleImage(style_));
+
+    cv::Mat stylized;
+    ASSERT_TRUE(nst.applyStyleTransfer(frame_, stylized));
+    EXPECT_EQ(nst.getLastIterationCount(), 0);
+
+    cv::Mat expected;
+    ASSERT_TRUE(nst.getColorLut().apply(frame_, expected));
+    EXPECT_EQ(cv::norm(stylized, expected, cv::NORM_INF), 0.0);
+
+    ASSERT_TRUE(nst.exportColorLut(cube_path_));
+    EXPECT_TRUE(fs::exists(cube_path_));
+
+    // A new style refits the LUT
+    ASSERT_TRUE(nst.setStyleImage(cv::Mat(32, 32, CV_8UC3, cv::Scalar(200, 80, 10))));
+    cv::Mat restyled;
+    ASSERT_TRUE(nst.applyStyleTransfer(frame_, restyled));
+    EXPECT_GT(cv::norm(restyled, stylized, cv::NORM_INF), 0.0);
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "video_processor/frame_dedupe_cache.hpp"
+#include <opencv2/opencv.hpp>
+
+using video_styler::video_processor::FrameDedupeCache;
+using video_styler::video_processor::FrameSignature;
+
+namespace
+{
+    cv::Mat gradientFrame(int phase)
+    {
+        cv::Mat frame(120, 160, CV_8UC3);
+        for (int y = 0; y < frame.rows; ++y)
+        {
+            for (int x = 0; x < frame.cols; ++x)
+            {
+                const auto value = static_cast<uchar>((x * 3 + y * 2 + phase * 40) % 256);
+                frame.at<cv::Vec3b>(y, x) = cv::Vec3b(value, static_cast<uchar>(255 - value), 128);
+            }
+        }
+        return frame;
+    }
+} // namespace
+
+TEST(FrameDedupeCacheTest, HammingDistanceCountsDifferingBits)
+{
+    EXPECT_EQ(FrameDedupeCache::hammingDistance(0, 0), 0);
+    EXPECT_EQ(FrameDedupeCache::hammingDistance(0b1011, 0b0001), 2);
+    EXPECT_EQ(FrameDedupeCache::hammingDistance(0, ~0ull), 64);
+}
+
+TEST(FrameDedupeCacheTest, IdenticalFramesShareSignature)
+{
+    const cv::Mat frame = gradientFrame(0);
+    const FrameSignature a = FrameDedupeCache::computeSignature(frame);
+    const FrameSignature b = FrameDedupeCache::computeSignature(frame.clone());
+    EXPECT_EQ(a.hash, b.hash);
+    for (int c = 0; c < 3; ++c)
+    {
+        EXPECT_DOUBLE_EQ(a.mean[c], b.mean[c]);
+    }
+
+    const FrameSignature other = FrameDedupeCache::computeSignature(gradientFrame(3));
+    EXPECT_GT(FrameDedupeCache::hammingDistance(a.hash, other.hash), 0);
+}
+
+TEST(FrameDedupeCacheTest, RepeatedFrameHitsAndReturnsCopy)
+{
+    FrameDedupeCache cache(4, 0);
+    const cv::Mat frame = gradientFrame(1);
+    const cv::Mat stylized(120, 160, CV_8UC3, cv::Scalar(10, 20, 30));
+    const FrameSignature signature = FrameDedupeCache::computeSignature(frame);
+
+    cv::Mat output;
+    EXPECT_FALSE(cache.lookup(signature, output));
+    cache.insert(signature, stylized);
+
+    ASSERT_TRUE(cache.lookup(FrameDedupeCache::computeSignature(frame.clone()), output));
+    EXPECT_EQ(cv::norm(output, stylized, cv::NORM_INF), 0.0);
+
+    // Writing into the returned frame must not change the cached one
+    output.setTo(cv::Scalar(0, 0, 0));
+    cv::Mat again;
+    ASSERT_TRUE(cache.lookup(signature, again));
+    EXPECT_EQ(cv::norm(again, stylized, cv::NORM_INF), 0.0);
+
+    EXPECT_EQ(cache.getLookups(), 3u);
+    EXPECT_EQ(cache.getHits(), 2u);
+    EXPECT_NEAR(cache.getHitRate(), 2.0 / 3.0, 1e-9);
+}
+
+TEST(FrameDedupeCacheTest, ToleranceAllowsNearbyHashes)
+{
+    FrameSignature stored{0b1111, cv::Scalar::all(100.0)};
+    FrameSignature probe{0b1100, cv::Scalar::all(100.5)};
+
+    FrameDedupeCache strict(4, 1);
+    strict.insert(stored, cv::Mat(2, 2, CV_8UC3, cv::Scalar::all(1)));
+    cv::Mat output;
+    EXPECT_FALSE(strict.lookup(probe, output));
+
+    FrameDedupeCache tolerant(4, 2);
+    tolerant.insert(stored, cv::Mat(2, 2, CV_8UC3, cv::Scalar::all(1)));
+    EXPECT_TRUE(tolerant.lookup(probe, output));
+}
+
+TEST(FrameDedupeCacheTest, BrightnessChangeIsNotARepeat)
+{
+    // Fades and tints keep the gradient pattern (and so the hash) but change the means
+    FrameDedupeCache cache(4, 64);
+    cache.insert(FrameSignature{42, cv::Scalar(100, 100, 100)}, cv::Mat(2, 2, CV_8UC3, cv::Scalar::all(1)));
+
+    cv::Mat output;
+    EXPECT_FALSE(cache.lookup(FrameSignature{42, cv::Scalar(110, 110, 110)}, output));
+    EXPECT_FALSE(cache.lookup(FrameSignature{42, cv::Scalar(110, 100, 100)}, output));
+    EXPECT_TRUE(cache.lookup(FrameSignature{42, cv::Scalar(101, 100, 100)}, output));
+}
+
+TEST(FrameDedupeCacheTest, EvictsLeastRecentlyUsed)
+{
+    FrameDedupeCache cache(2, 0);
+    const cv::Mat output_frame(2, 2, CV_8UC3, cv::Scalar::all(1));
+    cache.insert(FrameSignature{1, cv::Scalar()}, output_frame);
+    cache.insert(FrameSignature{2, cv::Scalar()}, output_frame);
+
+    cv::Mat output;
+    ASSERT_TRUE(cache.lookup(FrameSignature{1, cv::Scalar()}, output)); // 1 becomes most recent
+    cache.insert(FrameSignature{4, cv::Scalar()}, output_frame);        // evicts 2
+
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_TRUE(cache.lookup(FrameSignature{1, cv::Scalar()}, output));
+    EXPECT_FALSE(cache.lookup(FrameSignature{2, cv::Scalar()}, output));
+    EXPECT_TRUE(cache.lookup(FrameSignature{4, cv::Scalar()}, output));
+}
+
+TEST(FrameDedupeCacheTest, SmallChangeIsNotARepeat)
+{
+    // A small moving region leaves the coarse hash and the means untouched
+    const cv::Mat frame = gradientFrame(2);
+    cv::Mat changed = frame.clone();
+    cv::rectangle(changed, cv::Rect(70, 50, 8, 8), cv::Scalar(255, 255, 255), -1);
+
+    const FrameSignature original = FrameDedupeCache::computeSignature(frame);
+    const FrameSignature probe = FrameDedupeCache::computeSignature(changed);
+    const cv::Mat stylized(120, 160, CV_8UC3, cv::Scalar(10, 20, 30));
+
+    for (const int tolerance : {0, 2})
+    {
+        FrameDedupeCache cache(4, tolerance);
+        cache.insert(original, stylized);
+        cv::Mat output;
+        EXPECT_FALSE(cache.lookup(probe, output)) << "tolerance " << tolerance;
+        EXPECT_TRUE(cache.lookup(FrameDedupeCache::computeSignature(frame.clone()), output)) << "tolerance " << tolerance;
+    }
+}
+
+TEST(FrameDedupeCacheTest, ToleranceZeroNeedsIdenticalPixels)
+{
+    const cv::Mat frame = gradientFrame(4);
+    cv::Mat changed = frame.clone();
+    changed.at<cv::Vec3b>(60, 80)[0] ^= 1;
+
+    FrameDedupeCache cache(4, 0);
+    cache.insert(FrameDedupeCache::computeSignature(frame), frame);
+    cv::Mat output;
+    EXPECT_FALSE(cache.lookup(FrameDedupeCache::computeSignature(changed), output));
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "video_processor/frame_store.hpp"
+#include <opencv2/opencv.hpp>
+#include <filesystem>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+class FrameStoreTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        test_dir_ = "frame_store_test";
+        fs::create_directories(test_dir_);
+    }
+
+    void TearDown() override
+    {
+        // Clean up test files
+        fs::remove_all(test_dir_);
+    }
+
+    static cv::Mat makeFrame(int index)
+    {
+        cv::Mat frame(48, 64, CV_8UC3, cv::Scalar(index, 255 - index, index * 3 % 256));
+        cv::circle(frame, cv::Point(index % 64, 24), 5, cv::Scalar(255, 255, 255), -1);
+        return frame;
+    }
+
+    std::string test_dir_;
+};
+
+TEST_F(FrameStoreTest, DefaultConstructor)
+{
+    video_styler::video_processor::FrameStore store;
+    EXPECT_FALSE(store.isOpen());
+    EXPECT_EQ(store.getCapacity(), 0);
+    EXPECT_TRUE(store.view(0).empty());
+}
+
+TEST_F(FrameStoreTest, RejectsInvalidGeometry)
+{
+    video_styler::video_processor::FrameStore store;
+    EXPECT_FALSE(store.create(0, cv::Size(64, 48), CV_8UC3, test_dir_));
+    EXPECT_FALSE(store.create(4, cv::Size(0, 48), CV_8UC3, test_dir_));
+    EXPECT_FALSE(store.isOpen());
+}
+
+TEST_F(FrameStoreTest, FailsCleanlyWithoutDiskSpace)
+{
+    // 1 PiB cannot be reserved anywhere; create() must fail instead of mapping a sparse file
+    video_styler::video_processor::FrameStore store;
+    EXPECT_FALSE(store.create(1 << 20, cv::Size(16384, 16384), CV_8UC4, test_dir_));
+    EXPECT_FALSE(store.isOpen());
+    EXPECT_TRUE(fs::is_empty(test_dir_));
+}
+
+TEST_F(FrameStoreTest, StrideIsPageAligned)
+{
+    video_styler::video_processor::FrameStore store;
+    ASSERT_TRUE(store.create(4, cv::Size(64, 48), CV_8UC3, test_dir_));
+    EXPECT_EQ(store.getStride() % static_cast<std::size_t>(sysconf(_SC_PAGESIZE)), 0u);
+    EXPECT_GE(store.getStride(), 64u * 48u * 3u);
+}
+
+TEST_F(FrameStoreTest, RandomAccessRoundTrip)
+{
+    video_styler::video_processor::FrameStore store;
+    ASSERT_TRUE(store.create(16, cv::Size(64, 48), CV_8UC3, test_dir_));
+    store.adviseAccessPattern(video_styler::video_processor::AccessPattern::SEQUENTIAL);
+
+    for (int i = 0; i < 16; ++i)
+    {
+        ASSERT_TRUE(store.write(i, makeFrame(i)));
+    }
+
+    // Read back in reverse, as a backward pass would
+    store.adviseAccessPattern(video_styler::video_processor::AccessPattern::RANDOM);
+    for (int i = 15; i >= 0; --i)
+    {
+        cv::Mat frame;
+        ASSERT_TRUE(store.read(i, frame));
+        EXPECT_EQ(cv::norm(frame, makeFrame(i), cv::NORM_INF), 0.0);
+    }
+}
+
+TEST_F(FrameStoreTest, EvictedFramesRemainReadable)
+{
+    video_styler::video_processor::FrameStore store;
+    ASSERT_TRUE(store.create(4, cv::Size(64, 48), CV_8UC3, test_dir_));
+    ASSERT_TRUE(store.write(1, makeFrame(1)));
+
+    store.evict(0, 4);
+    store.prefetch(1, 1);
+
+    const cv::Mat view = store.view(1);
+    ASSERT_FALSE(view.empty());
+    EXPECT_EQ(cv::norm(view, makeFrame(1), cv::NORM_INF), 0.0);
+}
+
+TEST_F(FrameStoreTest, RejectsMismatchedFrames)
+{
+    video_styler::video_processor::FrameStore store;
+    ASSERT_TRUE(store.create(2, cv::Size(64, 48), CV_8UC3, test_dir_));
+
+    EXPECT_FALSE(store.write(2, makeFrame(0)));
+    EXPECT_FALSE(store.write(0, cv::Mat(10, 10, CV_8UC3)));
+    EXPECT_FALSE(store.write(0, cv::Mat(48, 64, CV_32FC3)));
+    EXPECT_FALSE(store.contains(0));
+}
+
+TEST_F(FrameStoreTest, BackingFileIsRemoved)
+{
+    video_styler::video_processor::FrameStore store;
+    ASSERT_TRUE(store.create(2, cv::Size(64, 48), CV_8UC3, test_dir_));
+    ASSERT_TRUE(store.write(0, makeFrame(0)));
+
+    // The file is unlinked as soon as it is mapped
+    EXPECT_TRUE(fs::is_empty(test_dir_));
+
+    store.close();
+    EXPECT_FALSE(store.isOpen());
+    EXPECT_FALSE(store.contains(0));
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "style_transfer/lbfgs_optimizer.hpp"
+#include <Eigen/Core>
+
+namespace
+{
+    // Rosenbrock function: minimum 0 at (1, 1)
+    double rosenbrock(const Eigen::VectorXf &x, Eigen::VectorXf &gradient)
+    {
+        const double a = x[0];
+        const double b = x[1];
+        gradient[0] = static_cast<float>(-2.0 * (1.0 - a) - 400.0 * a * (b - a * a));
+        gradient[1] = static_cast<float>(200.0 * (b - a * a));
+        return (1.0 - a) * (1.0 - a) + 100.0 * (b - a * a) * (b - a * a);
+    }
+
+    // Separable quadratic with its minimum at target
+    video_styler::style_transfer::LbfgsOptimizer::Objective quadratic(const Eigen::VectorXf &target)
+    {
+        return [target](const Eigen::VectorXf &x, Eigen::VectorXf &gradient)
+        {
+            const Eigen::VectorXf diff = x - target;
+            gradient = 2.0f * diff;
+            return static_cast<double>(diff.squaredNorm());
+        };
+    }
+} // namespace
+
+TEST(LbfgsOptimizerTest, MinimizesRosenbrock)
+{
+    video_styler::style_transfer::LbfgsSettings settings;
+    settings.max_iterations = 200;
+    settings.plateau_patience = 50;
+    video_styler::style_transfer::LbfgsOptimizer optimizer(settings);
+
+    Eigen::VectorXf x(2);
+    x << -1.2f, 1.0f;
+    const auto result = optimizer.minimize(rosenbrock, x);
+
+    EXPECT_LT(result.final_loss, result.initial_loss);
+    EXPECT_NEAR(x[0], 1.0f, 1e-2f);
+    EXPECT_NEAR(x[1], 1.0f, 1e-2f);
+}
+
+TEST(LbfgsOptimizerTest, RespectsIterationCap)
+{
+    video_styler::style_transfer::LbfgsSettings settings;
+    settings.max_iterations = 3;
+    settings.plateau_patience = 100;
+    video_styler::style_transfer::LbfgsOptimizer optimizer(settings);
+
+    Eigen::VectorXf x(2);
+    x << -1.2f, 1.0f;
+    const auto result = optimizer.minimize(rosenbrock, x);
+
+    EXPECT_LE(result.iterations, 3);
+}
+
+TEST(LbfgsOptimizerTest, WarmStartConvergesFaster)
+{
+    const Eigen::VectorXf target = Eigen::VectorXf::LinSpaced(1000, -1.0f, 1.0f);
+    video_styler::style_transfer::LbfgsOptimizer optimizer;
+
+    Eigen::VectorXf cold = Eigen::VectorXf::Zero(1000);
+    const auto cold_result = optimizer.minimize(quadratic(target), cold);
+
+    Eigen::VectorXf warm = target + Eigen::VectorXf::Constant(1000, 1e-3f);
+    const auto warm_result = optimizer.minimize(quadratic(target), warm);
+
+    EXPECT_LT(warm_result.initial_loss, cold_result.initial_loss);
+    EXPECT_LE(warm_result.iterations, cold_result.iterations);
+    EXPECT_LT((warm - target).norm(), 1e-2f);
+}
+
+TEST(LbfgsOptimizerTest, StopsAtStationaryPoint)
+{
+    const Eigen::VectorXf target = Eigen::VectorXf::Ones(10);
+    video_styler::style_transfer::LbfgsOptimizer optimizer;
+
+    Eigen::VectorXf x = target;
+    const auto result = optimizer.minimize(quadratic(target), x);
+
+    EXPECT_EQ(result.iterations, 0);
+    EXPECT_EQ(result.stop_reason, video_styler::style_transfer::LbfgsStopReason::GRADIENT_CONVERGED);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "video_processor/live_capture.hpp"
+#include "video_processor/video_loader.hpp"
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+class LiveCaptureTest : public ::testing::Test
+{
+protected:
+    // Synthetic camera: frames carry their index in the first pixel
+    video_styler::video_processor::LiveCapture::FrameSource makeGenerator(int total_frames, std::chrono::milliseconds interval)
+    {
+        return [this, total_frames, interval](cv::Mat &frame)
+        {
+            if (generated_ >= total_frames)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(interval);
+            frame = cv::Mat(24, 32, CV_8UC3, cv::Scalar(generated_ % 256, 0, 0));
+            ++generated_;
+            return true;
+        };
+    }
+
+    int generated_{0};
+};
+
+TEST_F(LiveCaptureTest, DeliversFramesInOrder)
+{
+    video_styler::video_processor::LiveCapture capture(makeGenerator(5, 20ms));
+    ASSERT_TRUE(capture.start());
+    EXPECT_FALSE(capture.start());
+
+    video_styler::video_processor::CapturedFrame frame;
+    std::uint64_t last_sequence = 0;
+    int received = 0;
+    while (capture.waitForFrame(frame, 1000ms))
+    {
+        if (received > 0)
+        {
+            EXPECT_GT(frame.sequence, last_sequence);
+        }
+        last_sequence = frame.sequence;
+        EXPECT_FALSE(frame.image.empty());
+        ++received;
+    }
+
+    EXPECT_TRUE(capture.isFinished());
+    EXPECT_EQ(capture.getCapturedFrames(), 5u);
+    EXPECT_EQ(received + static_cast<int>(capture.getDroppedFrames()), 5);
+}
+
+TEST_F(LiveCaptureTest, SlowConsumerGetsFreshestFrame)
+{
+    video_styler::video_processor::LiveCapture capture(makeGenerator(1000, 1ms));
+    capture.start();
+
+    video_styler::video_processor::CapturedFrame first;
+    ASSERT_TRUE(capture.waitForFrame(first, 1000ms));
+
+    // Simulate a stylization step much slower than the source
+    std::this_thread::sleep_for(100ms);
+
+    video_styler::video_processor::CapturedFrame second;
+    ASSERT_TRUE(capture.waitForFrame(second, 1000ms));
+    capture.stop();
+
+    // The backlog was skipped rather than queued
+    EXPECT_GT(second.sequence, first.sequence + 1);
+    EXPECT_GT(capture.getDroppedFrames(), 0u);
+    EXPECT_LT(std::chrono::steady_clock::now() - second.capture_time, 1s);
+}
+
+TEST_F(LiveCaptureTest, TimesOutWithoutFrames)
+{
+    video_styler::video_processor::LiveCapture capture([](cv::Mat &)
+                                                       {
+                                                           std::this_thread::sleep_for(200ms);
+                                                           return false; });
+    capture.start();
+
+    video_styler::video_processor::CapturedFrame frame;
+    EXPECT_FALSE(capture.waitForFrame(frame, 10ms));
+    capture.stop();
+    EXPECT_TRUE(capture.isFinished());
+}
+
+TEST_F(LiveCaptureTest, OpenMissingDeviceFails)
+{
+    video_styler::video_processor::VideoLoader loader;
+    EXPECT_FALSE(loader.openDevice("/dev/video_styler_missing"));
+    EXPECT_FALSE(loader.isLoaded());
+    EXPECT_FALSE(loader.isLive());
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include "utils/memory_budget.hpp"
+#include "video_processor/decode_ahead.hpp"
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using video_styler::utils::MemoryBudget;
+using video_styler::utils::MemoryLease;
+using video_styler::video_processor::DecodeAhead;
+using video_styler::video_processor::DecodedFrame;
+
+TEST(MemoryBudgetTest, UnlimitedBudgetOnlyTracks)
+{
+    MemoryBudget budget;
+    EXPECT_FALSE(budget.isLimited());
+    EXPECT_TRUE(budget.tryAcquire(1u << 30));
+    EXPECT_TRUE(budget.tryAcquire(1u << 30));
+    budget.release(1u << 30);
+    EXPECT_EQ(budget.getInUse(), 1u << 30);
+    EXPECT_EQ(budget.getPeak(), 2u << 30);
+}
+
+TEST(MemoryBudgetTest, RefusesWhatDoesNotFit)
+{
+    MemoryBudget budget(100);
+    EXPECT_TRUE(budget.tryAcquire(60));
+    EXPECT_FALSE(budget.tryAcquire(50));
+    EXPECT_TRUE(budget.tryAcquire(40));
+    EXPECT_EQ(budget.getInUse(), 100u);
+    budget.release(60);
+    EXPECT_TRUE(budget.tryAcquire(50));
+    EXPECT_EQ(budget.getPeak(), 100u);
+}
+
+TEST(MemoryBudgetTest, OversizedRequestIsGrantedWhenIdle)
+{
+    MemoryBudget budget(100);
+    EXPECT_TRUE(budget.tryAcquire(250));
+    EXPECT_FALSE(budget.tryAcquire(1));
+    budget.release(250);
+    EXPECT_EQ(budget.getInUse(), 0u);
+}
+
+TEST(MemoryBudgetTest, DeferredCallbackRunsOnRelease)
+{
+    MemoryBudget budget(100);
+    ASSERT_TRUE(budget.tryAcquire(80));
+
+    int retries = 0;
+    EXPECT_FALSE(budget.tryAcquire(50, [&retries]
+                                   { ++retries; }));
+    EXPECT_EQ(retries, 0);
+    budget.release(80);
+    EXPECT_EQ(retries, 1);
+
+    // Called once only
+    ASSERT_TRUE(budget.tryAcquire(10));
+    budget.release(10);
+    EXPECT_EQ(retries, 1);
+}
+
+TEST(MemoryBudgetTest, BlockingAcquireWaitsForRelease)
+{
+    MemoryBudget budget(100);
+    ASSERT_TRUE(budget.tryAcquire(100));
+
+    std::atomic<bool> cancelled{false};
+    std::atomic<bool> acquired{false};
+    std::thread waiter([&]
+                       { acquired = budget.acquire(30, cancelled); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(acquired.load());
+
+    budget.release(100);
+    waiter.join();
+    EXPECT_TRUE(acquired.load());
+    EXPECT_EQ(budget.getInUse(), 30u);
+}
+
+TEST(MemoryBudgetTest, BlockingAcquireCanBeCancelled)
+{
+    MemoryBudget budget(100);
+    ASSERT_TRUE(budget.tryAcquire(100));
+
+    std::atomic<bool> cancelled{false};
+    bool acquired = true;
+    std::thread waiter([&]
+                       { acquired = budget.acquire(30, cancelled); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    cancelled = true;
+    budget.cancelWaits();
+    waiter.join();
+    EXPECT_FALSE(acquired);
+    EXPECT_EQ(budget.getInUse(), 100u);
+}
+
+TEST(MemoryBudgetTest, LeaseReleasesOnceWhenMoved)
+{
+    MemoryBudget budget(100);
+    ASSERT_TRUE(budget.tryAcquire(40));
+    {
+        MemoryLease lease(&budget, 40);
+        MemoryLease moved(std::move(lease));
+        EXPECT_EQ(lease.getBytes(), 0u);
+        EXPECT_EQ(moved.getBytes(), 40u);
+        EXPECT_EQ(budget.getInUse(), 40u);
+    }
+    EXPECT_EQ(budget.getInUse(), 0u);
+}
+
+TEST(MemoryBudgetTest, ParsesSizes)
+{
+    std::size_t bytes = 0;
+    ASSERT_TRUE(MemoryBudget::parseSize("1048576", bytes));
+    EXPECT_EQ(bytes, 1048576u);
+    ASSERT_TRUE(MemoryBudget::parseSize("512M", bytes));
+    EXPECT_EQ(bytes, 512u << 20);
+    ASSERT_TRUE(MemoryBudget::parseSize("2GB", bytes));
+    EXPECT_EQ(bytes, 2ull << 30);
+    ASSERT_TRUE(MemoryBudget::parseSize("1.5g", bytes));
+    EXPECT_EQ(bytes, 3ull << 29);
+    ASSERT_TRUE(MemoryBudget::parseSize("800k", bytes));
+    EXPECT_EQ(bytes, 800u << 10);
+
+    EXPECT_FALSE(MemoryBudget::parseSize("", bytes));
+    EXPECT_FALSE(MemoryBudget::parseSize("G", bytes));
+    EXPECT_FALSE(MemoryBudget::parseSize("12X", bytes));
+    EXPECT_FALSE(MemoryBudget::parseSize("-4G", bytes));
+}
+
+TEST(MemoryBudgetTest, FrameBytes)
+{
+    EXPECT_EQ(MemoryBudget::frameBytes(3840, 2160), 3840u * 2160u * 3u);
+    EXPECT_EQ(MemoryBudget::frameBytes(640, 480, 1), 640u * 480u);
+}
+
+TEST(MemoryBudgetTest, ReportsPeakResidentSize)
+{
+#ifdef __linux__
+    EXPECT_GT(MemoryBudget::peakResidentBytes(), 0u);
+#endif
+    EXPECT_FALSE(MemoryBudget(1 << 20).describe().empty());
+}
+
+namespace
+{
+    DecodeAhead::FrameSource countingSource(int frames)
+    {
+        auto next = std::make_shared<int>(0);
+        return [next, frames](cv::Mat &frame)
+        {
+            if (*next >= frames)
+            {
+                return false;
+            }
+            frame = cv::Mat(4, 4, CV_8UC3, cv::Scalar::all((*next)++));
+            return true;
+        };
+    }
+} // namespace
+
+TEST(DecodeAheadTest, DeliversEveryFrameInOrder)
+{
+    DecodeAhead decoder(countingSource(50), 48, 4);
+    DecodedFrame frame;
+    int expected = 0;
+    while (decoder.read(frame))
+    {
+        EXPECT_EQ(frame.image.at<cv::Vec3b>(0, 0)[0], expected);
+        ++expected;
+    }
+    EXPECT_EQ(expected, 50);
+    EXPECT_LE(decoder.getPeakQueued(), 4u);
+}
+
+TEST(DecodeAheadTest, BudgetHoldsTheDecoderBack)
+{
+    // Room for three frames: the consumer's and two queued, although the queue allows eight
+    MemoryBudget budget(3 * 48);
+    DecodeAhead decoder(countingSource(40), 48, 8, &budget);
+    DecodedFrame frame;
+    int frames = 0;
+    while (decoder.read(frame))
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        ++frames;
+    }
+    EXPECT_EQ(frames, 40);
+    EXPECT_LE(budget.getPeak(), budget.getCapacity());
+    EXPECT_LE(decoder.getPeakQueued(), 3u);
+    EXPECT_EQ(budget.getInUse(), 0u);
+}
+
+TEST(DecodeAheadTest, StopsWhileBlockedOnTheBudget)
+{
+    MemoryBudget budget(48);
+    DecodedFrame held;
+    {
+        DecodeAhead decoder(countingSource(1000), 48, 4, &budget);
+        ASSERT_TRUE(decoder.read(held));
+        // The decoder now waits for the held frame's bytes; destruction must not hang
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(budget.getInUse(), 48u);
+    held = DecodedFrame();
+    EXPECT_EQ(budget.getInUse(), 0u);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "style_transfer/neural_style_transfer.hpp"
+#include "utils/thread_pool.hpp"
 #include <opencv2/opencv.hpp>
 #include <filesystem>
 
@@ -101,3 +102,213 @@ TEST_F(NeuralStyleTransferTest, ApplyStyleTransferWithStyle)
     EXPECT_FALSE(output_frame.empty());
     EXPECT_EQ(output_frame.size(), input_frame.size());
 }
+
+TEST_F(NeuralStyleTransferTest, DefaultModeIsFast)
+{
+    video_styler::style_transfer::NeuralStyleTransfer nst;
+    EXPECT_EQ(nst.getMode(), video_styler::style_transfer::TransferMode::FAST);
+}
+
+TEST_F(NeuralStyleTransferTest, OptimizationModeRespectsIterations)
+{
+    if (!fs::exists(test_style_path_))
+    {
+        GTEST_SKIP() << "Could not create test style image";
+    }
+
+    video_styler::style_transfer::NeuralStyleTransfer nst;
+    nst.loadStyleImage(test_style_path_);
+    nst.setMode(video_styler::style_transfer::TransferMode::OPTIMIZATION);
+    nst.setWorkingResolution(64);
+    nst.setParameters(20, 1e3, 1.0);
+
+    cv::Mat input_frame(120, 160, CV_8UC3, cv::Scalar(128, 128, 128));
+    cv::circle(input_frame, cv::Point(80, 60), 30, cv::Scalar(20, 200, 20), -1);
+    cv::Mat output_frame;
+
+    ASSERT_TRUE(nst.applyStyleTransfer(input_frame, output_frame));
+    EXPECT_EQ(output_frame.size(), input_frame.size());
+    EXPECT_EQ(output_frame.type(), input_frame.type());
+    EXPECT_GT(nst.getLastIterationCount(), 0);
+    EXPECT_LE(nst.getLastIterationCount(), 20);
+    EXPECT_GT(cv::norm(output_frame, input_frame, cv::NORM_L1), 0.0);
+}
+
+TEST_F(NeuralStyleTransferTest, OptimizationWarmStartNeedsFewerIterations)
+{
+    if (!fs::exists(test_style_path_))
+    {
+        GTEST_SKIP() << "Could not create test style image";
+    }
+
+    video_styler::style_transfer::NeuralStyleTransfer nst;
+    nst.loadStyleImage(test_style_path_);
+    nst.setMode(video_styler::style_transfer::TransferMode::OPTIMIZATION);
+    nst.setWorkingResolution(64);
+    nst.setParameters(200, 1e3, 1.0);
+
+    cv::Mat input_frame(120, 160, CV_8UC3, cv::Scalar(90, 140, 60));
+    cv::rectangle(input_frame, cv::Rect(40, 30, 60, 50), cv::Scalar(220, 30, 30), -1);
+    cv::Mat output_frame;
+
+    ASSERT_TRUE(nst.applyStyleTransfer(input_frame, output_frame));
+    const int cold_iterations = nst.getLastIterationCount();
+
+    // The next, identical frame starts from the previous result
+    ASSERT_TRUE(nst.applyStyleTransfer(input_frame, output_frame));
+    EXPECT_LT(nst.getLastIterationCount(), cold_iterations);
+
+    // After a reset the optimizer starts cold again
+    nst.resetTemporalState();
+    ASSERT_TRUE(nst.applyStyleTransfer(input_frame, output_frame));
+    EXPECT_EQ(nst.getLastIterationCount(), cold_iterations);
+}
+
+TEST_F(NeuralStyleTransferTest, ActiveRegionSnapsToTiles)
+{
+    cv::Mat mask = cv::Mat::zeros(120, 160, CV_8UC1);
+    EXPECT_TRUE(video_styler::style_transfer::NeuralStyleTransfer::activeRegion(mask).empty());
+
+    mask(cv::Rect(40, 35, 10, 10)).setTo(255);
+    EXPECT_EQ(video_styler::style_transfer::NeuralStyleTransfer::activeRegion(mask, 32), cv::Rect(32, 32, 32, 32));
+
+    // Clipped at the frame border
+    mask(cv::Rect(150, 110, 10, 10)).setTo(255);
+    EXPECT_EQ(video_styler::style_transfer::NeuralStyleTransfer::activeRegion(mask, 32), cv::Rect(32, 32, 128, 88));
+}
+
+TEST_F(NeuralStyleTransferTest, MaskedTransferLeavesOutsideUntouched)
+{
+    if (!fs::exists(test_style_path_))
+    {
+        GTEST_SKIP() << "Could not create test style image";
+    }
+
+    video_styler::style_transfer::NeuralStyleTransfer nst;
+    ASSERT_TRUE(nst.loadStyleImage(test_style_path_));
+
+    cv::Mat input_frame(120, 160, CV_8UC3, cv::Scalar(100, 150, 200));
+    cv::Mat mask = cv::Mat::zeros(input_frame.size(), CV_8UC1);
+    const cv::Rect active(64, 32, 40, 30);
+    mask(active).setTo(255);
+
+    cv::Mat output_frame;
+    ASSERT_TRUE(nst.applyStyleTransfer(input_frame, mask, output_frame));
+    ASSERT_EQ(output_frame.size(), input_frame.size());
+    EXPECT_EQ(nst.getLastRegion(), cv::Rect(64, 32, 64, 32));
+
+    cv::Mat outside = output_frame.clone();
+    input_frame.copyTo(outside, mask);
+    EXPECT_EQ(cv::norm(outside, input_frame, cv::NORM_INF), 0.0);
+
+    cv::Mat full;
+    ASSERT_TRUE(nst.applyStyleTransfer(input_frame, full));
+    EXPECT_EQ(cv::norm(output_frame(active), full(active), cv::NORM_INF), 0.0);
+}
+
+TEST_F(NeuralStyleTransferTest, EmptyMaskCopiesInput)
+{
+    if (!fs::exists(test_style_path_))
+    {
+        GTEST_SKIP() << "Could not create test style image";
+    }
+
+    video_styler::style_transfer::NeuralStyleTransfer nst;
+    ASSERT_TRUE(nst.loadStyleImage(test_style_path_));
+
+    const cv::Mat input_frame(60, 80, CV_8UC3, cv::Scalar(10, 20, 30));
+    cv::Mat output_frame;
+    ASSERT_TRUE(nst.applyStyleTransfer(input_frame, cv::Mat::zeros(input_frame.size(), CV_8UC1), output_frame));
+    EXPECT_TRUE(nst.getLastRegion().empty());
+    EXPECT_EQ(cv::norm(output_frame, input_frame, cv::NORM_INF), 0.0);
+
+    // A mask of the wrong size is rejected
+    EXPECT_FALSE(nst.applyStyleTransfer(input_frame, cv::Mat::zeros(10, 10, CV_8UC1), output_frame));
+}
+
+TEST_F(NeuralStyleTransferTest, AsyncStyleIsAwaitedAtTheFirstFrame)
+{
+    if (!fs::exists(test_style_path_))
+    {
+        GTEST_SKIP() << "Could not create test style image";
+    }
+
+    cv::Mat input_frame(120, 160, CV_8UC3, cv::Scalar(90, 140, 60));
+    cv::rectangle(input_frame, cv::Rect(40, 30, 60, 50), cv::Scalar(220, 30, 30), -1);
+
+    for (const auto mode : {video_styler::style_transfer::TransferMode::FAST,
+                            video_styler::style_transfer::TransferMode::OPTIMIZATION})
+    {
+        video_styler::style_transfer::NeuralStyleTransfer reference;
+        reference.setMode(mode);
+        reference.setWorkingResolution(64);
+        reference.setParameters(20, 1e3, 1.0);
+        ASSERT_TRUE(reference.loadStyleImage(test_style_path_));
+
+        video_styler::utils::ThreadPool pool(1);
+        video_styler::style_transfer::NeuralStyleTransfer nst;
+        nst.setMode(mode);
+        nst.setWorkingResolution(64);
+        nst.setParameters(20, 1e3, 1.0);
+        const auto future = nst.loadStyleImageAsync(test_style_path_, pool);
+        ASSERT_TRUE(future.valid());
+
+        // The features of the mode were extracted off-thread
+        const auto &prepared = future.get();
+        ASSERT_FALSE(prepared.image.empty());
+        if (mode == video_styler::style_transfer::TransferMode::FAST)
+        {
+            EXPECT_FALSE(prepared.color_lut.empty());
+        }
+        else
+        {
+            EXPECT_FALSE(prepared.gram.empty());
+            EXPECT_EQ(prepared.gram_side, 64);
+        }
+
+        cv::Mat expected;
+        cv::Mat actual;
+        ASSERT_TRUE(reference.applyStyleTransfer(input_frame, expected));
+        ASSERT_TRUE(nst.applyStyleTransfer(input_frame, actual));
+        EXPECT_TRUE(nst.isStyleLoaded());
+        EXPECT_EQ(cv::norm(actual, expected, cv::NORM_INF), 0.0);
+    }
+}
+
+TEST_F(NeuralStyleTransferTest, AsyncStyleReportsUnreadableFile)
+{
+    video_styler::utils::ThreadPool pool(1);
+    video_styler::style_transfer::NeuralStyleTransfer nst;
+    const auto future = nst.loadStyleImageAsync("non_existent_style.jpg", pool);
+    EXPECT_TRUE(future.get().image.empty());
+    EXPECT_FALSE(nst.awaitStyle());
+
+    cv::Mat input_frame(32, 32, CV_8UC3, cv::Scalar(1, 2, 3));
+    cv::Mat output_frame;
+    EXPECT_FALSE(nst.applyStyleTransfer(input_frame, output_frame));
+}
+
+TEST_F(NeuralStyleTransferTest, PreparedStyleIsSharedBetweenTransfers)
+{
+    cv::Mat style_image(64, 64, CV_8UC3, cv::Scalar(50, 100, 150));
+    cv::circle(style_image, cv::Point(32, 32), 20, cv::Scalar(100, 200, 50), -1);
+    const auto prepared = video_styler::style_transfer::NeuralStyleTransfer::prepareStyle(
+        style_image, video_styler::style_transfer::TransferMode::FAST);
+    ASSERT_FALSE(prepared.color_lut.empty());
+    EXPECT_TRUE(prepared.gram.empty());
+
+    video_styler::style_transfer::NeuralStyleTransfer first;
+    video_styler::style_transfer::NeuralStyleTransfer second;
+    ASSERT_TRUE(first.setPreparedStyle(prepared));
+    ASSERT_TRUE(second.setPreparedStyle(prepared));
+    EXPECT_EQ(first.getColorLut().getSize(), prepared.color_lut.getSize());
+
+    cv::Mat input_frame(48, 64, CV_8UC3, cv::Scalar(20, 120, 220));
+    cv::Mat a;
+    cv::Mat b;
+    ASSERT_TRUE(first.applyStyleTransfer(input_frame, a));
+    ASSERT_TRUE(second.applyStyleTransfer(input_frame, b));
+    EXPECT_EQ(cv::norm(a, b, cv::NORM_INF), 0.0);
+
+    EXPECT_FALSE(first.setPreparedStyle(video_styler::style_transfer::PreparedStyle()));
+}
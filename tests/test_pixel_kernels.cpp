@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include "style_transfer/pixel_kernels.hpp"
+#include "style_transfer/image_ops.hpp"
+#include <opencv2/opencv.hpp>
+#include <limits>
+#include <vector>
+
+using video_styler::style_transfer::PixelKernels;
+using video_styler::utils::CpuIsa;
+
+class PixelKernelsTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        cv::RNG rng(42);
+        bytes_.create(37, 53, CV_8UC3);
+        rng.fill(bytes_, cv::RNG::UNIFORM, 0, 256);
+        floats_.create(37, 53, CV_32FC3);
+        rng.fill(floats_, cv::RNG::UNIFORM, -0.2, 1.2);
+        other_.create(37, 53, CV_32FC3);
+        rng.fill(other_, cv::RNG::UNIFORM, -1.0, 1.0);
+    }
+
+    void TearDown() override
+    {
+        video_styler::style_transfer::selectKernels(CpuIsa::AVX512);
+    }
+
+    // Every variant this CPU can run, generic first
+    std::vector<const PixelKernels *> supportedKernels() const
+    {
+        std::vector<const PixelKernels *> result;
+        for (const CpuIsa isa : {CpuIsa::GENERIC, CpuIsa::SSE42, CpuIsa::AVX2, CpuIsa::AVX512})
+        {
+            if (const auto *kernels = video_styler::style_transfer::kernelsForIsa(isa))
+            {
+                result.push_back(kernels);
+            }
+        }
+        return result;
+    }
+
+    cv::Mat bytes_;
+    cv::Mat floats_;
+    cv::Mat other_;
+};
+
+TEST_F(PixelKernelsTest, GenericVariantIsAlwaysAvailable)
+{
+    const auto *generic = video_styler::style_transfer::kernelsForIsa(CpuIsa::GENERIC);
+    ASSERT_NE(generic, nullptr);
+    EXPECT_EQ(generic->isa, CpuIsa::GENERIC);
+    EXPECT_LE(video_styler::style_transfer::activeKernels().isa, video_styler::utils::detectCpuIsa());
+}
+
+TEST_F(PixelKernelsTest, SelectionRespectsCap)
+{
+    const auto &kernels = video_styler::style_transfer::selectKernels(CpuIsa::GENERIC);
+    EXPECT_EQ(kernels.isa, CpuIsa::GENERIC);
+    EXPECT_EQ(&video_styler::style_transfer::activeKernels(), &kernels);
+}
+
+TEST_F(PixelKernelsTest, IsaNamesRoundTrip)
+{
+    for (const CpuIsa isa : {CpuIsa::GENERIC, CpuIsa::SSE42, CpuIsa::AVX2, CpuIsa::AVX512})
+    {
+        CpuIsa parsed = CpuIsa::GENERIC;
+        ASSERT_TRUE(video_styler::utils::parseCpuIsa(video_styler::utils::cpuIsaToString(isa), parsed));
+        EXPECT_EQ(parsed, isa);
+    }
+    CpuIsa parsed = CpuIsa::GENERIC;
+    EXPECT_FALSE(video_styler::utils::parseCpuIsa("neon", parsed));
+}
+
+TEST_F(PixelKernelsTest, ConversionsMatchOpenCV)
+{
+    cv::Mat expected_float;
+    bytes_.convertTo(expected_float, CV_32F, 1.0 / 255.0);
+    cv::Mat expected_bytes;
+    floats_.convertTo(expected_bytes, CV_8U, 255.0);
+
+    for (const auto *kernels : supportedKernels())
+    {
+        video_styler::style_transfer::selectKernels(kernels->isa);
+
+        cv::Mat converted;
+        video_styler::style_transfer::convertToFloat(bytes_, converted, 1.0f / 255.0f);
+        EXPECT_LE(cv::norm(converted, expected_float, cv::NORM_INF), 1e-6) << video_styler::utils::cpuIsaToString(kernels->isa);
+
+        // Rounding of exact halves may differ by one level
+        video_styler::style_transfer::convertToByte(floats_, converted, 255.0f);
+        EXPECT_LE(cv::norm(converted, expected_bytes, cv::NORM_INF), 1.0) << video_styler::utils::cpuIsaToString(kernels->isa);
+    }
+}
+
+TEST_F(PixelKernelsTest, VariantsAgreeBitForBitOnElementwiseKernels)
+{
+    const auto variants = supportedKernels();
+    const std::size_t count = floats_.total() * 3;
+
+    std::vector<std::uint8_t> reference_bytes(count);
+    std::vector<float> reference_blend(count);
+    std::vector<float> reference_difference(count);
+    variants.front()->floats_to_bytes(floats_.ptr<float>(), reference_bytes.data(), count, 255.0f);
+    variants.front()->blend(floats_.ptr<float>(), other_.ptr<float>(), reference_blend.data(), count, 0.3f, 0.7f);
+    variants.front()->add_difference(floats_.ptr<float>(), other_.ptr<float>(), floats_.ptr<float>(),
+                                     reference_difference.data(), count);
+
+    for (const auto *kernels : variants)
+    {
+        std::vector<std::uint8_t> bytes(count);
+        std::vector<float> blended(count);
+        std::vector<float> difference(count);
+        kernels->floats_to_bytes(floats_.ptr<float>(), bytes.data(), count, 255.0f);
+        kernels->blend(floats_.ptr<float>(), other_.ptr<float>(), blended.data(), count, 0.3f, 0.7f);
+        kernels->add_difference(floats_.ptr<float>(), other_.ptr<float>(), floats_.ptr<float>(), difference.data(), count);
+
+        EXPECT_EQ(bytes, reference_bytes) << video_styler::utils::cpuIsaToString(kernels->isa);
+        EXPECT_EQ(blended, reference_blend) << video_styler::utils::cpuIsaToString(kernels->isa);
+        EXPECT_EQ(difference, reference_difference) << video_styler::utils::cpuIsaToString(kernels->isa);
+    }
+}
+
+TEST_F(PixelKernelsTest, NanSaturatesToZero)
+{
+    const float values[3] = {std::numeric_limits<float>::quiet_NaN(), -5.0f, 9.0f};
+    for (const auto *kernels : supportedKernels())
+    {
+        std::uint8_t bytes[3] = {1, 1, 1};
+        kernels->floats_to_bytes(values, bytes, 3, 255.0f);
+        EXPECT_EQ(bytes[0], 0);
+        EXPECT_EQ(bytes[1], 0);
+        EXPECT_EQ(bytes[2], 255);
+    }
+}
+
+TEST_F(PixelKernelsTest, ResizeMatchesOpenCVBilinear)
+{
+    for (const cv::Size size : {cv::Size(106, 74), cv::Size(200, 41), cv::Size(20, 15)})
+    {
+        cv::Mat expected;
+        cv::resize(floats_, expected, size, 0, 0, cv::INTER_LINEAR);
+
+        for (const auto *kernels : supportedKernels())
+        {
+            video_styler::style_transfer::selectKernels(kernels->isa);
+            cv::Mat resized;
+            video_styler::style_transfer::resizeBilinear(floats_, resized, size);
+            ASSERT_EQ(resized.size(), size);
+            EXPECT_LE(cv::norm(resized, expected, cv::NORM_INF), 1e-4) << video_styler::utils::cpuIsaToString(kernels->isa);
+        }
+    }
+}
+
+TEST_F(PixelKernelsTest, GramMatchesReference)
+{
+    cv::Mat features(1001, 9, CV_32F);
+    cv::RNG(7).fill(features, cv::RNG::UNIFORM, -1.0, 1.0);
+    const cv::Mat expected = features.t() * features;
+
+    for (const auto *kernels : supportedKernels())
+    {
+        video_styler::style_transfer::selectKernels(kernels->isa);
+        const cv::Mat gram = video_styler::style_transfer::gramMatrix(features);
+        ASSERT_EQ(gram.size(), cv::Size(9, 9));
+        EXPECT_LE(cv::norm(gram, expected, cv::NORM_INF), 1e-3) << video_styler::utils::cpuIsaToString(kernels->isa);
+        EXPECT_LE(cv::norm(gram, gram.t(), cv::NORM_INF), 0.0);
+    }
+}
+
+TEST_F(PixelKernelsTest, GramVariantsAgreeBitForBit)
+{
+    // Row counts below, at and past a multiple of the accumulator width
+    for (const int rows : {5, 16, 1001})
+    {
+        cv::Mat features(rows, 16, CV_32F);
+        cv::RNG(rows).fill(features, cv::RNG::UNIFORM, -1.0, 1.0);
+
+        const auto variants = supportedKernels();
+        std::vector<float> reference(16 * 16);
+        variants.front()->gram(features.ptr<float>(), features.rows, features.cols, reference.data());
+
+        for (const auto *kernels : variants)
+        {
+            std::vector<float> gram(16 * 16);
+            kernels->gram(features.ptr<float>(), features.rows, features.cols, gram.data());
+            EXPECT_EQ(gram, reference) << video_styler::utils::cpuIsaToString(kernels->isa) << ", " << rows << " rows";
+        }
+    }
+}
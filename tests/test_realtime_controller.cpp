@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "video_processor/realtime_controller.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+TEST(RealtimeControllerTest, BudgetDefaultsToFrameInterval)
+{
+    video_styler::video_processor::RealtimeController controller(25.0);
+    EXPECT_DOUBLE_EQ(controller.getLatencyBudget(), 40.0);
+    EXPECT_EQ(controller.getLevelIndex(), 0);
+    EXPECT_DOUBLE_EQ(controller.getLevel().scale, 1.0);
+}
+
+TEST(RealtimeControllerTest, StepsDownWhenOverBudget)
+{
+    video_styler::video_processor::RealtimeController controller(30.0, 20.0);
+
+    bool changed = false;
+    for (int i = 0; i < 10 && !changed; ++i)
+    {
+        changed = controller.recordLatency(80.0);
+    }
+
+    EXPECT_TRUE(changed);
+    EXPECT_EQ(controller.getLevelIndex(), 1);
+    EXPECT_LT(controller.getLevel().scale, 1.0);
+}
+
+TEST(RealtimeControllerTest, StopsAtCheapestLevel)
+{
+    video_styler::video_processor::RealtimeController controller(30.0, 20.0);
+    controller.setLevels({{1.0, 100}, {0.5, 10}});
+
+    for (int i = 0; i < 100; ++i)
+    {
+        controller.recordLatency(500.0);
+    }
+
+    EXPECT_EQ(controller.getLevelIndex(), 1);
+    EXPECT_EQ(controller.getLevel().iterations, 10);
+}
+
+TEST(RealtimeControllerTest, RecoversWhenUnderBudget)
+{
+    video_styler::video_processor::RealtimeController controller(30.0, 20.0);
+    for (int i = 0; i < 10; ++i)
+    {
+        controller.recordLatency(80.0);
+    }
+    const int degraded = controller.getLevelIndex();
+    ASSERT_GT(degraded, 0);
+
+    for (int i = 0; i < 200; ++i)
+    {
+        controller.recordLatency(1.0);
+    }
+
+    EXPECT_EQ(controller.getLevelIndex(), 0);
+}
+
+TEST(RealtimeControllerTest, DropsOnlyFramesLaterThanBudget)
+{
+    video_styler::video_processor::RealtimeController controller(30.0, 20.0);
+
+    EXPECT_FALSE(controller.shouldDrop(5.0));
+    EXPECT_TRUE(controller.shouldDrop(25.0));
+    EXPECT_EQ(controller.getDroppedFrames(), 1);
+}
+
+TEST(RealtimeControllerTest, WritesStatusFile)
+{
+    const std::string status_path = "test_realtime_status.json";
+    video_styler::video_processor::RealtimeController controller(30.0);
+    controller.recordLatency(10.0);
+
+    ASSERT_TRUE(controller.writeStatus(status_path));
+
+    std::ifstream status(status_path);
+    std::string content((std::istreambuf_iterator<char>(status)),
+                        std::istreambuf_iterator<char>());
+    EXPECT_NE(content.find("\"scale\""), std::string::npos);
+    EXPECT_NE(content.find("\"dropped_frames\""), std::string::npos);
+
+    fs::remove(status_path);
+}
+
+TEST(RealtimeControllerTest, DefaultLevelsFollowConfiguredIterations)
+{
+    const auto levels = video_styler::video_processor::RealtimeController::defaultLevels(50);
+    ASSERT_FALSE(levels.empty());
+    EXPECT_EQ(levels[0].iterations, 50);
+    EXPECT_DOUBLE_EQ(levels[0].scale, 1.0);
+    for (std::size_t i = 1; i < levels.size(); ++i)
+    {
+        EXPECT_LE(levels[i].iterations, levels[i - 1].iterations);
+        EXPECT_LT(levels[i].scale, levels[i - 1].scale);
+        EXPECT_GE(levels[i].iterations, 1);
+    }
+
+    video_styler::video_processor::RealtimeController controller(30.0);
+    controller.setLevels(levels);
+    EXPECT_EQ(controller.getLevel().iterations, 50);
+
+    // Never below one iteration, even for tiny counts
+    for (const auto &level : video_styler::video_processor::RealtimeController::defaultLevels(2))
+    {
+        EXPECT_GE(level.iterations, 1);
+    }
+}
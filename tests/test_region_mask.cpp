@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "video_processor/region_mask.hpp"
+#include <opencv2/opencv.hpp>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+using video_styler::video_processor::RegionMask;
+using video_styler::video_processor::RegionSource;
+
+class RegionMaskTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        test_dir_ = "region_mask_test";
+        fs::create_directories(test_dir_);
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(test_dir_);
+    }
+
+    std::string test_dir_;
+};
+
+TEST_F(RegionMaskTest, ParsesRectangle)
+{
+    cv::Rect rect;
+    ASSERT_TRUE(RegionMask::parseRectangle("10,20,30,40", rect));
+    EXPECT_EQ(rect, cv::Rect(10, 20, 30, 40));
+
+    EXPECT_FALSE(RegionMask::parseRectangle("10,20,30", rect));
+    EXPECT_FALSE(RegionMask::parseRectangle("10,20,0,40", rect));
+    EXPECT_FALSE(RegionMask::parseRectangle("10;20;30;40", rect));
+    EXPECT_FALSE(RegionMask::parseRectangle("10,20,30,40,50", rect));
+}
+
+TEST_F(RegionMaskTest, NoSourceYieldsNoMask)
+{
+    RegionMask region;
+    cv::Mat mask;
+    EXPECT_EQ(region.getSource(), RegionSource::NONE);
+    EXPECT_FALSE(region.next(cv::Size(64, 48), mask));
+}
+
+TEST_F(RegionMaskTest, RectangleIsClippedToFrame)
+{
+    RegionMask region;
+    ASSERT_TRUE(region.setRectangle(cv::Rect(40, 30, 100, 100)));
+
+    cv::Mat mask;
+    ASSERT_TRUE(region.next(cv::Size(64, 48), mask));
+    ASSERT_EQ(mask.size(), cv::Size(64, 48));
+    EXPECT_EQ(mask.type(), CV_8UC1);
+    EXPECT_EQ(cv::countNonZero(mask), 24 * 18);
+    EXPECT_EQ(mask.at<uchar>(30, 40), 255);
+    EXPECT_EQ(mask.at<uchar>(29, 40), 0);
+}
+
+TEST_F(RegionMaskTest, MaskImageIsScaledToFrame)
+{
+    const std::string path = test_dir_ + "/mask.png";
+    cv::Mat image = cv::Mat::zeros(24, 32, CV_8UC1);
+    image(cv::Rect(0, 0, 16, 24)).setTo(255);
+    ASSERT_TRUE(cv::imwrite(path, image));
+
+    RegionMask region;
+    ASSERT_TRUE(region.loadImage(path));
+    EXPECT_EQ(region.getSource(), RegionSource::IMAGE);
+
+    cv::Mat mask;
+    ASSERT_TRUE(region.next(cv::Size(64, 48), mask));
+    ASSERT_EQ(mask.size(), cv::Size(64, 48));
+    EXPECT_EQ(mask.at<uchar>(24, 4), 255);
+    EXPECT_EQ(mask.at<uchar>(24, 60), 0);
+
+    EXPECT_FALSE(region.loadImage(test_dir_ + "/missing.png"));
+}
+
+TEST_F(RegionMaskTest, MatteAdvancesPerFrameAndRepeatsLast)
+{
+    const std::string path = test_dir_ + "/matte.avi";
+    cv::VideoWriter writer(path, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), 10.0, cv::Size(64, 48));
+    if (!writer.isOpened())
+    {
+        GTEST_SKIP() << "Could not create matte video";
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        cv::Mat frame = cv::Mat::zeros(48, 64, CV_8UC3);
+        frame(cv::Rect(i * 32, 0, 32, 48)).setTo(cv::Scalar::all(255));
+        writer.write(frame);
+    }
+    writer.release();
+
+    RegionMask region;
+    ASSERT_TRUE(region.openMatte(path));
+
+    cv::Mat mask;
+    ASSERT_TRUE(region.next(cv::Size(64, 48), mask));
+    EXPECT_GT(mask.at<uchar>(24, 8), 200);
+    EXPECT_EQ(mask.at<uchar>(24, 56), 0);
+
+    ASSERT_TRUE(region.next(cv::Size(64, 48), mask));
+    EXPECT_EQ(mask.at<uchar>(24, 8), 0);
+    EXPECT_GT(mask.at<uchar>(24, 56), 200);
+    EXPECT_FALSE(region.isMatteExhausted());
+
+    ASSERT_TRUE(region.next(cv::Size(64, 48), mask));
+    EXPECT_TRUE(region.isMatteExhausted());
+    EXPECT_GT(mask.at<uchar>(24, 56), 200);
+}
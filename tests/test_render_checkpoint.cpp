@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+#include "video_processor/render_checkpoint.hpp"
+#include "video_processor/segment_file.hpp"
+#include "style_transfer/neural_style_transfer.hpp"
+#include <opencv2/opencv.hpp>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+using video_styler::style_transfer::NeuralStyleTransfer;
+using video_styler::style_transfer::TensorPrecision;
+using video_styler::style_transfer::TransferMode;
+using video_styler::video_processor::RenderCheckpoint;
+using video_styler::video_processor::ResumeResult;
+using video_styler::video_processor::SegmentReader;
+
+class RenderCheckpointTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        test_dir_ = "render_checkpoint_test";
+        fs::create_directories(test_dir_);
+        output_path_ = test_dir_ + "/output.mp4";
+
+        style_transfer_.setStyleImage(makeStyle());
+    }
+
+    void TearDown() override
+    {
+        // Clean up test files
+        fs::remove_all(test_dir_);
+    }
+
+    static cv::Mat makeStyle()
+    {
+        cv::Mat style_image(64, 64, CV_8UC3, cv::Scalar(50, 100, 150));
+        cv::rectangle(style_image, cv::Rect(12, 12, 40, 40), cv::Scalar(200, 50, 100), -1);
+        cv::circle(style_image, cv::Point(32, 32), 12, cv::Scalar(100, 200, 50), -1);
+        return style_image;
+    }
+
+    static cv::Mat makeFrame(int index)
+    {
+        cv::Mat frame(48, 64, CV_8UC3, cv::Scalar(index * 7 % 256, 255 - index, index * 3 % 256));
+        cv::circle(frame, cv::Point(index * 5 % 64, 24), 6, cv::Scalar(255, 255, 255), -1);
+        return frame;
+    }
+
+    /**
+     * @brief Read every frame of the committed segments in order
+     */
+    static std::vector<cv::Mat> readSegments(const RenderCheckpoint &checkpoint)
+    {
+        std::vector<cv::Mat> frames;
+        for (const auto &segment : checkpoint.getSegments())
+        {
+            std::ifstream in(fs::path(checkpoint.getDirectory()) / segment.file, std::ios::binary);
+            SegmentReader reader(in);
+            EXPECT_TRUE(reader.isValid());
+            cv::Mat frame;
+            while (reader.read(frame))
+            {
+                frames.push_back(frame.clone());
+            }
+        }
+        return frames;
+    }
+
+    static bool identical(const cv::Mat &a, const cv::Mat &b)
+    {
+        return a.size() == b.size() && a.type() == b.type() && cv::norm(a, b, cv::NORM_INF) == 0.0;
+    }
+
+    std::string test_dir_;
+    std::string output_path_;
+    NeuralStyleTransfer style_transfer_;
+};
+
+TEST_F(RenderCheckpointTest, CommitsAFullSegmentAtEveryInterval)
+{
+    RenderCheckpoint checkpoint(output_path_, "job", 4);
+    ASSERT_TRUE(checkpoint.start());
+
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_TRUE(checkpoint.write(makeFrame(i), style_transfer_));
+    }
+    EXPECT_EQ(checkpoint.getCommittedFrames(), 8);
+    EXPECT_EQ(checkpoint.getSegments().size(), 2u);
+
+    ASSERT_TRUE(checkpoint.flush(style_transfer_));
+    EXPECT_EQ(checkpoint.getCommittedFrames(), 10);
+    ASSERT_EQ(checkpoint.getSegments().size(), 3u);
+    EXPECT_EQ(checkpoint.getSegments()[2].first_frame, 8);
+    EXPECT_EQ(checkpoint.getSegments()[2].frame_count, 2);
+
+    const auto frames = readSegments(checkpoint);
+    ASSERT_EQ(frames.size(), 10u);
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_TRUE(identical(frames[i], makeFrame(i))) << "frame " << i;
+    }
+
+    checkpoint.remove();
+    EXPECT_FALSE(fs::exists(checkpoint.getDirectory()));
+}
+
+TEST_F(RenderCheckpointTest, ResumeDiscardsFramesAfterTheLastCheckpoint)
+{
+    {
+        // Killed after 6 frames: only the first segment of 4 was checkpointed
+        RenderCheckpoint checkpoint(output_path_, "job", 4);
+        ASSERT_TRUE(checkpoint.start());
+        for (int i = 0; i < 6; ++i)
+        {
+            ASSERT_TRUE(checkpoint.write(makeFrame(i), style_transfer_));
+        }
+    }
+
+    RenderCheckpoint resumed(output_path_, "job", 4);
+    ASSERT_EQ(resumed.resume(style_transfer_), ResumeResult::RESUMED);
+    EXPECT_EQ(resumed.getCommittedFrames(), 4);
+    ASSERT_EQ(resumed.getSegments().size(), 1u);
+    EXPECT_EQ(std::distance(fs::directory_iterator(resumed.getDirectory()), fs::directory_iterator()), 2);
+
+    for (int i = resumed.getCommittedFrames(); i < 9; ++i)
+    {
+        ASSERT_TRUE(resumed.write(makeFrame(i), style_transfer_));
+    }
+    ASSERT_TRUE(resumed.flush(style_transfer_));
+
+    const auto frames = readSegments(resumed);
+    ASSERT_EQ(frames.size(), 9u);
+    for (int i = 0; i < 9; ++i)
+    {
+        EXPECT_TRUE(identical(frames[i], makeFrame(i))) << "frame " << i;
+    }
+}
+
+TEST_F(RenderCheckpointTest, ResumeWithoutCheckpointStartsFresh)
+{
+    RenderCheckpoint checkpoint(output_path_, "job", 4);
+    EXPECT_EQ(checkpoint.resume(style_transfer_), ResumeResult::STARTED_FRESH);
+    EXPECT_EQ(checkpoint.getCommittedFrames(), 0);
+    EXPECT_TRUE(fs::is_directory(checkpoint.getDirectory()));
+}
+
+TEST_F(RenderCheckpointTest, ResumeRejectsAnotherJob)
+{
+    {
+        RenderCheckpoint checkpoint(output_path_, "input-a", 2);
+        ASSERT_TRUE(checkpoint.start());
+        for (int i = 0; i < 4; ++i)
+        {
+            ASSERT_TRUE(checkpoint.write(makeFrame(i), style_transfer_));
+        }
+    }
+
+    RenderCheckpoint other(output_path_, "input-b", 2);
+    EXPECT_EQ(other.resume(style_transfer_), ResumeResult::STARTED_FRESH);
+    EXPECT_EQ(other.getCommittedFrames(), 0);
+    EXPECT_TRUE(fs::is_empty(other.getDirectory()));
+}
+
+TEST_F(RenderCheckpointTest, ResumeRejectsMissingSegments)
+{
+    {
+        RenderCheckpoint checkpoint(output_path_, "job", 2);
+        ASSERT_TRUE(checkpoint.start());
+        for (int i = 0; i < 4; ++i)
+        {
+            ASSERT_TRUE(checkpoint.write(makeFrame(i), style_transfer_));
+        }
+        fs::remove(fs::path(checkpoint.getDirectory()) / checkpoint.getSegments()[0].file);
+    }
+
+    RenderCheckpoint resumed(output_path_, "job", 2);
+    EXPECT_EQ(resumed.resume(style_transfer_), ResumeResult::STARTED_FRESH);
+    EXPECT_EQ(resumed.getCommittedFrames(), 0);
+}
+
+TEST_F(RenderCheckpointTest, ResumeReportsAFailedFreshStart)
+{
+    // A regular file where the checkpoint's parent directory should be
+    const std::string blocker = output_path_ + ".blocker";
+    std::ofstream(blocker) << "x";
+
+    RenderCheckpoint checkpoint(blocker + "/out.mp4", "job", 2);
+    EXPECT_EQ(checkpoint.resume(style_transfer_), ResumeResult::FAILED);
+    EXPECT_FALSE(checkpoint.start());
+}
+
+TEST_F(RenderCheckpointTest, ResumedWarmStartMatchesUninterruptedRun)
+{
+    for (const TensorPrecision precision : {TensorPrecision::FP32, TensorPrecision::FP16})
+    {
+        auto configure = [precision](NeuralStyleTransfer &nst)
+        {
+            nst.setMode(TransferMode::OPTIMIZATION);
+            nst.setWorkingResolution(32);
+            nst.setParameters(10, 1e3, 1.0);
+            nst.setTensorPrecision(precision);
+        };
+        configure(style_transfer_);
+
+        cv::Mat stylized;
+        ASSERT_TRUE(style_transfer_.applyStyleTransfer(makeFrame(0), stylized));
+        RenderCheckpoint checkpoint(output_path_, "job", 1);
+        ASSERT_TRUE(checkpoint.start());
+        ASSERT_TRUE(checkpoint.write(stylized, style_transfer_));
+
+        NeuralStyleTransfer restarted;
+        restarted.setStyleImage(makeStyle());
+        configure(restarted);
+        RenderCheckpoint resumed(output_path_, "job", 1);
+        ASSERT_EQ(resumed.resume(restarted), ResumeResult::RESUMED);
+
+        cv::Mat expected;
+        cv::Mat actual;
+        ASSERT_TRUE(style_transfer_.applyStyleTransfer(makeFrame(1), expected));
+        ASSERT_TRUE(restarted.applyStyleTransfer(makeFrame(1), actual));
+        EXPECT_EQ(restarted.getLastIterationCount(), style_transfer_.getLastIterationCount());
+        EXPECT_TRUE(identical(actual, expected)) << video_styler::style_transfer::tensorPrecisionToString(precision);
+    }
+}
@@ -0,0 +1,373 @@
+#include <gtest/gtest.h>
+#include "video_processor/segment_file.hpp"
+#include "video_processor/shard_coordinator.hpp"
+#include "video_processor/shard_protocol.hpp"
+#include "video_processor/shard_worker.hpp"
+#include "style_transfer/neural_style_transfer.hpp"
+#include <opencv2/opencv.hpp>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+
+namespace fs = std::filesystem;
+using video_styler::video_processor::RenderSettings;
+using video_styler::video_processor::SegmentReader;
+using video_styler::video_processor::SegmentWriter;
+using video_styler::video_processor::ShardCoordinator;
+using video_styler::video_processor::ShardMessage;
+using video_styler::video_processor::ShardMessageType;
+using video_styler::video_processor::ShardSettings;
+using video_styler::video_processor::ShardWorker;
+using video_styler::video_processor::WorkerEndpoint;
+
+namespace
+{
+    // Set in the environment of worker processes spawned by the localhost test
+    constexpr const char *kWorkerPortFileVariable = "VIDEO_STYLER_SHARD_WORKER_PORT_FILE";
+
+    cv::Mat testFrame(int index)
+    {
+        cv::Mat frame(120, 160, CV_8UC3);
+        for (int y = 0; y < frame.rows; ++y)
+        {
+            for (int x = 0; x < frame.cols; ++x)
+            {
+                frame.at<cv::Vec3b>(y, x) = cv::Vec3b(static_cast<uchar>(x + index * 4), static_cast<uchar>(y * 2),
+                                                      static_cast<uchar>((x + y + index * 9) % 256));
+            }
+        }
+        return frame;
+    }
+
+    std::vector<cv::Mat> readAllFrames(const std::string &path)
+    {
+        std::vector<cv::Mat> frames;
+        cv::VideoCapture capture(path);
+        cv::Mat frame;
+        while (capture.read(frame))
+        {
+            frames.push_back(frame.clone());
+        }
+        return frames;
+    }
+} // namespace
+
+// Entry point of the worker processes the localhost test spawns from this binary
+TEST(ShardingWorkerProcess, Serve)
+{
+    const char *port_file = std::getenv(kWorkerPortFileVariable);
+    if (port_file == nullptr)
+    {
+        GTEST_SKIP() << "Only runs inside a worker process spawned by ShardingTest";
+    }
+
+    ShardWorker worker;
+    ASSERT_TRUE(worker.listen("127.0.0.1", 0));
+    const std::string temp_path = std::string(port_file) + ".tmp";
+    {
+        std::ofstream out(temp_path);
+        out << worker.getPort();
+    }
+    fs::rename(temp_path, port_file);
+    worker.serve();
+}
+
+class ShardingTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        test_dir_ = fs::absolute("sharding_test").string();
+        fs::create_directories(test_dir_);
+
+        style_path_ = test_dir_ + "/style.png";
+        cv::imwrite(style_path_, cv::Mat(64, 64, CV_8UC3, cv::Scalar(40, 120, 200)));
+    }
+
+    void TearDown() override
+    {
+        for (const pid_t pid : worker_pids_)
+        {
+            kill(pid, SIGKILL);
+            waitpid(pid, nullptr, 0);
+        }
+        fs::remove_all(test_dir_);
+    }
+
+    bool createTestVideo(const std::string &path, int frames)
+    {
+        cv::VideoWriter writer(path, cv::VideoWriter::fourcc('M', 'P', '4', 'V'), 30.0, cv::Size(160, 120));
+        if (!writer.isOpened())
+        {
+            return false;
+        }
+        for (int i = 0; i < frames; ++i)
+        {
+            writer.write(testFrame(i));
+        }
+        writer.release();
+        return true;
+    }
+
+    /**
+     * @brief Start a worker process (this test binary running ShardingWorkerProcess.Serve)
+     * @return Port the worker listens on, or 0 on failure
+     */
+    unsigned short spawnWorker()
+    {
+        const std::string port_file = test_dir_ + "/worker_" + std::to_string(worker_pids_.size()) + ".port";
+        std::vector<std::string> environment;
+        for (char **entry = environ; *entry != nullptr; ++entry)
+        {
+            environment.emplace_back(*entry);
+        }
+        environment.push_back(std::string(kWorkerPortFileVariable) + "=" + port_file);
+
+        std::vector<char *> envp;
+        for (auto &entry : environment)
+        {
+            envp.push_back(entry.data());
+        }
+        envp.push_back(nullptr);
+
+        std::string program = fs::read_symlink("/proc/self/exe").string();
+        std::string filter = "--gtest_filter=ShardingWorkerProcess.Serve";
+        char *argv[] = {program.data(), filter.data(), nullptr};
+
+        pid_t pid = 0;
+        if (posix_spawn(&pid, program.c_str(), nullptr, nullptr, argv, envp.data()) != 0)
+        {
+            return 0;
+        }
+        worker_pids_.push_back(pid);
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            std::ifstream in(port_file);
+            unsigned short port = 0;
+            if (in >> port)
+            {
+                return port;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        return 0;
+    }
+
+    std::string test_dir_;
+    std::string style_path_;
+    std::vector<pid_t> worker_pids_;
+};
+
+TEST_F(ShardingTest, SegmentRoundTripIsLossless)
+{
+    std::stringstream buffer;
+    SegmentWriter writer(buffer);
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(writer.write(testFrame(i)));
+    }
+    EXPECT_EQ(writer.getFrameCount(), 3);
+
+    SegmentReader reader(buffer);
+    ASSERT_TRUE(reader.isValid());
+    cv::Mat frame;
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(reader.read(frame));
+        EXPECT_EQ(cv::norm(frame, testFrame(i), cv::NORM_INF), 0.0);
+    }
+    EXPECT_FALSE(reader.read(frame));
+}
+
+TEST_F(ShardingTest, SegmentReaderRejectsForeignData)
+{
+    std::stringstream buffer("not a segment at all");
+    SegmentReader reader(buffer);
+    EXPECT_FALSE(reader.isValid());
+    cv::Mat frame;
+    EXPECT_FALSE(reader.read(frame));
+}
+
+TEST_F(ShardingTest, ParseWorkers)
+{
+    std::vector<WorkerEndpoint> workers;
+    ASSERT_TRUE(ShardCoordinator::parseWorkers("node1:7800,127.0.0.1:7801", workers));
+    ASSERT_EQ(workers.size(), 2u);
+    EXPECT_EQ(workers[0].host, "node1");
+    EXPECT_EQ(workers[0].port, 7800);
+    EXPECT_EQ(workers[1].toString(), "127.0.0.1:7801");
+
+    EXPECT_FALSE(ShardCoordinator::parseWorkers("", workers));
+    EXPECT_FALSE(ShardCoordinator::parseWorkers("node1", workers));
+    EXPECT_FALSE(ShardCoordinator::parseWorkers("node1:0", workers));
+    EXPECT_FALSE(ShardCoordinator::parseWorkers("node1:80x", workers));
+    EXPECT_FALSE(ShardCoordinator::parseWorkers(":7800", workers));
+}
+
+TEST_F(ShardingTest, RenderSettingsRoundTrip)
+{
+    RenderSettings settings;
+    settings.mode = "optimize";
+    settings.iterations = 42;
+    settings.style_weight = 5e5;
+
+    RenderSettings parsed;
+    ASSERT_TRUE(RenderSettings::fromJson(settings.toJson(), parsed));
+    EXPECT_EQ(parsed.mode, "optimize");
+    EXPECT_EQ(parsed.iterations, 42);
+    EXPECT_DOUBLE_EQ(parsed.style_weight, 5e5);
+    EXPECT_DOUBLE_EQ(parsed.content_weight, 1.0);
+    EXPECT_FALSE(RenderSettings::fromJson("{}", parsed));
+}
+
+TEST_F(ShardingTest, WorkerRejectsMalformedRequest)
+{
+    ShardWorker worker;
+    ShardMessage request;
+    request.type = ShardMessageType::RENDER;
+    request.parts = {RenderSettings().toJson()};
+
+    ShardMessage reply;
+    worker.handleRequest(request, reply);
+    EXPECT_EQ(reply.type, ShardMessageType::FAILURE);
+    EXPECT_EQ(worker.getChunksRendered(), 0u);
+}
+
+TEST_F(ShardingTest, WorkerDropsOversizedRequest)
+{
+    ShardWorker worker;
+    worker.setMaxMessageBytes(1024);
+    ASSERT_TRUE(worker.listen("127.0.0.1", 0));
+    std::thread server([&worker]
+                       { worker.serve(1); });
+
+    // The header alone announces too much: the worker closes instead of allocating
+    video_styler::video_processor::ShardConnection connection(std::chrono::seconds(10));
+    ASSERT_TRUE(connection.connect("127.0.0.1", worker.getPort()));
+    ShardMessage request;
+    request.type = ShardMessageType::RENDER;
+    request.parts = {RenderSettings().toJson(), std::string(4096, 'x'), std::string()};
+    connection.send(request);
+
+    ShardMessage reply;
+    EXPECT_FALSE(connection.receive(reply));
+    server.join();
+    EXPECT_EQ(worker.getChunksRendered(), 0u);
+}
+
+TEST_F(ShardingTest, WorkerMovesOnFromSilentCoordinator)
+{
+    ShardWorker worker;
+    worker.setIdleTimeout(std::chrono::milliseconds(200));
+    ASSERT_TRUE(worker.listen("127.0.0.1", 0));
+    std::thread server([&worker]
+                       { worker.serve(2); });
+
+    // The first coordinator connects and never sends: it stands for a preempted node
+    video_styler::video_processor::ShardConnection silent;
+    ASSERT_TRUE(silent.connect("127.0.0.1", worker.getPort()));
+
+    video_styler::video_processor::ShardConnection next(std::chrono::seconds(10));
+    ASSERT_TRUE(next.connect("127.0.0.1", worker.getPort()));
+    ShardMessage request;
+    request.type = ShardMessageType::RENDER;
+    request.parts = {RenderSettings().toJson()};
+    ASSERT_TRUE(next.send(request));
+
+    ShardMessage reply;
+    ASSERT_TRUE(next.receive(reply));
+    EXPECT_EQ(reply.type, ShardMessageType::FAILURE);
+    server.join();
+}
+
+TEST_F(ShardingTest, LocalhostWorkersMatchSingleNodeRun)
+{
+    const std::string input_path = test_dir_ + "/input.mp4";
+    if (!createTestVideo(input_path, 60))
+    {
+        GTEST_SKIP() << "Video codec not available";
+    }
+
+    // Reference: the single-node FAST path, encoded the same way as the sharded output
+    const std::string reference_path = test_dir_ + "/reference.mp4";
+    {
+        video_styler::style_transfer::NeuralStyleTransfer style_transfer;
+        ASSERT_TRUE(style_transfer.loadStyleImage(style_path_));
+        cv::VideoCapture capture(input_path);
+        cv::VideoWriter writer(reference_path, cv::VideoWriter::fourcc('M', 'P', '4', 'V'), 30.0, cv::Size(160, 120));
+        cv::Mat frame;
+        cv::Mat stylized;
+        while (capture.read(frame))
+        {
+            ASSERT_TRUE(style_transfer.applyStyleTransfer(frame, stylized));
+            writer.write(stylized);
+        }
+    }
+
+    std::vector<WorkerEndpoint> workers;
+    for (int i = 0; i < 2; ++i)
+    {
+        const unsigned short port = spawnWorker();
+        ASSERT_NE(port, 0) << "worker process did not start";
+        workers.push_back({"127.0.0.1", port});
+    }
+
+    // A third "worker" that drops every connection forces chunks to be retried elsewhere
+    boost::asio::io_context broken_io;
+    boost::asio::ip::tcp::acceptor broken(broken_io, {boost::asio::ip::make_address("127.0.0.1"), 0});
+    std::function<void()> drop_connections = [&]
+    {
+        broken.async_accept([&](const boost::system::error_code &ec, boost::asio::ip::tcp::socket socket)
+                            {
+                                if (!ec)
+                                {
+                                    socket.close();
+                                    drop_connections();
+                                } });
+    };
+    drop_connections();
+    std::thread broken_thread([&broken_io]
+                              { broken_io.run(); });
+    workers.insert(workers.begin(), {"127.0.0.1", broken.local_endpoint().port()});
+
+    ShardSettings settings;
+    settings.initial_chunk_frames = 8;
+    settings.min_chunk_frames = 4;
+    settings.target_chunk_seconds = 0.05;
+    settings.timeout = std::chrono::seconds(30);
+
+    const std::string output_path = test_dir_ + "/sharded.mp4";
+    ShardCoordinator coordinator(workers, settings);
+    const auto report = coordinator.run(input_path, style_path_, output_path, RenderSettings());
+
+    broken_io.stop();
+    broken_thread.join();
+
+    ASSERT_TRUE(report.success) << report.error;
+    EXPECT_GE(report.retries, 1);
+    EXPECT_GT(report.chunks, 2);
+    EXPECT_EQ(report.workers[1].frames + report.workers[2].frames, 60);
+    EXPECT_FALSE(fs::exists(output_path + ".shards"));
+
+    const auto expected = readAllFrames(reference_path);
+    const auto actual = readAllFrames(output_path);
+    ASSERT_EQ(expected.size(), 60u);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(cv::norm(actual[i], expected[i], cv::NORM_INF), 0.0) << "frame " << i;
+    }
+}
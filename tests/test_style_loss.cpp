@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "style_transfer/style_loss.hpp"
+#include <opencv2/opencv.hpp>
+#include <Eigen/Core>
+
+namespace
+{
+    cv::Mat makeImage(int seed)
+    {
+        cv::Mat image(12, 10, CV_32FC3);
+        for (int y = 0; y < image.rows; ++y)
+        {
+            for (int x = 0; x < image.cols; ++x)
+            {
+                const float base = static_cast<float>((x * 7 + y * 13 + seed * 31) % 97) / 97.0f;
+                image.at<cv::Vec3f>(y, x) = cv::Vec3f(base, 1.0f - base, 0.5f * base + 0.25f);
+            }
+        }
+        return image;
+    }
+} // namespace
+
+TEST(StyleLossTest, GramIsSymmetric)
+{
+    const cv::Mat gram = video_styler::style_transfer::StyleLoss::computeGram(makeImage(1));
+    ASSERT_EQ(gram.rows, video_styler::style_transfer::StyleLoss::kFeatureCount);
+    ASSERT_EQ(gram.cols, video_styler::style_transfer::StyleLoss::kFeatureCount);
+
+    for (int row = 0; row < gram.rows; ++row)
+    {
+        for (int col = 0; col < gram.cols; ++col)
+        {
+            EXPECT_NEAR(gram.at<float>(row, col), gram.at<float>(col, row), 1e-5f);
+        }
+    }
+}
+
+TEST(StyleLossTest, ZeroAtContentWithMatchingStyle)
+{
+    const cv::Mat content = makeImage(2);
+    const video_styler::style_transfer::StyleLoss loss(
+        content, video_styler::style_transfer::StyleLoss::computeGram(content), 1.0, 1e3);
+
+    const Eigen::VectorXf x = Eigen::Map<const Eigen::VectorXf>(content.ptr<float>(), content.total() * 3);
+    Eigen::VectorXf gradient;
+    EXPECT_NEAR(loss.evaluate(x, gradient), 0.0, 1e-6);
+    EXPECT_NEAR(gradient.norm(), 0.0f, 1e-4f);
+}
+
+TEST(StyleLossTest, GradientMatchesFiniteDifferences)
+{
+    const cv::Mat content = makeImage(3);
+    const video_styler::style_transfer::StyleLoss loss(
+        content, video_styler::style_transfer::StyleLoss::computeGram(makeImage(4)), 1.0, 10.0);
+
+    Eigen::VectorXf x = Eigen::Map<const Eigen::VectorXf>(makeImage(5).ptr<float>(), content.total() * 3);
+    Eigen::VectorXf gradient;
+    loss.evaluate(x, gradient);
+
+    // Spot-check interior, edge and corner pixels on every channel
+    const float epsilon = 1e-2f;
+    Eigen::VectorXf scratch;
+    for (const int index : {0, 1, 2, 44, 157, 181, 359})
+    {
+        Eigen::VectorXf plus = x;
+        Eigen::VectorXf minus = x;
+        plus[index] += epsilon;
+        minus[index] -= epsilon;
+        const double numeric = (loss.evaluate(plus, scratch) - loss.evaluate(minus, scratch)) / (2.0 * epsilon);
+        EXPECT_NEAR(gradient[index], numeric, 1e-2 * std::max(1.0, std::abs(numeric))) << "index " << index;
+    }
+}
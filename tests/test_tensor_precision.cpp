@@ -0,0 +1,338 @@
+#include <gtest/gtest.h>
+#include "style_transfer/image_ops.hpp"
+#include "style_transfer/neural_style_transfer.hpp"
+#include "style_transfer/pixel_kernels.hpp"
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using video_styler::style_transfer::TensorPrecision;
+using video_styler::utils::CpuIsa;
+
+namespace
+{
+    /**
+     * @brief Forwards to OpenCV's allocator and records the largest float buffer allocated
+     */
+    class FloatPeakAllocator : public cv::MatAllocator
+    {
+    public:
+        cv::UMatData *allocate(int dims, const int *sizes, int type, void *data, size_t *step,
+                               cv::AccessFlag flags, cv::UMatUsageFlags usage) const override
+        {
+            if (data == nullptr && CV_MAT_DEPTH(type) == CV_32F)
+            {
+                std::size_t bytes = CV_ELEM_SIZE(type);
+                for (int i = 0; i < dims; ++i)
+                {
+                    bytes *= static_cast<std::size_t>(sizes[i]);
+                }
+                std::size_t largest = largest_float_bytes.load();
+                while (bytes > largest && !largest_float_bytes.compare_exchange_weak(largest, bytes))
+                {
+                }
+            }
+            return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usage);
+        }
+
+        bool allocate(cv::UMatData *data, cv::AccessFlag flags, cv::UMatUsageFlags usage) const override
+        {
+            return cv::Mat::getStdAllocator()->allocate(data, flags, usage);
+        }
+
+        void deallocate(cv::UMatData *data) const override
+        {
+            cv::Mat::getStdAllocator()->deallocate(data);
+        }
+
+        mutable std::atomic<std::size_t> largest_float_bytes{0};
+    };
+} // namespace
+
+class TensorPrecisionTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        cv::RNG rng(11);
+        values_.create(41, 67, CV_32FC3);
+        rng.fill(values_, cv::RNG::UNIFORM, -2.0, 2.0);
+        residual_.create(41, 67, CV_32FC3);
+        rng.fill(residual_, cv::RNG::UNIFORM, -0.3, 0.3);
+        frame_.create(41, 67, CV_8UC3);
+        rng.fill(frame_, cv::RNG::UNIFORM, 0, 256);
+
+        style_image_.create(64, 64, CV_8UC3);
+        style_image_.setTo(cv::Scalar(50, 100, 150));
+        cv::rectangle(style_image_, cv::Rect(12, 12, 40, 40), cv::Scalar(200, 50, 100), -1);
+        cv::circle(style_image_, cv::Point(32, 32), 12, cv::Scalar(100, 200, 50), -1);
+    }
+
+    void TearDown() override
+    {
+        video_styler::style_transfer::selectKernels(CpuIsa::AVX512);
+    }
+
+    /**
+     * @brief Largest relative error of a round trip through a precision (values below min_magnitude ignored)
+     */
+    static double roundTripError(const cv::Mat &values, TensorPrecision precision, float min_magnitude)
+    {
+        cv::Mat packed;
+        cv::Mat unpacked;
+        video_styler::style_transfer::packTensor(values, packed, precision);
+        video_styler::style_transfer::unpackTensor(packed, unpacked, precision);
+
+        double worst = 0.0;
+        const float *original = values.ptr<float>();
+        const float *restored = unpacked.ptr<float>();
+        for (std::size_t i = 0; i < values.total() * values.channels(); ++i)
+        {
+            if (std::fabs(original[i]) >= min_magnitude)
+            {
+                worst = std::max(worst, std::fabs(static_cast<double>(restored[i]) - original[i]) / std::fabs(original[i]));
+            }
+        }
+        return worst;
+    }
+
+    /**
+     * @brief Stylize a short moving sequence in optimize mode
+     */
+    std::vector<cv::Mat> stylizeSequence(TensorPrecision precision, int working_side) const
+    {
+        video_styler::style_transfer::NeuralStyleTransfer nst;
+        EXPECT_TRUE(nst.setStyleImage(style_image_));
+        nst.setMode(video_styler::style_transfer::TransferMode::OPTIMIZATION);
+        nst.setWorkingResolution(working_side);
+        nst.setParameters(20, 1e3, 1.0);
+        nst.setTensorPrecision(precision);
+
+        std::vector<cv::Mat> outputs;
+        for (int i = 0; i < 3; ++i)
+        {
+            cv::Mat frame(120, 160, CV_8UC3, cv::Scalar(90, 140, 60));
+            cv::rectangle(frame, cv::Rect(30 + 4 * i, 30, 60, 50), cv::Scalar(220, 30, 30), -1);
+            cv::circle(frame, cv::Point(110, 70 - 3 * i), 20, cv::Scalar(30, 30, 230), -1);
+
+            cv::Mat output;
+            EXPECT_TRUE(nst.applyStyleTransfer(frame, output));
+            outputs.push_back(output);
+        }
+        return outputs;
+    }
+
+    cv::Mat values_;
+    cv::Mat residual_;
+    cv::Mat frame_;
+    cv::Mat style_image_;
+};
+
+TEST_F(TensorPrecisionTest, NamesRoundTrip)
+{
+    for (const TensorPrecision precision : {TensorPrecision::FP32, TensorPrecision::FP16, TensorPrecision::BF16})
+    {
+        TensorPrecision parsed = TensorPrecision::FP32;
+        ASSERT_TRUE(video_styler::style_transfer::parseTensorPrecision(
+            video_styler::style_transfer::tensorPrecisionToString(precision), parsed));
+        EXPECT_EQ(parsed, precision);
+    }
+    TensorPrecision parsed = TensorPrecision::FP32;
+    EXPECT_FALSE(video_styler::style_transfer::parseTensorPrecision("fp8", parsed));
+}
+
+TEST_F(TensorPrecisionTest, PackedTensorsUseHalfTheMemory)
+{
+    cv::Mat packed;
+    video_styler::style_transfer::packTensor(values_, packed, TensorPrecision::FP16);
+    EXPECT_EQ(packed.depth(), CV_16F);
+    EXPECT_EQ(packed.channels(), 3);
+    EXPECT_EQ(packed.total() * packed.elemSize() * 2, values_.total() * values_.elemSize());
+
+    video_styler::style_transfer::packTensor(values_, packed, TensorPrecision::BF16);
+    EXPECT_EQ(packed.depth(), CV_16U);
+
+    // FP32 storage is the float tensor itself
+    video_styler::style_transfer::packTensor(values_, packed, TensorPrecision::FP32);
+    EXPECT_EQ(packed.data, values_.data);
+}
+
+TEST_F(TensorPrecisionTest, RoundTripErrorIsBoundedByMantissaWidth)
+{
+    // Round to nearest: half a unit in the last place of an 11- and 8-bit significand
+    EXPECT_LE(roundTripError(values_, TensorPrecision::FP16, 6.2e-5f), std::ldexp(1.0, -11));
+    EXPECT_LE(roundTripError(values_, TensorPrecision::BF16, 0.0f), std::ldexp(1.0, -8));
+    EXPECT_EQ(roundTripError(values_, TensorPrecision::FP32, 0.0f), 0.0);
+}
+
+TEST_F(TensorPrecisionTest, SpecialValues)
+{
+    const float values[] = {0.0f, -0.0f, 65504.0f, 70000.0f, -1e9f, 1e-6f,
+                            std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN()};
+    const cv::Mat input(1, 8, CV_32F, const_cast<float *>(values));
+
+    cv::Mat packed;
+    cv::Mat half;
+    video_styler::style_transfer::packTensor(input, packed, TensorPrecision::FP16);
+    video_styler::style_transfer::unpackTensor(packed, half, TensorPrecision::FP16);
+    EXPECT_EQ(half.at<float>(0), 0.0f);
+    EXPECT_TRUE(std::signbit(half.at<float>(1)));
+    EXPECT_EQ(half.at<float>(2), 65504.0f);
+    EXPECT_TRUE(std::isinf(half.at<float>(3))); // Beyond the FP16 range
+    EXPECT_TRUE(std::isinf(half.at<float>(4)) && half.at<float>(4) < 0.0f);
+    EXPECT_NEAR(half.at<float>(5), 1e-6f, 3e-8f); // Subnormal in FP16
+    EXPECT_TRUE(std::isinf(half.at<float>(6)));
+    EXPECT_TRUE(std::isnan(half.at<float>(7)));
+
+    cv::Mat bf16;
+    video_styler::style_transfer::packTensor(input, packed, TensorPrecision::BF16);
+    video_styler::style_transfer::unpackTensor(packed, bf16, TensorPrecision::BF16);
+    EXPECT_NEAR(bf16.at<float>(3), 70000.0f, 70000.0f / 256); // BF16 keeps the float range
+    EXPECT_NEAR(bf16.at<float>(4), -1e9f, 1e9f / 256);
+    EXPECT_TRUE(std::isinf(bf16.at<float>(6)));
+    EXPECT_TRUE(std::isnan(bf16.at<float>(7)));
+}
+
+TEST_F(TensorPrecisionTest, VariantsAgreeBitForBit)
+{
+    const std::size_t count = values_.total() * 3;
+    const auto *generic = video_styler::style_transfer::kernelsForIsa(CpuIsa::GENERIC);
+    ASSERT_NE(generic, nullptr);
+
+    std::vector<std::uint16_t> reference_half(count);
+    std::vector<std::uint16_t> reference_bf16(count);
+    generic->floats_to_half(values_.ptr<float>(), reference_half.data(), count);
+    generic->floats_to_bfloat16(values_.ptr<float>(), reference_bf16.data(), count);
+
+    for (const CpuIsa isa : {CpuIsa::SSE42, CpuIsa::AVX2, CpuIsa::AVX512})
+    {
+        const auto *kernels = video_styler::style_transfer::kernelsForIsa(isa);
+        if (kernels == nullptr)
+        {
+            continue;
+        }
+        std::vector<std::uint16_t> half(count);
+        std::vector<std::uint16_t> bf16(count);
+        kernels->floats_to_half(values_.ptr<float>(), half.data(), count);
+        kernels->floats_to_bfloat16(values_.ptr<float>(), bf16.data(), count);
+        EXPECT_EQ(half, reference_half) << video_styler::utils::cpuIsaToString(isa);
+        EXPECT_EQ(bf16, reference_bf16) << video_styler::utils::cpuIsaToString(isa);
+
+        std::vector<float> widened(count);
+        std::vector<float> reference_widened(count);
+        kernels->half_to_floats(half.data(), widened.data(), count);
+        generic->half_to_floats(half.data(), reference_widened.data(), count);
+        EXPECT_EQ(widened, reference_widened) << video_styler::utils::cpuIsaToString(isa);
+    }
+}
+
+TEST_F(TensorPrecisionTest, PackedResizeMatchesFloatResize)
+{
+    const cv::Size size(150, 90);
+    cv::Mat resized;
+    video_styler::style_transfer::resizeBilinear(residual_, resized, size);
+
+    for (const TensorPrecision precision : {TensorPrecision::FP16, TensorPrecision::BF16})
+    {
+        cv::Mat expected;
+        video_styler::style_transfer::packTensor(resized, expected, precision);
+
+        cv::Mat packed;
+        video_styler::style_transfer::resizeBilinear(residual_, packed, size, precision);
+        ASSERT_EQ(packed.type(), expected.type());
+        EXPECT_EQ(cv::norm(packed, expected, cv::NORM_INF), 0.0);
+    }
+}
+
+TEST_F(TensorPrecisionTest, ApplyResidualMatchesFloatPath)
+{
+    // FP32 reference: the unfused convert, add, convert back sequence
+    cv::Mat frame_floats;
+    cv::Mat sum;
+    cv::Mat expected;
+    video_styler::style_transfer::convertToFloat(frame_, frame_floats, 1.0f / 255.0f);
+    video_styler::style_transfer::blendImages(frame_floats, 1.0f, residual_, 1.0f, sum);
+    video_styler::style_transfer::convertToByte(sum, expected, 255.0f);
+
+    cv::Mat output;
+    video_styler::style_transfer::applyResidual(frame_, residual_, TensorPrecision::FP32, output);
+    EXPECT_EQ(cv::norm(output, expected, cv::NORM_INF), 0.0);
+
+    // A residual below 0.3 loses at most 0.3 * 255 * 2^-9 levels in BF16: one rounding step at most
+    for (const TensorPrecision precision : {TensorPrecision::FP16, TensorPrecision::BF16})
+    {
+        cv::Mat packed;
+        video_styler::style_transfer::packTensor(residual_, packed, precision);
+        video_styler::style_transfer::applyResidual(frame_, packed, precision, output);
+        EXPECT_LE(cv::norm(output, expected, cv::NORM_INF), 1.0)
+            << video_styler::style_transfer::tensorPrecisionToString(precision);
+    }
+}
+
+TEST_F(TensorPrecisionTest, OptimizationMatchesFloat32Path)
+{
+    for (const int working_side : {64, 256})
+    {
+        const auto reference = stylizeSequence(TensorPrecision::FP32, working_side);
+        for (const TensorPrecision precision : {TensorPrecision::FP16, TensorPrecision::BF16})
+        {
+            const auto outputs = stylizeSequence(precision, working_side);
+            ASSERT_EQ(outputs.size(), reference.size());
+            const std::string label = video_styler::style_transfer::tensorPrecisionToString(precision) + " at " +
+                                      std::to_string(working_side);
+
+            // The first frame differs in the stored residual and, below the frame
+            // size, in the working content being shrunk from the 8-bit frame
+            EXPECT_LE(cv::norm(outputs[0], reference[0], cv::NORM_INF), working_side < 160 ? 2.0 : 1.0) << label;
+
+            // Later frames also warm-start from packed state
+            for (std::size_t i = 1; i < outputs.size(); ++i)
+            {
+                cv::Mat difference;
+                cv::absdiff(outputs[i], reference[i], difference);
+                EXPECT_LE(cv::norm(difference, cv::NORM_INF), 4.0) << label << ", frame " << i;
+                EXPECT_LT(cv::mean(difference)[0], 0.5) << label << ", frame " << i;
+            }
+        }
+    }
+}
+
+TEST_F(TensorPrecisionTest, HalfPrecisionNeverWidensTheFullFrame)
+{
+    cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(90, 140, 60));
+    cv::rectangle(frame, cv::Rect(200, 150, 500, 300), cv::Scalar(220, 30, 30), -1);
+    const std::size_t full_frame_float_bytes = frame.total() * 3 * sizeof(float);
+
+    for (const TensorPrecision precision : {TensorPrecision::FP32, TensorPrecision::FP16, TensorPrecision::BF16})
+    {
+        video_styler::style_transfer::NeuralStyleTransfer nst;
+        ASSERT_TRUE(nst.setStyleImage(style_image_));
+        nst.setMode(video_styler::style_transfer::TransferMode::OPTIMIZATION);
+        nst.setWorkingResolution(64);
+        nst.setParameters(5, 1e3, 1.0);
+        nst.setTensorPrecision(precision);
+
+        FloatPeakAllocator allocator;
+        cv::MatAllocator *previous = cv::Mat::getDefaultAllocator();
+        cv::Mat::setDefaultAllocator(&allocator);
+        cv::Mat output;
+        const bool stylized = nst.applyStyleTransfer(frame, output);
+        cv::Mat::setDefaultAllocator(previous);
+
+        const std::string label = video_styler::style_transfer::tensorPrecisionToString(precision);
+        ASSERT_TRUE(stylized) << label;
+        EXPECT_EQ(output.size(), frame.size()) << label;
+        if (precision == TensorPrecision::FP32)
+        {
+            // The float path widens the whole frame, which shows the allocator sees it
+            EXPECT_GE(allocator.largest_float_bytes.load(), full_frame_float_bytes);
+        }
+        else
+        {
+            // Only working-resolution tensors are float; the full-resolution residual is packed
+            EXPECT_LT(allocator.largest_float_bytes.load(), full_frame_float_bytes / 4) << label;
+        }
+    }
+}
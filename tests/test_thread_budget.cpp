@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "utils/thread_budget.hpp"
+#include <opencv2/opencv.hpp>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+TEST(ThreadBudgetTest, ParsesKernelCpuList)
+{
+    const auto cpus = video_styler::utils::ThreadBudget::parseCpuList("0-3,8,10-11\n");
+    const std::vector<int> expected = {0, 1, 2, 3, 8, 10, 11};
+    EXPECT_EQ(cpus, expected);
+}
+
+TEST(ThreadBudgetTest, AvailableCpusIsNotEmpty)
+{
+    EXPECT_FALSE(video_styler::utils::ThreadBudget::availableCpus().empty());
+}
+
+TEST(ThreadBudgetTest, ParallelPipelineUsesSingleThreadedOps)
+{
+    video_styler::utils::ThreadBudget budget(8);
+    EXPECT_EQ(budget.getPipelineWorkers(), 8);
+    EXPECT_EQ(budget.getIntraOpThreads(), 1);
+    EXPECT_EQ(budget.getTotalThreads(), 8);
+}
+
+TEST(ThreadBudgetTest, SingleWorkerGetsWholeBudgetForOps)
+{
+    video_styler::utils::ThreadBudget budget(8, 0, 1);
+    EXPECT_EQ(budget.getPipelineWorkers(), 1);
+    EXPECT_EQ(budget.getIntraOpThreads(), 8);
+}
+
+TEST(ThreadBudgetTest, NeverOversubscribes)
+{
+    for (int total = 1; total <= 16; ++total)
+    {
+        for (int intra = 0; intra <= 5; ++intra)
+        {
+            for (int workers = 0; workers <= 5; ++workers)
+            {
+                video_styler::utils::ThreadBudget budget(total, intra, workers);
+                EXPECT_GE(budget.getPipelineWorkers(), 1);
+                EXPECT_GE(budget.getIntraOpThreads(), 1);
+                EXPECT_LE(budget.getTotalThreads(), std::max(total, 1))
+                    << "total=" << total << " intra=" << intra << " workers=" << workers;
+            }
+        }
+    }
+}
+
+TEST(ThreadBudgetTest, ApplyConfiguresOpenCV)
+{
+    const int previous = cv::getNumThreads();
+
+    video_styler::utils::ThreadBudget budget(4, 2);
+    budget.apply();
+    EXPECT_EQ(cv::getNumThreads(), 2);
+
+    cv::setNumThreads(previous);
+}
+
+TEST(ThreadBudgetTest, PinningIsOptIn)
+{
+    video_styler::utils::ThreadBudget budget(2);
+    EXPECT_FALSE(budget.pinCurrentThread(0));
+}
+
+TEST(ThreadBudgetTest, NumaNodeRestrictsAffinityWithoutPinning)
+{
+#ifdef __linux__
+    cpu_set_t previous;
+    CPU_ZERO(&previous);
+    ASSERT_EQ(sched_getaffinity(0, sizeof(previous), &previous), 0);
+
+    video_styler::utils::ThreadBudget budget;
+    if (!budget.restrictToNumaNode(0))
+    {
+        GTEST_SKIP() << "No usable NUMA node 0";
+    }
+    const int previous_threads = cv::getNumThreads();
+    EXPECT_TRUE(budget.apply());
+    EXPECT_EQ(video_styler::utils::ThreadBudget::availableCpus(), budget.getCpus());
+
+    sched_setaffinity(0, sizeof(previous), &previous);
+    cv::setNumThreads(previous_threads);
+#else
+    GTEST_SKIP() << "CPU affinity is Linux-only";
+#endif
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "utils/thread_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+TEST(ThreadPoolTest, DefaultSizeIsPositive)
+{
+    video_styler::utils::ThreadPool pool;
+    EXPECT_GT(pool.size(), 0u);
+}
+
+TEST(ThreadPoolTest, RunsAllSubmittedTasks)
+{
+    video_styler::utils::ThreadPool pool(4);
+    std::atomic<int> counter{0};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        pool.submit([&counter]
+                    { counter.fetch_add(1); });
+    }
+    pool.waitIdle();
+
+    EXPECT_EQ(counter.load(), 1000);
+}
+
+TEST(ThreadPoolTest, WaitIdleCoversNestedTasks)
+{
+    video_styler::utils::ThreadPool pool(2);
+    std::atomic<int> counter{0};
+
+    for (int i = 0; i < 10; ++i)
+    {
+        pool.submit([&pool, &counter]
+                    {
+                        for (int j = 0; j < 10; ++j)
+                        {
+                            pool.submit([&counter]
+                                        { counter.fetch_add(1); });
+                        } });
+    }
+    pool.waitIdle();
+
+    EXPECT_EQ(counter.load(), 100);
+}
+
+TEST(ThreadPoolTest, IdleWorkersStealFromBusyWorker)
+{
+    video_styler::utils::ThreadPool pool(4);
+    std::atomic<int> counter{0};
+
+    // One task fans out locally; the other workers can only help by stealing
+    pool.submit([&pool, &counter]
+                {
+                    for (int i = 0; i < 64; ++i)
+                    {
+                        pool.submit([&counter]
+                                    {
+                                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                        counter.fetch_add(1);
+                                    });
+                    } });
+    pool.waitIdle();
+
+    EXPECT_EQ(counter.load(), 64);
+    EXPECT_GT(pool.stealCount(), 0u);
+}
+
+TEST(ThreadPoolTest, ThrowingTaskDoesNotStopPool)
+{
+    video_styler::utils::ThreadPool pool(1);
+    std::atomic<bool> ran{false};
+
+    pool.submit([]
+                { throw std::runtime_error("task failure"); });
+    pool.submit([&ran]
+                { ran = true; });
+    pool.waitIdle();
+
+    EXPECT_TRUE(ran.load());
+}